@@ -10,14 +10,23 @@ using namespace RenderCore;
 
 import RenderCore.Renderer;
 import RenderCore.Runtime.Device;
+import RenderCore.Runtime.DrawPacket;
+import RenderCore.Runtime.IndirectDraw;
 import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Query;
+import RenderCore.Runtime.RenderGraph;
 import RenderCore.Runtime.Scene;
 import RenderCore.Runtime.Synchronization;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.SwapChain;
 import RenderCore.Runtime.Offscreen;
+import RenderCore.Runtime.Snapshot;
+import RenderCore.Runtime.Upload;
 import RenderCore.Types.Camera;
+import RenderCore.Types.CommandState;
+import RenderCore.Utils.FrameStats;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
 import RenderCore.Utils.Constants;
 
 constexpr VkCommandBufferBeginInfo g_CommandBufferBeginInfo {
@@ -25,9 +34,9 @@ constexpr VkCommandBufferBeginInfo g_CommandBufferBeginInfo {
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
 };
 
-void ThreadResources::Allocate(VkDevice const &LogicalDevice, std::uint8_t const QueueFamilyIndex)
+void ThreadResources::Allocate(VkDevice const &LogicalDevice, std::uint8_t const QueueFamilyIndex, VkCommandPoolCreateFlags const Flags)
 {
-    CommandPool = CreateCommandPool(QueueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    CommandPool = CreateCommandPool(QueueFamilyIndex, Flags);
 
     VkCommandBufferAllocateInfo const CommandBufferAllocateInfo {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
@@ -73,26 +82,94 @@ void ThreadResources::Reset(VkDevice const &LogicalDevice)
     CheckVulkanResult(vkResetCommandPool(LogicalDevice, CommandPool, 0U));
 }
 
+// Render target state a cached scene secondary bakes besides its draws: a mismatch forces the chunk to be re-recorded.
+// Pipelines, geometry and descriptor buffers are not compared since handles can be reused: reallocating them invalidates the cache.
+struct CachedChunkState
+{
+    std::array<VkDeviceSize, 3U> DescriptorLayoutSizes {};
+    VkFormat                     ColorFormat { VK_FORMAT_UNDEFINED };
+    VkFormat                     DepthFormat { VK_FORMAT_UNDEFINED };
+    std::uint32_t                Width { 0U };
+    std::uint32_t                Height { 0U };
+    bool                         HasStatistics { false };
+
+    bool operator==(CachedChunkState const &) const = default;
+};
+
+struct CachedDrawKey
+{
+    std::uint32_t BufferIndex { 0U };
+    VkDeviceSize  VertexOffset { 0U };
+    VkDeviceSize  IndexOffset { 0U };
+    std::uint32_t NumIndices { 0U };
+    std::uint32_t NumInstances { 0U };
+
+    bool operator==(CachedDrawKey const &) const = default;
+};
+
+struct CachedSceneChunk
+{
+    ThreadResources            Resources {};
+    CachedChunkState           State {};
+    std::vector<CachedDrawKey> Draws {};
+    std::vector<CachedDrawKey> PendingDraws {};
+    std::vector<std::uint32_t> PendingObjects {};
+    bool                       IsValid { false };
+};
+
 struct CommandResources
 {
     std::unordered_map<std::uint8_t, ThreadResources> MultiThreadResources {};
+    std::vector<CachedSceneChunk>                     CachedChunks {};
+    std::vector<std::vector<VkCommandBuffer>>         BatchCommandBuffers {};
     VkCommandPool                                     PrimaryCommandPool { VK_NULL_HANDLE };
     VkCommandBuffer                                   PrimaryCommandBuffer { VK_NULL_HANDLE };
+    VkCommandPool                                     ComputeCommandPool { VK_NULL_HANDLE };
+    VkCommandBuffer                                   ComputeCommandBuffer { VK_NULL_HANDLE };
+    bool                                              HasPendingCompute { false };
+    std::uint64_t                                     UploadWaitValue { 0U };
 };
 
-std::uint32_t                              g_ObjectsPerThread { 0U };
-std::uint32_t                              g_NumThreads { 0U };
-std::array<CommandResources, g_ImageCount> g_CommandResources {};
+struct RecordingBatch
+{
+    std::uint32_t Begin { 0U };
+    std::uint32_t End { 0U };
+};
 
-void RenderCore::SetNumObjectsPerThread(std::uint32_t const NumObjects)
+// Each recording thread owns a range of batches; the cursor is shared so idle threads can steal from it.
+struct alignas(64) RecordingCursor
 {
-    if (NumObjects > 0U)
-    {
-        g_ObjectsPerThread = static_cast<std::uint32_t>(std::ceil(static_cast<float>(NumObjects) / static_cast<float>(g_NumThreads)));
-    }
-    else
+    std::atomic<std::uint32_t> Next { 0U };
+    std::uint32_t              End { 0U };
+};
+
+std::uint32_t                                     g_NumThreads { 0U };
+std::uint8_t                                      g_QueueFamilyIndex { 0U };
+std::array<CommandResources, g_MaxFramesInFlight> g_CommandResources {};
+std::array<RenderGraph, g_MaxFramesInFlight>      g_RenderGraphs {};
+std::vector<std::vector<DrawPacket>>              g_ExtractedDrawPackets {};
+std::vector<DrawPacket>                           g_DrawPackets {};
+std::vector<DrawPacket>                           g_DrawPacketsScratch {};
+std::vector<std::uint64_t>                        g_RecordingCosts {};
+std::vector<RecordingBatch>                       g_RecordingBatches {};
+std::vector<RecordingCursor>                      g_RecordingCursors {};
+std::vector<VkCommandBuffer>                      g_RecordedBatches {};
+
+void FreeBatchCommandBuffers(VkDevice const &LogicalDevice, CommandResources &Resources)
+{
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < std::size(Resources.BatchCommandBuffers); ++ThreadIndex)
     {
-        g_ObjectsPerThread = 0U;
+        std::vector<VkCommandBuffer> &CommandBuffers = Resources.BatchCommandBuffers.at(ThreadIndex);
+
+        if (!std::empty(CommandBuffers))
+        {
+            vkFreeCommandBuffers(LogicalDevice,
+                                 Resources.MultiThreadResources.at(static_cast<std::uint8_t>(ThreadIndex)).CommandPool,
+                                 static_cast<std::uint32_t>(std::size(CommandBuffers)),
+                                 std::data(CommandBuffers));
+        }
+
+        CommandBuffers.clear();
     }
 }
 
@@ -115,6 +192,11 @@ void RenderCore::ResetCommandPool(std::uint32_t const Index)
     }
 
     vkResetCommandPool(LogicalDevice, g_CommandResources.at(Index).PrimaryCommandPool, 0U);
+
+    if (g_CommandResources.at(Index).ComputeCommandPool != VK_NULL_HANDLE)
+    {
+        vkResetCommandPool(LogicalDevice, g_CommandResources.at(Index).ComputeCommandPool, 0U);
+    }
 }
 
 void RenderCore::FreeCommandBuffers()
@@ -127,6 +209,8 @@ void RenderCore::FreeCommandBuffers()
                   std::end(g_CommandResources),
                   [&](auto &CommandResourceIt)
                   {
+                      FreeBatchCommandBuffers(LogicalDevice, CommandResourceIt);
+
                       std::for_each(std::execution::unseq,
                                     std::begin(CommandResourceIt.MultiThreadResources),
                                     std::end(CommandResourceIt.MultiThreadResources),
@@ -135,14 +219,29 @@ void RenderCore::FreeCommandBuffers()
                                         ThreadResourcesIt.second.Free(LogicalDevice);
                                     });
 
+                      for (CachedSceneChunk &ChunkIter : CommandResourceIt.CachedChunks)
+                      {
+                          ChunkIter.Resources.Destroy(LogicalDevice);
+                      }
+
+                      CommandResourceIt.CachedChunks.clear();
+
                       vkFreeCommandBuffers(LogicalDevice, CommandResourceIt.PrimaryCommandPool, 1U, &CommandResourceIt.PrimaryCommandBuffer);
+
+                      if (CommandResourceIt.ComputeCommandPool != VK_NULL_HANDLE)
+                      {
+                          vkFreeCommandBuffers(LogicalDevice, CommandResourceIt.ComputeCommandPool, 1U, &CommandResourceIt.ComputeCommandBuffer);
+                      }
                   });
 }
 
 void RenderCore::InitializeCommandsResources(std::uint32_t const QueueFamily)
 {
-    g_NumThreads = static_cast<std::uint8_t>(std::thread::hardware_concurrency());
+    g_NumThreads       = static_cast<std::uint8_t>(std::thread::hardware_concurrency());
+    g_QueueFamilyIndex = static_cast<std::uint8_t>(QueueFamily);
     g_ThreadPool.SetupCPUThreads("RenderThread");
+    g_RecordingCursors = std::vector<RecordingCursor>(g_NumThreads);
+    g_ExtractedDrawPackets.resize(g_NumThreads);
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
@@ -154,10 +253,12 @@ void RenderCore::InitializeCommandsResources(std::uint32_t const QueueFamily)
                       for (std::uint8_t ThreadIndex = 0U; ThreadIndex < g_NumThreads; ++ThreadIndex)
                       {
                           ThreadResources NewResource {};
-                          NewResource.Allocate(LogicalDevice, QueueFamily);
+                          NewResource.Allocate(LogicalDevice, QueueFamily, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
                           CommandResourceIt.MultiThreadResources.emplace(ThreadIndex, std::move(NewResource));
                       }
 
+                      CommandResourceIt.BatchCommandBuffers.resize(g_NumThreads);
+
                       CommandResourceIt.PrimaryCommandPool = CreateCommandPool(QueueFamily, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
 
                       VkCommandBufferAllocateInfo const CommandBufferAllocateInfo {
@@ -168,6 +269,22 @@ void RenderCore::InitializeCommandsResources(std::uint32_t const QueueFamily)
                       };
 
                       CheckVulkanResult(vkAllocateCommandBuffers(LogicalDevice, &CommandBufferAllocateInfo, &CommandResourceIt.PrimaryCommandBuffer));
+
+                      if (HasAsyncComputeQueue())
+                      {
+                          CommandResourceIt.ComputeCommandPool = CreateCommandPool(GetComputeQueue().first, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+                          VkCommandBufferAllocateInfo const ComputeCommandBufferAllocateInfo {
+                                  .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                  .commandPool = CommandResourceIt.ComputeCommandPool,
+                                  .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                  .commandBufferCount = 1U
+                          };
+
+                          CheckVulkanResult(vkAllocateCommandBuffers(LogicalDevice,
+                                                                     &ComputeCommandBufferAllocateInfo,
+                                                                     &CommandResourceIt.ComputeCommandBuffer));
+                      }
                   });
 }
 
@@ -182,6 +299,8 @@ void RenderCore::ReleaseCommandsResources()
                   std::end(g_CommandResources),
                   [&](auto &CommandResourceIt)
                   {
+                      FreeBatchCommandBuffers(LogicalDevice, CommandResourceIt);
+
                       std::for_each(std::execution::unseq,
                                     std::begin(CommandResourceIt.MultiThreadResources),
                                     std::end(CommandResourceIt.MultiThreadResources),
@@ -192,12 +311,55 @@ void RenderCore::ReleaseCommandsResources()
                                         ThreadResourcesIt.second.Destroy(LogicalDevice);
                                     });
 
+                      for (CachedSceneChunk &ChunkIter : CommandResourceIt.CachedChunks)
+                      {
+                          ChunkIter.Resources.Destroy(LogicalDevice);
+                      }
+
+                      CommandResourceIt.CachedChunks.clear();
+
                       CheckVulkanResult(vkResetCommandPool(LogicalDevice, CommandResourceIt.PrimaryCommandPool, 0U));
                       vkFreeCommandBuffers(LogicalDevice, CommandResourceIt.PrimaryCommandPool, 1U, &CommandResourceIt.PrimaryCommandBuffer);
                       vkDestroyCommandPool(LogicalDevice, CommandResourceIt.PrimaryCommandPool, nullptr);
                       CommandResourceIt.PrimaryCommandPool   = VK_NULL_HANDLE;
                       CommandResourceIt.PrimaryCommandBuffer = VK_NULL_HANDLE;
+
+                      if (CommandResourceIt.ComputeCommandPool != VK_NULL_HANDLE)
+                      {
+                          vkFreeCommandBuffers(LogicalDevice, CommandResourceIt.ComputeCommandPool, 1U, &CommandResourceIt.ComputeCommandBuffer);
+                          vkDestroyCommandPool(LogicalDevice, CommandResourceIt.ComputeCommandPool, nullptr);
+                          CommandResourceIt.ComputeCommandPool   = VK_NULL_HANDLE;
+                          CommandResourceIt.ComputeCommandBuffer = VK_NULL_HANDLE;
+                      }
+
+                      CommandResourceIt.HasPendingCompute = false;
                   });
+
+    ReleaseRenderGraphs();
+}
+
+void RenderCore::ReleaseRenderGraphs()
+{
+    for (RenderGraph &GraphIter : g_RenderGraphs)
+    {
+        GraphIter.Release();
+    }
+}
+
+void RenderCore::InvalidateCachedSceneCommands()
+{
+    for (CommandResources &CommandResourceIt : g_CommandResources)
+    {
+        for (CachedSceneChunk &ChunkIter : CommandResourceIt.CachedChunks)
+        {
+            ChunkIter.IsValid = false;
+        }
+    }
+}
+
+RenderGraphStats const &RenderCore::GetRenderGraphStats(std::uint32_t const FrameIndex)
+{
+    return g_RenderGraphs.at(FrameIndex).GetStats();
 }
 
 VkCommandPool RenderCore::CreateCommandPool(std::uint8_t const FamilyQueueIndex, VkCommandPoolCreateFlags const Flags)
@@ -233,36 +395,14 @@ void SetViewport(VkCommandBuffer const &CommandBuffer, VkExtent2D const &SwapCha
     vkCmdSetScissor(CommandBuffer, 0U, 1U, &Scissor);
 }
 
-void BeginRendering(VkCommandBuffer const &CommandBuffer,
-                    ImageAllocation const &SwapchainAllocation,
+void BeginRendering(VkCommandBuffer const & CommandBuffer,
+                    ImageAllocation const &ColorAllocation,
                     ImageAllocation const &DepthAllocation,
-                    ImageAllocation const &OffscreenAllocation)
+                    VkRenderingFlags const Flags)
 {
-    std::vector ImageBarriers {
-            RenderCore::MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout,
-                                          g_ImageAspect>(SwapchainAllocation.Image, SwapchainAllocation.Format),
-            RenderCore::MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout, g_DepthAspect>(DepthAllocation.Image, DepthAllocation.Format)
-    };
-
-    bool const &HasOffscreenRendering = Renderer::GetRenderOffscreen();
-
-    if (HasOffscreenRendering)
-    {
-        ImageBarriers.push_back(RenderCore::MountImageBarrier<g_UndefinedLayout, g_AttachmentLayout, g_ImageAspect>(OffscreenAllocation.Image,
-                                    OffscreenAllocation.Format));
-    }
-
-    VkDependencyInfo const DependencyInfo {
-            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .imageMemoryBarrierCount = static_cast<std::uint32_t>(std::size(ImageBarriers)),
-            .pImageMemoryBarriers = std::data(ImageBarriers)
-    };
-
-    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
-
     VkRenderingAttachmentInfo const ColorAttachment {
             .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
-            .imageView = HasOffscreenRendering ? OffscreenAllocation.View : SwapchainAllocation.View,
+            .imageView = ColorAllocation.View,
             .imageLayout = g_AttachmentLayout,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
             .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
@@ -274,14 +414,14 @@ void BeginRendering(VkCommandBuffer const &CommandBuffer,
             .imageView = DepthAllocation.View,
             .imageLayout = g_AttachmentLayout,
             .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
             .clearValue = g_ClearValues.at(1U)
     };
 
     VkRenderingInfo const RenderingInfo {
             .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
-            .flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT,
-            .renderArea = { .offset = { 0, 0 }, .extent = SwapchainAllocation.Extent },
+            .flags = Flags,
+            .renderArea = { .offset = { 0, 0 }, .extent = ColorAllocation.Extent },
             .layerCount = 1U,
             .colorAttachmentCount = 1U,
             .pColorAttachments = &ColorAttachment,
@@ -292,36 +432,304 @@ void BeginRendering(VkCommandBuffer const &CommandBuffer,
     vkCmdBeginRendering(CommandBuffer, &RenderingInfo);
 }
 
-void EndRendering(VkCommandBuffer const &CommandBuffer, ImageAllocation const &SwapchainAllocation, ImageAllocation const &OffscreenAllocation)
+void NameRecordingThread()
+{
+    [[maybe_unused]] thread_local bool const IsThreadNamed = []
+    {
+        RENDERCORE_PROFILE_THREAD("Recording Thread");
+        return true;
+    }();
+}
+
+// Culls the snapshot in parallel into per-thread packet lists, then gathers and sorts them so the recording threads walk a compact array
+// ordered by state and depth instead of chasing the object pointers in load order.
+std::vector<DrawPacket> const &CompileDrawPackets(SceneSnapshot const &Snapshot)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    auto const &Objects    = Snapshot.Objects;
+    auto const  NumObjects = static_cast<std::uint32_t>(std::size(Objects));
+    auto const  NumThreads = std::clamp((NumObjects + g_MinExtractionObjectsPerThread - 1U) / g_MinExtractionObjectsPerThread, 1U, g_NumThreads);
+
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        g_ThreadPool.AddTask([&Snapshot, NumObjects, NumThreads, ThreadIndex]
+                             {
+                                 std::vector<DrawPacket> &Output = g_ExtractedDrawPackets.at(ThreadIndex);
+                                 Output.clear();
+
+                                 BuildDrawPackets(Snapshot.Objects,
+                                                  Snapshot.Camera,
+                                                  ThreadIndex * NumObjects / NumThreads,
+                                                  (ThreadIndex + 1U) * NumObjects / NumThreads,
+                                                  Output);
+                             },
+                             ThreadIndex);
+    }
+
+    g_ThreadPool.Wait();
+
+    g_DrawPackets.clear();
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        std::vector<DrawPacket> const &Extracted = g_ExtractedDrawPackets.at(ThreadIndex);
+        g_DrawPackets.insert(std::cend(g_DrawPackets), std::cbegin(Extracted), std::cend(Extracted));
+    }
+
+    SortDrawPackets(g_DrawPackets, g_DrawPacketsScratch);
+
+    return g_DrawPackets;
+}
+
+std::uint64_t EstimateRecordingCost(DrawPacket const &Packet)
+{
+    std::uint64_t const NumTriangles = Packet.NumIndices / 3U;
+    return g_RecordingDrawCost + NumTriangles * Packet.NumInstances / g_RecordingTrianglesPerCost;
+}
+
+// Splits the sorted packets into contiguous batches of similar estimated cost and deals them out to the recording threads. Returns the
+// number of threads worth waking up, so small scenes are not spread over one secondary per hardware thread.
+std::uint32_t BuildRecordingBatches(std::vector<DrawPacket> const &Packets)
 {
-    vkCmdEndRendering(CommandBuffer);
+    auto const NumObjects = static_cast<std::uint32_t>(std::size(Packets));
+
+    g_RecordingCosts.resize(NumObjects);
+    std::transform(std::execution::unseq, std::cbegin(Packets), std::cend(Packets), std::begin(g_RecordingCosts), EstimateRecordingCost);
+
+    std::uint64_t const TotalCost = std::reduce(std::execution::unseq, std::cbegin(g_RecordingCosts), std::cend(g_RecordingCosts), std::uint64_t { 0U });
+
+    auto const NumActiveThreads = static_cast<std::uint32_t>(std::clamp<std::uint64_t>((TotalCost + g_MinRecordingCostPerThread - 1U) /
+                                                                                        g_MinRecordingCostPerThread,
+                                                                                        1U,
+                                                                                        std::min(g_NumThreads, NumObjects)));
+
+    std::uint64_t const BatchBudget = std::max<std::uint64_t>(TotalCost / (NumActiveThreads * g_RecordingBatchesPerThread), 1U);
+
+    g_RecordingBatches.clear();
+
+    std::uint32_t BatchBegin = 0U;
+    std::uint64_t BatchCost  = 0U;
+
+    for (std::uint32_t ObjectIndex = 0U; ObjectIndex < NumObjects; ++ObjectIndex)
+    {
+        BatchCost += g_RecordingCosts.at(ObjectIndex);
+
+        if (BatchCost >= BatchBudget || ObjectIndex + 1U == NumObjects)
+        {
+            g_RecordingBatches.push_back(RecordingBatch { .Begin = BatchBegin, .End = ObjectIndex + 1U });
+            BatchBegin = ObjectIndex + 1U;
+            BatchCost  = 0U;
+        }
+    }
+
+    auto const NumBatches = static_cast<std::uint32_t>(std::size(g_RecordingBatches));
+
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < NumActiveThreads; ++ThreadIndex)
+    {
+        RecordingCursor &Cursor = g_RecordingCursors.at(ThreadIndex);
+        Cursor.Next.store(ThreadIndex * NumBatches / NumActiveThreads, std::memory_order_relaxed);
+        Cursor.End = (ThreadIndex + 1U) * NumBatches / NumActiveThreads;
+    }
+
+    g_RecordedBatches.assign(NumBatches, VK_NULL_HANDLE);
+
+    return NumActiveThreads;
+}
+
+// Returns the secondary a thread records its n-th claimed batch into. Extra secondaries come from the thread's own pool, so stealing a batch
+// never touches a pool another thread is recording from; the pool reset at the start of the frame slot recycles them.
+VkCommandBuffer AcquireBatchCommandBuffer(VkDevice const &    LogicalDevice,
+                                          CommandResources &  Resources,
+                                          std::uint32_t const ThreadIndex,
+                                          std::uint32_t const RecordedIndex)
+{
+    ThreadResources const &Thread = Resources.MultiThreadResources.at(static_cast<std::uint8_t>(ThreadIndex));
+
+    if (RecordedIndex == 0U)
+    {
+        return Thread.CommandBuffer;
+    }
+
+    std::vector<VkCommandBuffer> &CommandBuffers = Resources.BatchCommandBuffers.at(ThreadIndex);
+
+    if (RecordedIndex > std::size(CommandBuffers))
+    {
+        VkCommandBufferAllocateInfo const CommandBufferAllocateInfo {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = Thread.CommandPool,
+                .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                .commandBufferCount = 1U
+        };
+
+        VkCommandBuffer NewCommandBuffer = VK_NULL_HANDLE;
+        CheckVulkanResult(vkAllocateCommandBuffers(LogicalDevice, &CommandBufferAllocateInfo, &NewCommandBuffer));
+        CommandBuffers.push_back(NewCommandBuffer);
+    }
+
+    return CommandBuffers.at(RecordedIndex - 1U);
+}
+
+std::vector<VkCommandBuffer> RecordCachedSceneCommands(std::uint32_t const                   FrameIndex,
+                                                       ImageAllocation const &               ColorAllocation,
+                                                       ImageAllocation const &               DepthAllocation,
+                                                       SceneSnapshot const &                 Snapshot,
+                                                       VkCommandBufferInheritanceInfo const &InheritanceInfo)
+{
+    auto const &Objects    = Snapshot.Objects;
+    auto const  NumObjects = static_cast<std::uint32_t>(std::size(Objects));
+    auto const  NumChunks  = std::clamp((NumObjects + g_MinCachedChunkObjects - 1U) / g_MinCachedChunkObjects, 1U, g_MaxCachedSceneChunks);
+
+    VkPipeline const &            Pipeline       = GetMainPipeline();
+    VkPipelineLayout const &      PipelineLayout = GetPipelineLayout();
+    PipelineDescriptorData const &DescriptorData = GetPipelineDescriptorData();
+
+    CachedChunkState const State {
+            .DescriptorLayoutSizes = { DescriptorData.SceneData.LayoutSize, DescriptorData.ModelData.LayoutSize, DescriptorData.TextureData.LayoutSize },
+            .ColorFormat = ColorAllocation.Format,
+            .DepthFormat = DepthAllocation.Format,
+            .Width = ColorAllocation.Extent.width,
+            .Height = ColorAllocation.Extent.height,
+            .HasStatistics = HasFrameStatistics(FrameIndex)
+    };
+
+    // Cached secondaries are replayed by later submissions of the same frame slot, so they can't be one-time-submit
+    VkCommandBufferBeginInfo const BeginInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+            .pInheritanceInfo = &InheritanceInfo
+    };
+
+    CommandResources &CommandResources = g_CommandResources.at(FrameIndex);
+    if (std::size(CommandResources.CachedChunks) < NumChunks)
+    {
+        CommandResources.CachedChunks.resize(NumChunks);
+    }
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+    Camera const &  Camera        = Snapshot.Camera;
+
+    auto ProcessChunk = [&](std::uint32_t const ChunkIndex)
+    {
+        CachedSceneChunk &  Chunk = CommandResources.CachedChunks.at(ChunkIndex);
+        std::uint32_t const Begin = ChunkIndex * NumObjects / NumChunks;
+        std::uint32_t const End   = (ChunkIndex + 1U) * NumObjects / NumChunks;
+
+        NameRecordingThread();
+
+        Chunk.PendingDraws.clear();
+        Chunk.PendingObjects.clear();
+
+        for (std::uint32_t ObjectIndex = Begin; ObjectIndex < End; ++ObjectIndex)
+        {
+            ObjectSnapshot const &ObjectState = Objects.at(ObjectIndex);
+            auto const &          Object      = ObjectState.Object;
+            auto const &          Mesh        = Object->GetMesh();
+
+            if (!Mesh || !Camera.CanDrawObject(Object))
+            {
+                continue;
+            }
+
+            Chunk.PendingObjects.push_back(ObjectIndex);
+            Chunk.PendingDraws.push_back(CachedDrawKey {
+                    .BufferIndex = Object->GetBufferIndex(),
+                    .VertexOffset = Mesh->GetVertexOffset(),
+                    .IndexOffset = Mesh->GetIndexOffset(),
+                    .NumIndices = Mesh->GetNumIndices(),
+                    .NumInstances = std::max(ObjectState.NumInstances, 1U)
+            });
+        }
+
+        SetThreadDrawCount(ChunkIndex, static_cast<std::uint32_t>(std::size(Chunk.PendingDraws)));
+
+        if (Chunk.IsValid && Chunk.State == State && Chunk.Draws == Chunk.PendingDraws)
+        {
+            // Replayed as is: nothing was recorded for this chunk this frame
+            SetThreadRecordingTime(ChunkIndex, 0.0);
+            SetThreadSkippedBinds(ChunkIndex, 0U);
+            MarkThreadQueriesWritten(FrameIndex, ChunkIndex);
+            return;
+        }
+
+        RENDERCORE_PROFILE_SCOPE("RecordCachedSceneChunk");
+
+        auto const StartTime = std::chrono::steady_clock::now();
+
+        if (Chunk.Resources.CommandPool == VK_NULL_HANDLE)
+        {
+            Chunk.Resources.Allocate(LogicalDevice, g_QueueFamilyIndex, 0U);
+        }
+        else
+        {
+            Chunk.Resources.Reset(LogicalDevice);
+        }
+
+        VkCommandBuffer const &CommandBuffer = Chunk.Resources.CommandBuffer;
+
+        CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &BeginInfo));
+        BeginThreadQueries(CommandBuffer, FrameIndex, ChunkIndex);
+        SetViewport(CommandBuffer, ColorAllocation.Extent);
+
+        CommandStateTracker StateTracker { CommandBuffer };
 
-    if (Renderer::GetRenderOffscreen())
+        if (!std::empty(Chunk.PendingObjects))
+        {
+            StateTracker.BindPipeline(Pipeline);
+        }
+
+        for (std::uint32_t const ObjectIndex : Chunk.PendingObjects)
+        {
+            ObjectSnapshot const &ObjectState = Objects.at(ObjectIndex);
+            ObjectState.Object->DrawObject(StateTracker, PipelineLayout, FrameIndex, ObjectState.NumInstances);
+        }
+
+        EndThreadQueries(CommandBuffer, FrameIndex, ChunkIndex);
+        CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
+
+        std::swap(Chunk.Draws, Chunk.PendingDraws);
+        Chunk.State   = State;
+        Chunk.IsValid = true;
+
+        SetThreadRecordingTime(ChunkIndex, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count());
+        SetThreadSkippedBinds(ChunkIndex, StateTracker.GetNumSkippedBinds());
+    };
+
+    ScopedFrameTimer const Timer { FrameStage::SecondaryRecording };
+
+    for (std::uint32_t ChunkIndex = 0U; ChunkIndex < NumChunks; ++ChunkIndex)
     {
-        RenderCore::RequestImageLayoutTransition<g_AttachmentLayout, g_ReadLayout, g_ImageAspect>(CommandBuffer,
-                                                                                                  OffscreenAllocation.Image,
-                                                                                                  OffscreenAllocation.Format);
+        g_ThreadPool.AddTask([ProcessChunk, ChunkIndex]
+                             {
+                                 ProcessChunk(ChunkIndex);
+                             },
+                             ChunkIndex % g_NumThreads);
     }
 
-    if (g_OnCommandBufferRecordCallback)
+    g_ThreadPool.Wait();
+
+    std::vector<VkCommandBuffer> Output;
+    Output.reserve(NumChunks);
+
+    for (std::uint32_t ChunkIndex = 0U; ChunkIndex < NumChunks; ++ChunkIndex)
     {
-        g_OnCommandBufferRecordCallback(CommandBuffer, SwapchainAllocation);
+        Output.push_back(CommandResources.CachedChunks.at(ChunkIndex).Resources.CommandBuffer);
     }
 
-    RenderCore::RequestImageLayoutTransition<g_AttachmentLayout, g_PresentLayout, g_ImageAspect>(CommandBuffer,
-                                                                                                 SwapchainAllocation.Image,
-                                                                                                 SwapchainAllocation.Format);
+    return Output;
 }
 
-std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageIndex,
-                                                 ImageAllocation const &SwapchainAllocation,
-                                                 ImageAllocation const &DepthAllocation)
+std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    FrameIndex,
+                                                 ImageAllocation const &ColorAllocation,
+                                                 ImageAllocation const &DepthAllocation,
+                                                 SceneSnapshot const &  Snapshot)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     VkCommandBufferInheritanceRenderingInfo const InheritanceRenderingInfo {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
             .flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT,
             .colorAttachmentCount = 1U,
-            .pColorAttachmentFormats = &SwapchainAllocation.Format,
+            .pColorAttachmentFormats = &ColorAllocation.Format,
             .depthAttachmentFormat = DepthAllocation.Format,
             .stencilAttachmentFormat = DepthAllocation.Format,
             .rasterizationSamples = g_MSAASamples,
@@ -336,7 +744,7 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
     SecondaryBeginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
     SecondaryBeginInfo.pInheritanceInfo = &InheritanceInfo;
 
-    auto const &Objects = GetObjects();
+    auto const &Objects = Snapshot.Objects;
     if (Objects.empty())
     {
         return {};
@@ -344,210 +752,351 @@ std::vector<VkCommandBuffer> RecordSceneCommands(std::uint32_t const    ImageInd
 
     VkPipeline const &      Pipeline       = GetMainPipeline();
     VkPipelineLayout const &PipelineLayout = GetPipelineLayout();
-    Camera const &          Camera         = GetCamera();
 
-    std::vector<VkCommandBuffer> Output;
-    Output.reserve(g_NumThreads);
+    if (g_CacheSceneCommands)
+    {
+        return RecordCachedSceneCommands(FrameIndex, ColorAllocation, DepthAllocation, Snapshot, InheritanceInfo);
+    }
 
-    CommandResources const &CommandResources = g_CommandResources.at(ImageIndex);
+    std::vector<DrawPacket> const &Packets = CompileDrawPackets(Snapshot);
+    if (std::empty(Packets))
+    {
+        return {};
+    }
 
-    std::vector<std::uint32_t> ThreadIndices(g_NumThreads);
-    std::iota(std::begin(ThreadIndices), std::end(ThreadIndices), 0U);
+    std::uint32_t const NumActiveThreads = BuildRecordingBatches(Packets);
 
-    auto ProcessCommandBuffer = [&](std::uint32_t const ThreadIndex)
+    CommandResources &CommandResources = g_CommandResources.at(FrameIndex);
+    VkDevice const &  LogicalDevice    = GetLogicalDevice();
+
+    auto RecordBatch = [&](VkCommandBuffer const &CommandBuffer, std::uint32_t const BatchIndex, CommandStateTracker &StateTracker)
     {
-        auto const &[CommandPool, CommandBuffer] = CommandResources.MultiThreadResources.at(ThreadIndex);
+        auto const &[Begin, End] = g_RecordingBatches.at(BatchIndex);
+
+        CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &SecondaryBeginInfo));
+        BeginThreadQueries(CommandBuffer, FrameIndex, BatchIndex);
+        SetViewport(CommandBuffer, ColorAllocation.Extent);
+
+        StateTracker.BindPipeline(Pipeline);
+        RecordDrawPackets(StateTracker, PipelineLayout, FrameIndex, std::span { std::data(Packets) + Begin, End - Begin });
 
-        if (CommandBuffer == VK_NULL_HANDLE)
+        EndThreadQueries(CommandBuffer, FrameIndex, BatchIndex);
+        CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
+
+        g_RecordedBatches.at(BatchIndex) = CommandBuffer;
+        return End - Begin;
+    };
+
+    auto ProcessCommandBuffer = [&](std::uint32_t const ThreadIndex)
+    {
+        if (CommandResources.MultiThreadResources.at(ThreadIndex).CommandBuffer == VK_NULL_HANDLE)
         {
             return;
         }
 
-        CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &SecondaryBeginInfo));
-        SetViewport(CommandBuffer, SwapchainAllocation.Extent);
+        NameRecordingThread();
+        RENDERCORE_PROFILE_SCOPE("RecordSecondaryCommands");
 
-        bool HasDraw = false;
+        auto const StartTime = std::chrono::steady_clock::now();
 
-        for (std::uint32_t ObjectIndex = 0U; ObjectIndex < g_ObjectsPerThread; ++ObjectIndex)
+        std::uint32_t NumRecorded     = 0U;
+        std::uint32_t NumDraws        = 0U;
+        std::uint32_t NumSkippedBinds = 0U;
+
+        // Drain the own batch range first, then steal from the other threads' ranges until every batch is claimed. Every batch gets its own
+        // secondary and those execute in batch order, so a stolen batch still lands at its place in the sorted packets.
+        for (std::uint32_t Offset = 0U; Offset < NumActiveThreads; ++Offset)
         {
-            std::uint32_t const ObjectAccessIndex = ThreadIndex * g_ObjectsPerThread + ObjectIndex;
+            RecordingCursor &Cursor = g_RecordingCursors.at((ThreadIndex + Offset) % NumActiveThreads);
 
-            if (ObjectAccessIndex >= Objects.size())
+            for (std::uint32_t BatchIndex = Cursor.Next.fetch_add(1U, std::memory_order_relaxed);
+                 BatchIndex < Cursor.End;
+                 BatchIndex = Cursor.Next.fetch_add(1U, std::memory_order_relaxed))
             {
-                break;
-            }
+                VkCommandBuffer const CommandBuffer = AcquireBatchCommandBuffer(LogicalDevice, CommandResources, ThreadIndex, NumRecorded++);
 
-            if (auto const &Object = Objects.at(ObjectAccessIndex);
-                Camera.CanDrawObject(Object))
-            {
-                if (!HasDraw)
-                {
-                    HasDraw = true;
-                    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline);
-                }
-
-                Object->UpdateUniformBuffers();
-                Object->DrawObject(CommandBuffer, PipelineLayout, ObjectAccessIndex);
+                CommandStateTracker StateTracker { CommandBuffer };
+                NumDraws += RecordBatch(CommandBuffer, BatchIndex, StateTracker);
+                NumSkippedBinds += StateTracker.GetNumSkippedBinds();
             }
         }
 
-        CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
+        SetThreadRecordingTime(ThreadIndex, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count());
+        SetThreadDrawCount(ThreadIndex, NumDraws);
+        SetThreadSkippedBinds(ThreadIndex, NumSkippedBinds);
     };
 
-    std::for_each(std::execution::unseq,
-                  std::cbegin(ThreadIndices),
-                  std::cend(ThreadIndices),
-                  [&](std::uint32_t const ThreadIndex)
-                  {
-                      g_ThreadPool.AddTask([ProcessCommandBuffer, ThreadIndex]
-                                           {
-                                               ProcessCommandBuffer(ThreadIndex);
-                                           },
-                                           ThreadIndex);
-                  });
+    ScopedFrameTimer const Timer { FrameStage::SecondaryRecording };
 
-    std::for_each(std::execution::unseq,
-                  std::cbegin(CommandResources.MultiThreadResources),
-                  std::cend(CommandResources.MultiThreadResources),
-                  [&](auto const &ResourcePair)
-                  {
-                      if (ResourcePair.second.CommandBuffer != VK_NULL_HANDLE)
-                      {
-                          Output.push_back(ResourcePair.second.CommandBuffer);
-                      }
-                  });
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < NumActiveThreads; ++ThreadIndex)
+    {
+        g_ThreadPool.AddTask([ProcessCommandBuffer, ThreadIndex]
+                             {
+                                 ProcessCommandBuffer(ThreadIndex);
+                             },
+                             ThreadIndex);
+    }
 
     g_ThreadPool.Wait();
 
+    std::vector<VkCommandBuffer> Output;
+    Output.reserve(std::size(g_RecordedBatches));
+
+    std::ranges::copy_if(g_RecordedBatches,
+                         std::back_inserter(Output),
+                         [](VkCommandBuffer const &CommandBuffer)
+                         {
+                             return CommandBuffer != VK_NULL_HANDLE;
+                         });
+
     return Output;
 }
 
-void RenderCore::RecordCommandBuffers(std::uint32_t const ImageIndex)
+void RecordIndirectSceneCommands(VkCommandBuffer const &CommandBuffer,
+                                 std::uint32_t const    FrameIndex,
+                                 ImageAllocation const &ColorAllocation,
+                                 ImageAllocation const &DepthAllocation,
+                                 SceneSnapshot const &  Snapshot)
 {
-    ImageAllocation const &SwapchainAllocation = GetSwapChainImages().at(ImageIndex);
-    ImageAllocation const &DepthAllocation     = GetDepthImage();
-    ImageAllocation const &OffscreenAllocation = GetOffscreenImages().at(ImageIndex);
+    RENDERCORE_PROFILE_FUNCTION();
 
-    VkCommandBuffer const &CommandBuffer = g_CommandResources.at(ImageIndex).PrimaryCommandBuffer;
-    CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &g_CommandBufferBeginInfo));
+    ScopedFrameTimer const Timer { FrameStage::SecondaryRecording };
+    auto const             StartTime = std::chrono::steady_clock::now();
 
-    BeginRendering(CommandBuffer, SwapchainAllocation, DepthAllocation, OffscreenAllocation);
+    std::uint32_t const NumDraws = BuildIndirectDraws(FrameIndex, Snapshot);
 
-    if (std::vector<VkCommandBuffer> const CommandBuffers = RecordSceneCommands(ImageIndex, SwapchainAllocation, DepthAllocation);
-        !std::empty(CommandBuffers))
+    // Culling has to be recorded outside of the rendering scope, either here or in the compute buffer submitted ahead of this frame
+    if (CommandResources &Resources = g_CommandResources.at(FrameIndex);
+        CanUseAsyncCulling() && Resources.ComputeCommandBuffer != VK_NULL_HANDLE)
     {
-        vkCmdExecuteCommands(CommandBuffer, static_cast<std::uint32_t>(std::size(CommandBuffers)), std::data(CommandBuffers));
+        CheckVulkanResult(vkBeginCommandBuffer(Resources.ComputeCommandBuffer, &g_CommandBufferBeginInfo));
+        Resources.HasPendingCompute = RecordIndirectCulling(Resources.ComputeCommandBuffer, FrameIndex, true);
+        CheckVulkanResult(vkEndCommandBuffer(Resources.ComputeCommandBuffer));
+
+        if (Resources.HasPendingCompute)
+        {
+            AcquireIndirectDraws(CommandBuffer, FrameIndex);
+        }
+    }
+    else
+    {
+        std::ignore = RecordIndirectCulling(CommandBuffer, FrameIndex, false);
     }
 
-    EndRendering(CommandBuffer, SwapchainAllocation, OffscreenAllocation);
-    CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
+    BeginRendering(CommandBuffer, ColorAllocation, DepthAllocation, 0U);
+
+    BeginThreadQueries(CommandBuffer, FrameIndex, 0U);
+    SetViewport(CommandBuffer, ColorAllocation.Extent);
+    RecordIndirectDraws(CommandBuffer, FrameIndex);
+    EndThreadQueries(CommandBuffer, FrameIndex, 0U);
+
+    SetThreadRecordingTime(0U, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count());
+    SetThreadDrawCount(0U, NumDraws);
 }
 
-void RenderCore::SubmitCommandBuffers(std::uint32_t const ImageIndex)
+RenderGraph::PassCallback TimePass(std::uint32_t const FrameIndex, strzilla::string_view const Name, RenderGraph::PassCallback &&Callback)
 {
-    VkSemaphoreSubmitInfo const WaitSemaphoreInfo {
-            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-            .semaphore = GetImageAvailableSemaphore(ImageIndex),
-            .value = 1U,
-            .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+    return [FrameIndex, Name, Callback = std::move(Callback)](VkCommandBuffer const &CommandBuffer, RenderGraph const &Graph)
+    {
+        std::uint32_t const PassQuery = BeginPassQuery(CommandBuffer, FrameIndex, Name);
+        Callback(CommandBuffer, Graph);
+        EndPassQuery(CommandBuffer, FrameIndex, PassQuery);
     };
+}
+
+void RenderCore::RecordCommandBuffers(std::uint32_t const FrameIndex, std::uint32_t const ImageIndex, SceneSnapshot const &Snapshot)
+{
+    bool const HasOffscreen = Renderer::GetRenderOffscreen();
+    bool const HasSwapchain = !Renderer::IsHeadless();
+
+    RenderGraph &Graph = g_RenderGraphs.at(FrameIndex);
+    Graph.Reset();
+
+    RenderGraphResource const Swapchain = HasSwapchain
+                                              ? Graph.ImportImage("Swapchain", GetSwapChainImages().at(ImageIndex), g_ImageAspect, g_PresentLayout)
+                                              : RenderGraphResource {};
+
+    RenderGraphResource const Offscreen = HasOffscreen
+                                              ? Graph.ImportImage("Offscreen", GetOffscreenImages().at(FrameIndex), g_ImageAspect, g_ReadLayout)
+                                              : RenderGraphResource {};
+
+    RenderGraphResource const Color       = HasOffscreen ? Offscreen : Swapchain;
+    VkFormat const            DepthFormat = GetDepthFormat();
+
+    RenderGraphResource const Depth = Graph.CreateTransientImage("Depth",
+                                                                 RenderGraphImageDescription {
+                                                                         .Format = DepthFormat,
+                                                                         .Extent = Graph.GetImage(Color).Extent,
+                                                                         .Usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                                                         .Aspect = DepthHasStencil(DepthFormat)
+                                                                                       ? g_DepthAspect | VK_IMAGE_ASPECT_STENCIL_BIT
+                                                                                       : g_DepthAspect
+                                                                 });
+
+    Graph.AddPass("Scene",
+                  { { Color, RenderGraphAccess::ColorAttachmentWrite }, { Depth, RenderGraphAccess::DepthAttachmentWrite } },
+                  TimePass(FrameIndex,
+                           "Scene",
+                           [FrameIndex, Color, Depth, &Snapshot](VkCommandBuffer const &CommandBuffer, RenderGraph const &Graph)
+                           {
+                               ImageAllocation const &ColorAllocation = Graph.GetImage(Color);
+                               ImageAllocation const &DepthAllocation = Graph.GetImage(Depth);
+
+                               if (CanUseIndirectDraws())
+                               {
+                                   RecordIndirectSceneCommands(CommandBuffer, FrameIndex, ColorAllocation, DepthAllocation, Snapshot);
+                               }
+                               else
+                               {
+                                   BeginRendering(CommandBuffer, ColorAllocation, DepthAllocation, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+
+                                   if (std::vector<VkCommandBuffer> const CommandBuffers = RecordSceneCommands(FrameIndex,
+                                                                                                               ColorAllocation,
+                                                                                                               DepthAllocation,
+                                                                                                               Snapshot);
+                                       !std::empty(CommandBuffers))
+                                   {
+                                       vkCmdExecuteCommands(CommandBuffer, static_cast<std::uint32_t>(std::size(CommandBuffers)), std::data(CommandBuffers));
+                                   }
+                               }
+
+                               vkCmdEndRendering(CommandBuffer);
+                           }));
+
+    if (HasSwapchain && g_OnCommandBufferRecordCallback)
+    {
+        std::vector<std::pair<RenderGraphResource, RenderGraphAccess>> Accesses { { Swapchain, RenderGraphAccess::ColorAttachmentWrite } };
+
+        if (HasOffscreen)
+        {
+            Accesses.emplace_back(Offscreen, RenderGraphAccess::ShaderRead);
+        }
 
+        Graph.AddPass("Overlay",
+                      std::move(Accesses),
+                      TimePass(FrameIndex,
+                               "Overlay",
+                               [Swapchain](VkCommandBuffer const &CommandBuffer, RenderGraph const &Graph)
+                               {
+                                   g_OnCommandBufferRecordCallback(CommandBuffer, Graph.GetImage(Swapchain));
+                               }),
+                      true);
+    }
+
+    CommandResources &     Resources     = g_CommandResources.at(FrameIndex);
+    VkCommandBuffer const &CommandBuffer = Resources.PrimaryCommandBuffer;
+    CheckVulkanResult(vkBeginCommandBuffer(CommandBuffer, &g_CommandBufferBeginInfo));
+    BeginFrameQueries(CommandBuffer, FrameIndex);
+
+    // Textures released by the transfer queue are acquired before any pass samples them
+    Resources.UploadWaitValue = RecordUploadAcquires(CommandBuffer);
+    {
+        RENDERCORE_PROFILE_SCOPE("ExecuteRenderGraph");
+        Graph.Execute(CommandBuffer);
+    }
+    EndFrameQueries(CommandBuffer, FrameIndex);
+    CheckVulkanResult(vkEndCommandBuffer(CommandBuffer));
+}
+
+VkSemaphoreSubmitInfo SubmitComputeCommandBuffer(VkCommandBuffer const &CommandBuffer)
+{
     VkSemaphoreSubmitInfo const SignalSemaphoreInfo {
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-            .semaphore = GetRenderFinishedSemaphore(ImageIndex),
-            .value = 1U,
-            .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+            .semaphore = GetComputeTimelineSemaphore(),
+            .value = AdvanceComputeTimeline(),
+            .stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
     };
 
-    VkCommandBuffer const &         CommandBuffer = g_CommandResources.at(ImageIndex).PrimaryCommandBuffer;
-    VkCommandBufferSubmitInfo const PrimarySubmission { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .commandBuffer = CommandBuffer };
+    VkCommandBufferSubmitInfo const ComputeSubmission { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .commandBuffer = CommandBuffer };
 
     VkSubmitInfo2 const SubmitInfo {
             .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-            .waitSemaphoreInfoCount = 1U,
-            .pWaitSemaphoreInfos = &WaitSemaphoreInfo,
             .commandBufferInfoCount = 1U,
-            .pCommandBufferInfos = &PrimarySubmission,
+            .pCommandBufferInfos = &ComputeSubmission,
             .signalSemaphoreInfoCount = 1U,
             .pSignalSemaphoreInfos = &SignalSemaphoreInfo
     };
 
-    auto const &Queue = GetGraphicsQueue().second;
-    CheckVulkanResult(vkQueueSubmit2(Queue, 1U, &SubmitInfo, GetFence(ImageIndex)));
-    SetFenceWaitStatus(ImageIndex, true);
+    CheckVulkanResult(vkQueueSubmit2(GetComputeQueue().second, 1U, &SubmitInfo, VK_NULL_HANDLE));
 
-    if (Renderer::GetUseDefaultSync())
-    {
-        WaitAndResetFence(ImageIndex);
-    }
+    return VkSemaphoreSubmitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = SignalSemaphoreInfo.semaphore,
+            .value = SignalSemaphoreInfo.value,
+            .stageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT
+    };
 }
 
-void RenderCore::InitializeSingleCommandQueue(VkCommandPool &               CommandPool,
-                                              std::vector<VkCommandBuffer> &CommandBuffers,
-                                              std::uint8_t const            QueueFamilyIndex)
+void RenderCore::SubmitCommandBuffers(std::uint32_t const FrameIndex, std::uint32_t const ImageIndex)
 {
-    if (std::empty(CommandBuffers))
-    {
-        return;
-    }
-
-    CommandPool = CreateCommandPool(QueueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
-
-    VkCommandBufferAllocateInfo const CommandBufferAllocateInfo {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool = CommandPool,
-            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = static_cast<std::uint32_t>(std::size(CommandBuffers)),
-    };
+    bool const IsHeadless = Renderer::IsHeadless();
 
-    VkDevice const &LogicalDevice = GetLogicalDevice();
+    std::array<VkSemaphoreSubmitInfo, 3U> WaitSemaphoreInfos {};
+    std::uint32_t                         NumWaitSemaphores = 0U;
 
-    CheckVulkanResult(vkAllocateCommandBuffers(LogicalDevice, &CommandBufferAllocateInfo, std::data(CommandBuffers)));
+    if (!IsHeadless)
+    {
+        WaitSemaphoreInfos.at(NumWaitSemaphores++) = VkSemaphoreSubmitInfo {
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                .semaphore = GetImageAvailableSemaphore(FrameIndex),
+                .value = 0U,
+                .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+        };
+    }
 
-    std::for_each(std::execution::unseq,
-                  std::cbegin(CommandBuffers),
-                  std::cend(CommandBuffers),
-                  [&](VkCommandBuffer const &CommandBufferIter)
-                  {
-                      CheckVulkanResult(vkBeginCommandBuffer(CommandBufferIter, &g_CommandBufferBeginInfo));
-                  });
-}
+    CommandResources &Resources = g_CommandResources.at(FrameIndex);
 
-void RenderCore::FinishSingleCommandQueue(VkQueue const &Queue, VkCommandPool const &CommandPool, std::vector<VkCommandBuffer> const &CommandBuffers)
-{
-    if (std::empty(CommandBuffers) || CommandPool == VK_NULL_HANDLE)
+    // The culling pass goes first on the compute queue; its frame slot was already waited on the host, so only graphics waits on it
+    if (Resources.HasPendingCompute)
     {
-        return;
+        WaitSemaphoreInfos.at(NumWaitSemaphores++) = SubmitComputeCommandBuffer(Resources.ComputeCommandBuffer);
+        Resources.HasPendingCompute                = false;
     }
 
-    std::vector<VkCommandBufferSubmitInfo> CommandBufferInfos;
-    CommandBufferInfos.reserve(std::size(CommandBuffers));
+    // The release half of the ownership transfer has to precede the acquire recorded in this frame, staged geometry is read at vertex input
+    if (Resources.UploadWaitValue != 0U)
+    {
+        WaitSemaphoreInfos.at(NumWaitSemaphores++) = VkSemaphoreSubmitInfo {
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                .semaphore = GetTransferTimelineSemaphore(),
+                .value = std::exchange(Resources.UploadWaitValue, 0U),
+                .stageMask = g_UploadWaitStages
+        };
+    }
 
-    std::for_each(std::execution::unseq,
-                  std::cbegin(CommandBuffers),
-                  std::cend(CommandBuffers),
-                  [&](VkCommandBuffer const &CommandBufferIter)
-                  {
-                      CheckVulkanResult(vkEndCommandBuffer(CommandBufferIter));
+    std::array const SignalSemaphoreInfos {
+            VkSemaphoreSubmitInfo {
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                    .semaphore = GetFrameTimelineSemaphore(),
+                    .value = AdvanceFrameTimeline(FrameIndex),
+                    .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+            },
+            VkSemaphoreSubmitInfo {
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                    .semaphore = IsHeadless ? VK_NULL_HANDLE : GetRenderFinishedSemaphore(ImageIndex),
+                    .value = 0U,
+                    .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+            }
+    };
 
-                      CommandBufferInfos.push_back(VkCommandBufferSubmitInfo {
-                                                           .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-                                                           .commandBuffer = CommandBufferIter,
-                                                           .deviceMask = 0U
-                                                   });
-                  });
+    VkCommandBuffer const &         CommandBuffer = Resources.PrimaryCommandBuffer;
+    VkCommandBufferSubmitInfo const PrimarySubmission { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .commandBuffer = CommandBuffer };
 
     VkSubmitInfo2 const SubmitInfo {
             .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-            .commandBufferInfoCount = static_cast<std::uint32_t>(std::size(CommandBufferInfos)),
-            .pCommandBufferInfos = std::data(CommandBufferInfos)
+            .waitSemaphoreInfoCount = NumWaitSemaphores,
+            .pWaitSemaphoreInfos = std::data(WaitSemaphoreInfos),
+            .commandBufferInfoCount = 1U,
+            .pCommandBufferInfos = &PrimarySubmission,
+            .signalSemaphoreInfoCount = IsHeadless ? 1U : static_cast<std::uint32_t>(std::size(SignalSemaphoreInfos)),
+            .pSignalSemaphoreInfos = std::data(SignalSemaphoreInfos)
     };
 
+    auto const &Queue = GetGraphicsQueue().second;
     CheckVulkanResult(vkQueueSubmit2(Queue, 1U, &SubmitInfo, VK_NULL_HANDLE));
-    CheckVulkanResult(vkQueueWaitIdle(Queue));
-
-    VkDevice const &LogicalDevice = GetLogicalDevice();
 
-    vkFreeCommandBuffers(LogicalDevice, CommandPool, static_cast<std::uint32_t>(std::size(CommandBuffers)), std::data(CommandBuffers));
-    vkDestroyCommandPool(LogicalDevice, CommandPool, nullptr);
+    if (Renderer::GetUseDefaultSync())
+    {
+        WaitForFrame(FrameIndex);
+    }
 }
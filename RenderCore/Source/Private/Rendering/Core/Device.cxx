@@ -15,26 +15,48 @@ import RenderCore.Utils.DebugHelpers;
 
 using namespace RenderCore;
 
-bool IsPhysicalDeviceSuitable(VkPhysicalDevice const &Device)
+std::uint8_t GetPhysicalDeviceScore(VkPhysicalDevice const &Device)
 {
     if (Device == VK_NULL_HANDLE)
     {
-        return false;
+        return 0U;
     }
 
-    VkPhysicalDeviceProperties SurfaceProperties;
-    vkGetPhysicalDeviceProperties(Device, &SurfaceProperties);
+    VkPhysicalDeviceProperties DeviceProperties;
+    vkGetPhysicalDeviceProperties(Device, &DeviceProperties);
 
     VkPhysicalDeviceFeatures SupportedFeatures;
     vkGetPhysicalDeviceFeatures(Device, &SupportedFeatures);
 
-    return SurfaceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU && SupportedFeatures.samplerAnisotropy != 0U;
+    if (SupportedFeatures.samplerAnisotropy == 0U)
+    {
+        return 0U;
+    }
+
+    switch (DeviceProperties.deviceType)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            return 4U;
+
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            return Renderer::IsHeadless() ? 3U : 0U;
+
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            return Renderer::IsHeadless() ? 2U : 0U;
+
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            return Renderer::IsHeadless() ? 1U : 0U;
+
+        default:
+            return 0U;
+    }
 }
 
 bool GetQueueFamilyIndices(VkSurfaceKHR const &         VulkanSurface,
                            std::optional<std::uint8_t> &GraphicsQueueFamilyIndex,
                            std::optional<std::uint8_t> &PresentationQueueFamilyIndex,
-                           std::optional<std::uint8_t> &ComputeQueueFamilyIndex)
+                           std::optional<std::uint8_t> &ComputeQueueFamilyIndex,
+                           std::optional<std::uint8_t> &TransferQueueFamilyIndex)
 {
     std::uint32_t QueueFamilyCount = 0U;
     vkGetPhysicalDeviceQueueFamilyProperties(g_PhysicalDevice, &QueueFamilyCount, nullptr);
@@ -48,7 +70,7 @@ bool GetQueueFamilyIndices(VkSurfaceKHR const &         VulkanSurface,
         {
             GraphicsQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
 
-            if (!PresentationQueueFamilyIndex.has_value())
+            if (!PresentationQueueFamilyIndex.has_value() && VulkanSurface != VK_NULL_HANDLE)
             {
                 VkBool32 PresentationSupport = 0U;
                 CheckVulkanResult(vkGetPhysicalDeviceSurfaceSupportKHR(g_PhysicalDevice, Iterator, VulkanSurface, &PresentationSupport));
@@ -63,27 +85,42 @@ bool GetQueueFamilyIndices(VkSurfaceKHR const &         VulkanSurface,
         {
             ComputeQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
         }
+        else if (constexpr VkQueueFlags QueueTypeFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+            !TransferQueueFamilyIndex.has_value() && (QueueFamilies.at(Iterator).queueFlags & QueueTypeFlags) == VK_QUEUE_TRANSFER_BIT)
+        {
+            // Transfer-only families map to the copy engines, which run alongside graphics work
+            TransferQueueFamilyIndex.emplace(static_cast<std::uint8_t>(Iterator));
+        }
 
-        if (GraphicsQueueFamilyIndex.has_value() && PresentationQueueFamilyIndex.has_value() && ComputeQueueFamilyIndex.has_value())
+        if (GraphicsQueueFamilyIndex.has_value() && PresentationQueueFamilyIndex.has_value() && ComputeQueueFamilyIndex.has_value() &&
+            TransferQueueFamilyIndex.has_value())
         {
             break;
         }
     }
 
-    return GraphicsQueueFamilyIndex.has_value() && PresentationQueueFamilyIndex.has_value() && ComputeQueueFamilyIndex.has_value();
+    return GraphicsQueueFamilyIndex.has_value() && (PresentationQueueFamilyIndex.has_value() || VulkanSurface == VK_NULL_HANDLE);
 }
 
 void PickPhysicalDevice()
 {
+    std::uint8_t BestScore = 0U;
+
     for (VkPhysicalDevice const &Device : GetAvailablePhysicalDevices())
     {
-        if (IsPhysicalDeviceSuitable(Device))
+        if (std::uint8_t const Score = GetPhysicalDeviceScore(Device);
+            Score > BestScore)
         {
+            BestScore        = Score;
             g_PhysicalDevice = Device;
-            break;
         }
     }
 
+    if (g_PhysicalDevice == VK_NULL_HANDLE)
+    {
+        EmitFatalError("No suitable physical device found");
+    }
+
     vkGetPhysicalDeviceProperties(g_PhysicalDevice, &g_PhysicalDeviceProperties);
 }
 
@@ -91,13 +128,30 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
 {
     std::optional<std::uint8_t> GraphicsQueueFamilyIndex { std::nullopt };
     std::optional<std::uint8_t> ComputeQueueFamilyIndex { std::nullopt };
+    std::optional<std::uint8_t> TransferQueueFamilyIndex { std::nullopt };
     std::optional<std::uint8_t> PresentationQueueFamilyIndex { std::nullopt };
 
-    GetQueueFamilyIndices(VulkanSurface, GraphicsQueueFamilyIndex, PresentationQueueFamilyIndex, ComputeQueueFamilyIndex);
+    if (!GetQueueFamilyIndices(VulkanSurface, GraphicsQueueFamilyIndex, PresentationQueueFamilyIndex, ComputeQueueFamilyIndex, TransferQueueFamilyIndex))
+    {
+        EmitFatalError("Failed to find the required queue families");
+    }
+
+    g_GraphicsQueue.first = GraphicsQueueFamilyIndex.value();
+    g_ComputeQueue.first  = ComputeQueueFamilyIndex.value_or(g_GraphicsQueue.first);
+    g_TransferQueue.first = TransferQueueFamilyIndex.value_or(g_GraphicsQueue.first);
 
     std::vector Layers(std::cbegin(g_RequiredDeviceLayers), std::cend(g_RequiredDeviceLayers));
     std::vector Extensions(std::cbegin(g_RequiredDeviceExtensions), std::cend(g_RequiredDeviceExtensions));
 
+    if (VulkanSurface == VK_NULL_HANDLE)
+    {
+        std::erase_if(Extensions,
+                      [](char const *const ExtensionIter)
+                      {
+                          return std::string_view { ExtensionIter } == VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+                      });
+    }
+
     #ifdef _DEBUG
     Layers.insert(std::cend(Layers), std::cbegin(g_DebugDeviceLayers), std::cend(g_DebugDeviceLayers));
     Extensions.insert(std::cend(Extensions), std::cbegin(g_DebugDeviceExtensions), std::cend(g_DebugDeviceExtensions));
@@ -115,7 +169,7 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
     g_UniqueQueueFamilyIndices.reserve(std::size(QueueFamilyIndices));
 
     std::vector<VkDeviceQueueCreateInfo> QueueCreateInfo;
-    QueueCreateInfo.reserve(std::size(QueueFamilyIndices));
+    QueueCreateInfo.reserve(std::size(QueueFamilyIndices) + 2U);
 
     std::vector Priorities { 0.F };
     for (auto const &Index : QueueFamilyIndices | std::views::keys)
@@ -130,6 +184,28 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
                                   });
     }
 
+    // The compute family only backs async compute work, it is kept out of the unique indices so the swapchain stays exclusive
+    if (HasAsyncComputeQueue())
+    {
+        QueueCreateInfo.push_back(VkDeviceQueueCreateInfo {
+                                          .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                                          .queueFamilyIndex = g_ComputeQueue.first,
+                                          .queueCount = 1U,
+                                          .pQueuePriorities = std::data(Priorities)
+                                  });
+    }
+
+    // Same for the transfer family: uploads hand their resources over to graphics with explicit ownership transfers
+    if (HasDedicatedTransferQueue())
+    {
+        QueueCreateInfo.push_back(VkDeviceQueueCreateInfo {
+                                          .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                                          .queueFamilyIndex = g_TransferQueue.first,
+                                          .queueCount = 1U,
+                                          .pQueuePriorities = std::data(Priorities)
+                                  });
+    }
+
     VkPhysicalDeviceMeshShaderFeaturesEXT MeshShaderFeatures {
             // Required
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
@@ -166,18 +242,41 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
             .synchronization2 = VK_TRUE
     };
 
+    VkPhysicalDeviceTimelineSemaphoreFeatures TimelineSemaphoreFeatures {
+            // Required
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+            .pNext = &Synchronization2Features,
+            .timelineSemaphore = VK_TRUE
+    };
+
     VkPhysicalDeviceDynamicRenderingFeatures DynamicRenderingFeatures {
             // Required
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
-            .pNext = &Synchronization2Features,
+            .pNext = &TimelineSemaphoreFeatures,
             .dynamicRendering = VK_TRUE
     };
 
+    VkPhysicalDeviceShaderDrawParametersFeatures ShaderDrawParametersFeatures {
+            // Required
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES,
+            .pNext = &DynamicRenderingFeatures,
+            .shaderDrawParameters = VK_TRUE
+    };
+
+    VkPhysicalDeviceDescriptorIndexingFeatures DescriptorIndexingFeatures {
+            // Required
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+            .pNext = &ShaderDrawParametersFeatures,
+            .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+            .runtimeDescriptorArray = VK_TRUE
+    };
+
     VkPhysicalDeviceFeatures2 DeviceFeatures {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-            .pNext = &DynamicRenderingFeatures,
+            .pNext = &DescriptorIndexingFeatures,
             .features = VkPhysicalDeviceFeatures {
                     .independentBlend = VK_TRUE,
+                    .multiDrawIndirect = true,
                     .drawIndirectFirstInstance = true,
                     .fillModeNonSolid = true,
                     .wideLines = true,
@@ -205,6 +304,8 @@ void CreateLogicalDevice(VkSurfaceKHR const &VulkanSurface)
     volkLoadDevice(g_Device);
 
     vkGetDeviceQueue(g_Device, g_GraphicsQueue.first, 0U, &g_GraphicsQueue.second);
+    vkGetDeviceQueue(g_Device, g_ComputeQueue.first, 0U, &g_ComputeQueue.second);
+    vkGetDeviceQueue(g_Device, g_TransferQueue.first, 0U, &g_TransferQueue.second);
 }
 
 void RenderCore::InitializeDevice(VkSurfaceKHR const &VulkanSurface)
@@ -247,6 +348,8 @@ void RenderCore::ReleaseDeviceResources()
 
     g_PhysicalDevice       = VK_NULL_HANDLE;
     g_GraphicsQueue.second = VK_NULL_HANDLE;
+    g_ComputeQueue.second  = VK_NULL_HANDLE;
+    g_TransferQueue.second = VK_NULL_HANDLE;
 }
 
 std::vector<VkPhysicalDevice> RenderCore::GetAvailablePhysicalDevices()
@@ -0,0 +1,134 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.DrawPacket;
+
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Types.Material;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.Vertex;
+import RenderCore.Utils.Constants;
+
+using namespace RenderCore;
+
+constexpr std::uint32_t g_DrawPacketRadixBits   = 8U;
+constexpr std::uint32_t g_DrawPacketRadixSize   = 1U << g_DrawPacketRadixBits;
+constexpr std::uint32_t g_DrawPacketRadixMask   = g_DrawPacketRadixSize - 1U;
+constexpr std::uint32_t g_DrawPacketRadixPasses = sizeof(std::uint32_t) * 8U / g_DrawPacketRadixBits;
+
+std::uint32_t GetStateKey(MaterialData const &Material)
+{
+    // Opaque first, then masked, then blended; double-sided draws are kept apart since they'd need a pipeline without culling
+    return static_cast<std::uint32_t>(Material.AlphaMode) << 6U | (Material.DoubleSided ? 1U : 0U) << 5U;
+}
+
+void RenderCore::BuildDrawPackets(std::vector<ObjectSnapshot> const &Objects,
+                                  Camera const &                     Camera,
+                                  std::uint32_t const                Begin,
+                                  std::uint32_t const                End,
+                                  std::vector<DrawPacket> &          Output)
+{
+    glm::vec3 const CameraPosition = Camera.GetPosition();
+    glm::vec3 const CameraFront    = Camera.GetFront();
+    float const     DepthScale     = static_cast<float>(g_DrawPacketDepthMask) / std::max(Camera.GetDrawDistance(), 1.F);
+
+    for (std::uint32_t ObjectIndex = Begin; ObjectIndex < End; ++ObjectIndex)
+    {
+        ObjectSnapshot const &ObjectState = Objects.at(ObjectIndex);
+        auto const &          Object      = ObjectState.Object;
+        auto const &          Mesh        = Object->GetMesh();
+
+        if (!Mesh || !Camera.CanDrawObject(Object))
+        {
+            continue;
+        }
+
+        MaterialData const &Material = Mesh->GetMaterialData();
+
+        float const ViewDepth = std::clamp(dot(Mesh->GetCenter() - CameraPosition, CameraFront) * DepthScale,
+                                           0.F,
+                                           static_cast<float>(g_DrawPacketDepthMask));
+
+        auto Depth = static_cast<std::uint32_t>(ViewDepth);
+        if (Material.AlphaMode == AlphaMode::ALPHA_BLEND)
+        {
+            Depth = g_DrawPacketDepthMask - Depth;
+        }
+
+        Output.push_back(DrawPacket {
+                .SortKey = GetStateKey(Material) << g_DrawPacketDepthBits | Depth,
+                .ObjectIndex = ObjectIndex,
+                .BufferIndex = Object->GetBufferIndex(),
+                .FirstIndex = static_cast<std::uint32_t>(Mesh->GetIndexOffset() / sizeof(std::uint32_t)),
+                .VertexOffset = static_cast<std::int32_t>(Mesh->GetVertexOffset() / sizeof(Vertex)),
+                .NumIndices = Mesh->GetNumIndices(),
+                .NumInstances = std::max(ObjectState.NumInstances, 1U)
+        });
+    }
+}
+
+void RenderCore::SortDrawPackets(std::vector<DrawPacket> &Packets, std::vector<DrawPacket> &Scratch)
+{
+    auto const NumPackets = static_cast<std::uint32_t>(std::size(Packets));
+    if (NumPackets < 2U)
+    {
+        return;
+    }
+
+    // One read of the keys builds the histograms of every pass
+    std::array<std::array<std::uint32_t, g_DrawPacketRadixSize>, g_DrawPacketRadixPasses> Histograms {};
+
+    for (DrawPacket const &PacketIter : Packets)
+    {
+        for (std::uint32_t Pass = 0U; Pass < g_DrawPacketRadixPasses; ++Pass)
+        {
+            ++Histograms.at(Pass).at((PacketIter.SortKey >> Pass * g_DrawPacketRadixBits) & g_DrawPacketRadixMask);
+        }
+    }
+
+    Scratch.resize(NumPackets);
+
+    for (std::uint32_t Pass = 0U; Pass < g_DrawPacketRadixPasses; ++Pass)
+    {
+        std::array<std::uint32_t, g_DrawPacketRadixSize> &Histogram = Histograms.at(Pass);
+        std::uint32_t const                               Shift     = Pass * g_DrawPacketRadixBits;
+
+        if (std::ranges::find(Histogram, NumPackets) != std::cend(Histogram))
+        {
+            continue;
+        }
+
+        std::exclusive_scan(std::cbegin(Histogram), std::cend(Histogram), std::begin(Histogram), 0U);
+
+        for (DrawPacket const &PacketIter : Packets)
+        {
+            Scratch[Histogram[(PacketIter.SortKey >> Shift) & g_DrawPacketRadixMask]++] = PacketIter;
+        }
+
+        std::swap(Packets, Scratch);
+    }
+}
+
+void RenderCore::RecordDrawPackets(CommandStateTracker &             StateTracker,
+                                   VkPipelineLayout const &          PipelineLayout,
+                                   std::uint32_t const               FrameIndex,
+                                   std::span<DrawPacket const> const Packets)
+{
+    PipelineDescriptorData const &PipelineDescriptors = GetPipelineDescriptorData();
+    PipelineDescriptors.BindSceneDescriptorBuffers(StateTracker);
+    StateTracker.BindGeometryBuffer(GetAllocationBuffer());
+
+    VkCommandBuffer const &CommandBuffer = StateTracker.GetCommandBuffer();
+
+    for (DrawPacket const &PacketIter : Packets)
+    {
+        PipelineDescriptors.SetObjectDescriptorOffsets(StateTracker, PipelineLayout, FrameIndex, PacketIter.BufferIndex);
+
+        vkCmdDrawIndexed(CommandBuffer, PacketIter.NumIndices, PacketIter.NumInstances, PacketIter.FirstIndex, PacketIter.VertexOffset, 0U);
+    }
+}
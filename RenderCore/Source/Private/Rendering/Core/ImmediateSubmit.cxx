@@ -0,0 +1,183 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.ImmediateSubmit;
+
+import RenderCore.Runtime.Device;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.Helpers;
+
+using namespace RenderCore;
+
+constexpr VkCommandBufferBeginInfo g_TransientBeginInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+};
+
+// Entries are never moved, references handed out stay valid until the cache is released
+std::mutex                                      g_TransientCommandsMutex {};
+std::vector<std::unique_ptr<TransientCommands>> g_TransientCommands {};
+
+std::unique_ptr<TransientCommands> CreateTransientCommands(std::uint8_t const QueueFamilyIndex)
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    auto NewCommands = std::make_unique<TransientCommands>(TransientCommands {
+            .QueueFamilyIndex = QueueFamilyIndex,
+            .OwnerThread = std::this_thread::get_id()
+    });
+
+    VkCommandPoolCreateInfo const CommandPoolCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = QueueFamilyIndex
+    };
+
+    CheckVulkanResult(vkCreateCommandPool(LogicalDevice, &CommandPoolCreateInfo, nullptr, &NewCommands->CommandPool));
+
+    VkCommandBufferAllocateInfo const CommandBufferAllocateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = NewCommands->CommandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1U
+    };
+
+    CheckVulkanResult(vkAllocateCommandBuffers(LogicalDevice, &CommandBufferAllocateInfo, &NewCommands->CommandBuffer));
+
+    constexpr VkFenceCreateInfo FenceCreateInfo { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, .flags = VK_FENCE_CREATE_SIGNALED_BIT };
+    CheckVulkanResult(vkCreateFence(LogicalDevice, &FenceCreateInfo, nullptr, &NewCommands->Fence));
+
+    return NewCommands;
+}
+
+TransientCommands &RenderCore::AcquireTransientCommands(std::uint8_t const QueueFamilyIndex)
+{
+    VkDevice const &      LogicalDevice = GetLogicalDevice();
+    std::thread::id const CurrentThread = std::this_thread::get_id();
+
+    TransientCommands *Output = nullptr;
+    {
+        std::lock_guard Lock { g_TransientCommandsMutex };
+
+        // Entries recorded by this thread before are preferred, their pool memory is likely still warm
+        TransientCommands *OtherThreadEntry = nullptr;
+
+        for (auto const &EntryIter : g_TransientCommands)
+        {
+            if (EntryIter->InUse || EntryIter->QueueFamilyIndex != QueueFamilyIndex || vkGetFenceStatus(LogicalDevice, EntryIter->Fence) != VK_SUCCESS)
+            {
+                continue;
+            }
+
+            if (EntryIter->OwnerThread == CurrentThread)
+            {
+                Output = EntryIter.get();
+                break;
+            }
+
+            if (!OtherThreadEntry)
+            {
+                OtherThreadEntry = EntryIter.get();
+            }
+        }
+
+        if (!Output)
+        {
+            Output = OtherThreadEntry ? OtherThreadEntry : g_TransientCommands.emplace_back(CreateTransientCommands(QueueFamilyIndex)).get();
+        }
+
+        Output->InUse       = true;
+        Output->OwnerThread = CurrentThread;
+    }
+
+    CheckVulkanResult(vkResetCommandPool(LogicalDevice, Output->CommandPool, 0U));
+    CheckVulkanResult(vkBeginCommandBuffer(Output->CommandBuffer, &g_TransientBeginInfo));
+
+    return *Output;
+}
+
+void RenderCore::RecycleTransientCommands(TransientCommands &Commands)
+{
+    std::lock_guard Lock { g_TransientCommandsMutex };
+    Commands.InUse = false;
+}
+
+void RenderCore::SubmitTransientCommands(TransientCommands &                          Commands,
+                                         VkQueue const &                              Queue,
+                                         std::span<VkSemaphoreSubmitInfo const> const SignalSemaphores,
+                                         bool const                                   Wait)
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    CheckVulkanResult(vkEndCommandBuffer(Commands.CommandBuffer));
+
+    VkCommandBufferSubmitInfo const CommandBufferInfo { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .commandBuffer = Commands.CommandBuffer };
+
+    VkSubmitInfo2 const SubmitInfo {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .commandBufferInfoCount = 1U,
+            .pCommandBufferInfos = &CommandBufferInfo,
+            .signalSemaphoreInfoCount = static_cast<std::uint32_t>(std::size(SignalSemaphores)),
+            .pSignalSemaphoreInfos = std::data(SignalSemaphores)
+    };
+
+    // Only reset here: an entry handed back without being submitted keeps its signaled fence and can be reused right away
+    CheckVulkanResult(vkResetFences(LogicalDevice, 1U, &Commands.Fence));
+    CheckVulkanResult(vkQueueSubmit2(Queue, 1U, &SubmitInfo, Commands.Fence));
+
+    if (Wait)
+    {
+        CheckVulkanResult(vkWaitForFences(LogicalDevice, 1U, &Commands.Fence, VK_TRUE, g_Timeout));
+    }
+
+    RecycleTransientCommands(Commands);
+}
+
+void RenderCore::ReleaseTransientCommandPools()
+{
+    std::lock_guard Lock { g_TransientCommandsMutex };
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    for (auto const &EntryIter : g_TransientCommands)
+    {
+        CheckVulkanResult(vkWaitForFences(LogicalDevice, 1U, &EntryIter->Fence, VK_TRUE, g_Timeout));
+
+        vkDestroyFence(LogicalDevice, EntryIter->Fence, nullptr);
+        vkDestroyCommandPool(LogicalDevice, EntryIter->CommandPool, nullptr);
+    }
+
+    g_TransientCommands.clear();
+}
+
+ImmediateSubmit::ImmediateSubmit(std::uint8_t const QueueFamilyIndex, VkQueue const &Queue)
+    : m_Commands(&AcquireTransientCommands(QueueFamilyIndex))
+  , m_Queue(Queue)
+{
+}
+
+ImmediateSubmit::~ImmediateSubmit()
+{
+    if (!m_Commands)
+    {
+        return;
+    }
+
+    // Submitting can throw, so a scope left without Submit (e.g. while unwinding) only hands the unsubmitted entry back
+    BOOST_LOG_TRIVIAL(warning) << "[" << __func__ << "]: Immediate commands destroyed without being submitted";
+    RecycleTransientCommands(*m_Commands);
+}
+
+void ImmediateSubmit::Submit(bool const Wait)
+{
+    if (!m_Commands)
+    {
+        return;
+    }
+
+    SubmitTransientCommands(*m_Commands, m_Queue, {}, Wait);
+    m_Commands = nullptr;
+}
@@ -0,0 +1,410 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.IndirectDraw;
+
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Scene;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.Texture;
+import RenderCore.Types.Vertex;
+import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+void IndirectDrawResources::DestroyResources(VmaAllocator const &Allocator)
+{
+    Commands.DestroyResources(Allocator);
+    DrawData.DestroyResources(Allocator);
+    Count.DestroyResources(Allocator);
+    Candidates.DestroyResources(Allocator);
+
+    CullingConstants = {};
+    Capacity         = 0U;
+    NumDraws         = 0U;
+    IsCulledOnGPU    = false;
+}
+
+VkDeviceAddress GetBufferAddress(VkBuffer const &Buffer)
+{
+    VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = Buffer
+    };
+
+    return vkGetBufferDeviceAddress(GetLogicalDevice(), &BufferDeviceAddressInfo);
+}
+
+VkDeviceAddress CreateIndirectBuffer(BufferAllocation &          Allocation,
+                                     VkDeviceSize const          Size,
+                                     VkBufferUsageFlags const    Usage,
+                                     strzilla::string_view const Identifier)
+{
+    Allocation.Size = Size;
+    CreateBuffer(Size, Usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, Identifier, Allocation.Buffer, Allocation.Allocation);
+    CheckVulkanResult(vmaMapMemory(GetAllocator(), Allocation.Allocation, &Allocation.MappedData));
+
+    return GetBufferAddress(Allocation.Buffer);
+}
+
+void ReserveIndirectDraws(IndirectDrawResources &Resources, std::uint32_t const NumObjects, bool const NeedsCandidates)
+{
+    if (Resources.Capacity >= NumObjects && Resources.Commands.IsValid() && (!NeedsCandidates || Resources.Candidates.IsValid()))
+    {
+        return;
+    }
+
+    // The slot was waited on before recording, but the retire queue keeps the release path identical to the other per-frame buffers
+    RetireBufferAllocation(Resources.Commands);
+    RetireBufferAllocation(Resources.DrawData);
+    RetireBufferAllocation(Resources.Count);
+    RetireBufferAllocation(Resources.Candidates);
+
+    Resources.Capacity = std::max({ NumObjects, Resources.Capacity * 2U, g_MinIndirectDrawCapacity });
+
+    IndirectCullingConstants &Constants = Resources.CullingConstants;
+
+    Constants.CommandsAddress = CreateIndirectBuffer(Resources.Commands,
+                                                     Resources.Capacity * sizeof(VkDrawIndexedIndirectCommand),
+                                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                     "INDIRECT_COMMANDS_BUFFER");
+
+    Constants.DrawDataAddress = CreateIndirectBuffer(Resources.DrawData,
+                                                     Resources.Capacity * sizeof(IndirectDrawData),
+                                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                     "INDIRECT_DRAW_DATA_BUFFER");
+
+    Constants.CountAddress = CreateIndirectBuffer(Resources.Count,
+                                                  sizeof(std::uint32_t),
+                                                  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  "INDIRECT_COUNT_BUFFER");
+
+    Constants.CandidatesAddress = NeedsCandidates
+                                      ? CreateIndirectBuffer(Resources.Candidates,
+                                                             Resources.Capacity * sizeof(IndirectCullingCandidate),
+                                                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                             "INDIRECT_CULLING_CANDIDATES_BUFFER")
+                                      : 0U;
+}
+
+void RecordIndirectDrawBarriers(VkCommandBuffer const &      CommandBuffer,
+                                IndirectDrawResources const &Resources,
+                                VkPipelineStageFlags2 const  SrcStageMask,
+                                VkAccessFlags2 const         SrcAccessMask,
+                                VkPipelineStageFlags2 const  DstStageMask,
+                                VkAccessFlags2 const         DstAccessMask,
+                                std::uint32_t const          SrcQueueFamily,
+                                std::uint32_t const          DstQueueFamily)
+{
+    std::array<VkBufferMemoryBarrier2, 3U> BufferBarriers {};
+    std::array const                       Buffers { Resources.Commands.Buffer, Resources.DrawData.Buffer, Resources.Count.Buffer };
+
+    for (std::uint32_t Index = 0U; Index < std::size(Buffers); ++Index)
+    {
+        BufferBarriers.at(Index) = VkBufferMemoryBarrier2 {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .srcStageMask = SrcStageMask,
+                .srcAccessMask = SrcAccessMask,
+                .dstStageMask = DstStageMask,
+                .dstAccessMask = DstAccessMask,
+                .srcQueueFamilyIndex = SrcQueueFamily,
+                .dstQueueFamilyIndex = DstQueueFamily,
+                .buffer = Buffers.at(Index),
+                .offset = 0U,
+                .size = VK_WHOLE_SIZE
+        };
+    }
+
+    VkDependencyInfo const DependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = static_cast<std::uint32_t>(std::size(BufferBarriers)),
+            .pBufferMemoryBarriers = std::data(BufferBarriers)
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+bool RenderCore::CanUseIndirectDraws()
+{
+    if (!g_UseIndirectDraws || GetIndirectPipeline() == VK_NULL_HANDLE || !GetPipelineDescriptorData().IndirectTextureData.IsValid())
+    {
+        return false;
+    }
+
+    std::uint32_t const SlotCapacity = GetUniformSlotCapacity();
+    return SlotCapacity == 0U || CanDrawSlotIndirect(SlotCapacity - 1U);
+}
+
+bool RenderCore::CanUseGPUCulling()
+{
+    return g_UseGPUCulling && GetCullingPipeline() != VK_NULL_HANDLE;
+}
+
+bool RenderCore::CanUseAsyncCulling()
+{
+    return g_UseAsyncCulling && CanUseGPUCulling() && HasAsyncComputeQueue();
+}
+
+std::uint32_t RenderCore::BuildIndirectDraws(std::uint32_t const FrameIndex, SceneSnapshot const &Snapshot)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    IndirectDrawResources &Resources = g_IndirectDrawResources.at(FrameIndex);
+    Resources.NumDraws               = 0U;
+
+    auto const &Objects = Snapshot.Objects;
+    if (std::empty(Objects))
+    {
+        return 0U;
+    }
+
+    // The batches of RecordIndirectDraws share one count, which only holds the number of visible draws when everything fits in one call
+    Resources.IsCulledOnGPU = CanUseGPUCulling() && std::size(Objects) <= GetPhysicalDeviceProperties().limits.maxDrawIndirectCount;
+
+    ReserveIndirectDraws(Resources, static_cast<std::uint32_t>(std::size(Objects)), Resources.IsCulledOnGPU);
+
+    VkDeviceAddress const UniformAddress = GetBufferAddress(GetUniformAllocationBuffer());
+    VkDeviceSize const    FrameOffset    = FrameIndex * GetModelUniformStride();
+    Camera const &        Camera         = Snapshot.Camera;
+
+    auto const Commands   = static_cast<VkDrawIndexedIndirectCommand *>(Resources.Commands.MappedData);
+    auto const DrawData   = static_cast<IndirectDrawData *>(Resources.DrawData.MappedData);
+    auto const Candidates = static_cast<IndirectCullingCandidate *>(Resources.Candidates.MappedData);
+
+    constexpr auto NumTextures = static_cast<std::uint32_t>(TextureType::Count);
+
+    for (ObjectSnapshot const &SnapshotIter : Objects)
+    {
+        auto const &Object = SnapshotIter.Object;
+        auto const &Mesh   = Object->GetMesh();
+
+        if (!Mesh || Object->IsPendingDestroy())
+        {
+            continue;
+        }
+
+        VkDrawIndexedIndirectCommand const Command {
+                .indexCount = Mesh->GetNumIndices(),
+                .instanceCount = std::max(SnapshotIter.NumInstances, 1U),
+                .firstIndex = static_cast<std::uint32_t>(Mesh->GetIndexOffset() / sizeof(std::uint32_t)),
+                .vertexOffset = static_cast<std::int32_t>(Mesh->GetVertexOffset() / sizeof(Vertex)),
+                .firstInstance = 0U
+        };
+
+        VkDeviceAddress const ModelAddress = UniformAddress + Object->GetUniformOffset() + FrameOffset;
+        std::uint32_t const   TextureIndex = Object->GetBufferIndex() * NumTextures;
+
+        if (Resources.IsCulledOnGPU)
+        {
+            auto const &MeshBounds = Mesh->GetBounds();
+
+            Candidates[Resources.NumDraws++] = IndirectCullingCandidate {
+                    .BoundsMin = glm::vec4(MeshBounds.Min, 0.F),
+                    .BoundsMax = glm::vec4(MeshBounds.Max, 0.F),
+                    .Command = Command,
+                    .TextureIndex = TextureIndex,
+                    .ModelAddress = ModelAddress
+            };
+
+            continue;
+        }
+
+        if (!Camera.CanDrawObject(Object))
+        {
+            continue;
+        }
+
+        Commands[Resources.NumDraws] = Command;
+        DrawData[Resources.NumDraws] = IndirectDrawData { .ModelAddress = ModelAddress, .TextureIndex = TextureIndex };
+
+        ++Resources.NumDraws;
+    }
+
+    VmaAllocator const &Allocator = GetAllocator();
+
+    if (Resources.IsCulledOnGPU)
+    {
+        IndirectCullingConstants &Constants = Resources.CullingConstants;
+        Constants.SceneAddress              = GetBufferAddress(GetSceneUniformBuffer().Buffer) + FrameIndex * GetSceneUniformStride();
+        Constants.CameraPositionAndDistance = glm::vec4(Camera.GetPosition(), Camera.GetDrawDistance());
+        Constants.NumCandidates             = Resources.NumDraws;
+
+        CheckVulkanResult(vmaFlushAllocation(Allocator, Resources.Candidates.Allocation, 0U, Resources.NumDraws * sizeof(IndirectCullingCandidate)));
+        return Resources.NumDraws;
+    }
+
+    *static_cast<std::uint32_t *>(Resources.Count.MappedData) = Resources.NumDraws;
+
+    CheckVulkanResult(vmaFlushAllocation(Allocator, Resources.Commands.Allocation, 0U, Resources.NumDraws * sizeof(VkDrawIndexedIndirectCommand)));
+    CheckVulkanResult(vmaFlushAllocation(Allocator, Resources.DrawData.Allocation, 0U, Resources.NumDraws * sizeof(IndirectDrawData)));
+    CheckVulkanResult(vmaFlushAllocation(Allocator, Resources.Count.Allocation, 0U, sizeof(std::uint32_t)));
+
+    return Resources.NumDraws;
+}
+
+bool RenderCore::RecordIndirectCulling(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex, bool const ReleaseToGraphics)
+{
+    IndirectDrawResources const &Resources = g_IndirectDrawResources.at(FrameIndex);
+
+    if (!Resources.IsCulledOnGPU || Resources.NumDraws == 0U)
+    {
+        return false;
+    }
+
+    vkCmdFillBuffer(CommandBuffer, Resources.Count.Buffer, 0U, sizeof(std::uint32_t), 0U);
+
+    VkBufferMemoryBarrier2 const CountResetBarrier {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = Resources.Count.Buffer,
+            .offset = 0U,
+            .size = VK_WHOLE_SIZE
+    };
+
+    VkDependencyInfo const CountResetDependency {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1U,
+            .pBufferMemoryBarriers = &CountResetBarrier
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &CountResetDependency);
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, GetCullingPipeline());
+
+    vkCmdPushConstants(CommandBuffer,
+                       GetCullingPipelineLayout(),
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0U,
+                       sizeof(IndirectCullingConstants),
+                       &Resources.CullingConstants);
+    vkCmdDispatch(CommandBuffer, (Resources.NumDraws + g_CullingWorkGroupSize - 1U) / g_CullingWorkGroupSize, 1U, 1U);
+
+    if (ReleaseToGraphics)
+    {
+        RecordIndirectDrawBarriers(CommandBuffer,
+                                   Resources,
+                                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                   VK_PIPELINE_STAGE_2_NONE,
+                                   VK_ACCESS_2_NONE,
+                                   GetComputeQueue().first,
+                                   GetGraphicsQueue().first);
+    }
+    else
+    {
+        RecordIndirectDrawBarriers(CommandBuffer,
+                                   Resources,
+                                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                   VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                                   VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                                   VK_QUEUE_FAMILY_IGNORED,
+                                   VK_QUEUE_FAMILY_IGNORED);
+    }
+
+    return true;
+}
+
+void RenderCore::AcquireIndirectDraws(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex)
+{
+    RecordIndirectDrawBarriers(CommandBuffer,
+                               g_IndirectDrawResources.at(FrameIndex),
+                               VK_PIPELINE_STAGE_2_NONE,
+                               VK_ACCESS_2_NONE,
+                               VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                               VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                               GetComputeQueue().first,
+                               GetGraphicsQueue().first);
+}
+
+void RenderCore::RecordIndirectDraws(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex)
+{
+    IndirectDrawResources const &Resources = g_IndirectDrawResources.at(FrameIndex);
+
+    if (Resources.NumDraws == 0U)
+    {
+        return;
+    }
+
+    PipelineDescriptorData const &PipelineDescriptors = GetPipelineDescriptorData();
+    VkPipelineLayout const &      PipelineLayout      = GetIndirectPipelineLayout();
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, GetIndirectPipeline());
+
+    std::array const BufferBindingInfos {
+            VkDescriptorBufferBindingInfoEXT
+            {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = PipelineDescriptors.SceneData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            },
+            VkDescriptorBufferBindingInfoEXT {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = PipelineDescriptors.IndirectTextureData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            }
+    };
+
+    vkCmdBindDescriptorBuffersEXT(CommandBuffer, static_cast<std::uint32_t>(std::size(BufferBindingInfos)), std::data(BufferBindingInfos));
+
+    constexpr std::array BufferIndices { 0U, 1U };
+
+    std::array const BufferOffsets {
+            FrameIndex * PipelineDescriptors.SceneData.LayoutSize,
+            FrameIndex * PipelineDescriptors.IndirectTextureData.LayoutSize
+    };
+
+    vkCmdSetDescriptorBufferOffsetsEXT(CommandBuffer,
+                                       VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                       PipelineLayout,
+                                       0U,
+                                       static_cast<std::uint32_t>(std::size(BufferIndices)),
+                                       std::data(BufferIndices),
+                                       std::data(BufferOffsets));
+
+    VkBuffer const &       GeometryBuffer = GetAllocationBuffer();
+    constexpr VkDeviceSize GeometryOffset = 0U;
+
+    vkCmdBindVertexBuffers(CommandBuffer, 0U, 1U, &GeometryBuffer, &GeometryOffset);
+    vkCmdBindIndexBuffer(CommandBuffer, GeometryBuffer, 0U, VK_INDEX_TYPE_UINT32);
+
+    // gl_DrawIDARB restarts on every call, so each batch pushes the draw data address of its first draw
+    std::uint32_t const MaxDrawsPerCall = GetPhysicalDeviceProperties().limits.maxDrawIndirectCount;
+
+    for (std::uint32_t FirstDraw = 0U; FirstDraw < Resources.NumDraws; FirstDraw += MaxDrawsPerCall)
+    {
+        VkDeviceAddress const DrawDataAddress = Resources.CullingConstants.DrawDataAddress + FirstDraw * sizeof(IndirectDrawData);
+        vkCmdPushConstants(CommandBuffer, PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0U, sizeof(VkDeviceAddress), &DrawDataAddress);
+
+        vkCmdDrawIndexedIndirectCount(CommandBuffer,
+                                      Resources.Commands.Buffer,
+                                      FirstDraw * sizeof(VkDrawIndexedIndirectCommand),
+                                      Resources.Count.Buffer,
+                                      0U,
+                                      std::min(MaxDrawsPerCall, Resources.NumDraws - FirstDraw),
+                                      sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+void RenderCore::ReleaseIndirectDrawResources()
+{
+    VmaAllocator const &Allocator = GetAllocator();
+
+    for (IndirectDrawResources &ResourcesIter : g_IndirectDrawResources)
+    {
+        ResourcesIter.DestroyResources(Allocator);
+    }
+}
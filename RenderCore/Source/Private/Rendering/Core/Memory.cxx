@@ -24,9 +24,12 @@ module;
 
 module RenderCore.Runtime.Memory;
 
+import RenderCore.Runtime.Command;
 import RenderCore.Runtime.Device;
 import RenderCore.Runtime.Instance;
-import RenderCore.Runtime.Command;
+import RenderCore.Runtime.ImmediateSubmit;
+import RenderCore.Runtime.Synchronization;
+import RenderCore.Runtime.Upload;
 import RenderCore.Types.UniformBufferObject;
 import RenderCore.Types.Vertex;
 
@@ -104,7 +107,7 @@ void RenderCore::CreateMemoryAllocator()
         // Buffer Pool
         constexpr VmaAllocationCreateInfo AllocationCreateInfo { .flags = g_MapMemoryFlag, .usage = g_ModelMemoryUsage };
 
-        constexpr VkBufferCreateInfo BufferCreateInfo { .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, .size = 0x100, .usage = g_ModelBufferUsage };
+        constexpr VkBufferCreateInfo BufferCreateInfo { .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, .size = 0x100, .usage = g_GeometryBufferUsage };
 
         std::uint32_t MemoryType;
         CheckVulkanResult(vmaFindMemoryTypeIndexForBufferInfo(g_Allocator, &BufferCreateInfo, &AllocationCreateInfo, &MemoryType));
@@ -120,6 +123,21 @@ void RenderCore::CreateMemoryAllocator()
         vmaSetPoolName(g_Allocator, g_BufferPool, "Buffer Pool");
     }
 
+    {
+        // Device Buffer Pool: no host access, only written by transfer commands
+        constexpr VmaAllocationCreateInfo AllocationCreateInfo { .usage = g_ModelMemoryUsage };
+
+        constexpr VkBufferCreateInfo BufferCreateInfo { .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, .size = 0x100, .usage = g_GeometryBufferUsage };
+
+        std::uint32_t MemoryType;
+        CheckVulkanResult(vmaFindMemoryTypeIndexForBufferInfo(g_Allocator, &BufferCreateInfo, &AllocationCreateInfo, &MemoryType));
+
+        VmaPoolCreateInfo const PoolCreateInfo { .memoryTypeIndex = MemoryType, .priority = 1.F };
+
+        CheckVulkanResult(vmaCreatePool(g_Allocator, &PoolCreateInfo, &g_DeviceBufferPool));
+        vmaSetPoolName(g_Allocator, g_DeviceBufferPool, "Device Buffer Pool");
+    }
+
     {
         // Image Pool
         constexpr VmaAllocationCreateInfo AllocationCreateInfo { .usage = g_TextureMemoryUsage };
@@ -141,16 +159,32 @@ void RenderCore::CreateMemoryAllocator()
         std::uint32_t MemoryType;
         CheckVulkanResult(vmaFindMemoryTypeIndexForImageInfo(g_Allocator, &ImageViewCreateInfo, &AllocationCreateInfo, &MemoryType));
 
-        VmaPoolCreateInfo const PoolCreateInfo { .memoryTypeIndex = MemoryType, .flags = VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT, .priority = 1.F };
+        // Not linear: evicted textures leave holes that restored ones have to be able to reuse
+        VmaPoolCreateInfo const PoolCreateInfo { .memoryTypeIndex = MemoryType, .priority = 1.F };
 
         CheckVulkanResult(vmaCreatePool(g_Allocator, &PoolCreateInfo, &g_ImagePool));
         vmaSetPoolName(g_Allocator, g_ImagePool, "Image Pool");
     }
 }
 
+void DestroyGeometryBlock()
+{
+    if (g_GeometryBlock != VK_NULL_HANDLE)
+    {
+        vmaClearVirtualBlock(g_GeometryBlock);
+        vmaDestroyVirtualBlock(g_GeometryBlock);
+        g_GeometryBlock = VK_NULL_HANDLE;
+    }
+
+    ++g_GeometryHeapGeneration;
+}
+
 void RenderCore::ReleaseMemoryResources()
 {
+    DestroyGeometryBlock();
+    g_GeometryObjects.clear();
     g_BufferAllocation.DestroyResources(g_Allocator);
+    g_UniformAllocation.DestroyResources(g_Allocator);
 
     for (auto &ImageIter : g_AllocatedImages | std::views::values)
     {
@@ -167,6 +201,9 @@ void RenderCore::ReleaseMemoryResources()
     vmaDestroyPool(g_Allocator, g_BufferPool);
     g_BufferPool = VK_NULL_HANDLE;
 
+    vmaDestroyPool(g_Allocator, g_DeviceBufferPool);
+    g_DeviceBufferPool = VK_NULL_HANDLE;
+
     vmaDestroyPool(g_Allocator, g_ImagePool);
     g_ImagePool = VK_NULL_HANDLE;
 
@@ -181,14 +218,46 @@ VmaAllocationInfo RenderCore::CreateBuffer(VkDeviceSize const &        Size,
                                            VmaAllocation &             Allocation)
 {
     bool const IsStagingBuffer = Identifier.starts_with("STAGING_");
+    bool const IsDeviceBuffer  = Identifier.starts_with("DEVICE_");
 
     VmaAllocationCreateInfo AllocationCreateInfo {
             .flags = 0U,
             .usage = g_ModelMemoryUsage,
-            .pool = IsStagingBuffer ? g_StagingBufferPool : g_BufferPool
+            .pool = IsStagingBuffer ? g_StagingBufferPool : IsDeviceBuffer ? g_DeviceBufferPool : g_BufferPool
     };
 
-    if (Usage & VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT)
+    VkBufferCreateInfo BufferCreateInfo { .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, .size = Size, .usage = Usage };
+
+    // Device buffers are filled from the transfer queue and read by the graphics one; sharing them avoids an ownership transfer per upload
+    std::array const QueueFamilyIndices {
+            static_cast<std::uint32_t>(GetGraphicsQueue().first),
+            static_cast<std::uint32_t>(GetTransferQueue().first)
+    };
+
+    // Uniforms are also read by the culling dispatch, which runs on the compute family when the async queue exists
+    std::array const ComputeQueueFamilyIndices {
+            static_cast<std::uint32_t>(GetGraphicsQueue().first),
+            static_cast<std::uint32_t>(GetComputeQueue().first)
+    };
+
+    if (IsDeviceBuffer)
+    {
+        if (HasDedicatedTransferQueue())
+        {
+            BufferCreateInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+            BufferCreateInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(std::size(QueueFamilyIndices));
+            BufferCreateInfo.pQueueFamilyIndices   = std::data(QueueFamilyIndices);
+        }
+    }
+    else if (Usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT && HasAsyncComputeQueue())
+    {
+        AllocationCreateInfo.flags |= g_MapMemoryFlag;
+
+        BufferCreateInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+        BufferCreateInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(std::size(ComputeQueueFamilyIndices));
+        BufferCreateInfo.pQueueFamilyIndices   = std::data(ComputeQueueFamilyIndices);
+    }
+    else if (Usage & VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT)
     {
         AllocationCreateInfo.pool = g_DescriptorBufferPool;
         AllocationCreateInfo.flags |= g_MapMemoryFlag;
@@ -203,8 +272,6 @@ VmaAllocationInfo RenderCore::CreateBuffer(VkDeviceSize const &        Size,
         }
     }
 
-    VkBufferCreateInfo const BufferCreateInfo { .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, .size = Size, .usage = Usage };
-
     VmaAllocator const &Allocator = GetAllocator();
 
     VmaAllocationInfo MemoryAllocationInfo;
@@ -238,14 +305,15 @@ void RenderCore::CreateImage(VkFormat const &            ImageFormat,
                              VmaMemoryUsage const        MemoryUsage,
                              strzilla::string_view const Identifier,
                              VkImage &                   Image,
-                             VmaAllocation &             Allocation)
+                             VmaAllocation &             Allocation,
+                             std::uint32_t const         MipLevels)
 {
     VkImageCreateInfo const ImageViewCreateInfo {
             .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
             .imageType = VK_IMAGE_TYPE_2D,
             .format = ImageFormat,
             .extent = { .width = Extent.width, .height = Extent.height, .depth = 1U },
-            .mipLevels = 1U,
+            .mipLevels = MipLevels,
             .arrayLayers = 1U,
             .samples = g_MSAASamples,
             .tiling = Tiling,
@@ -264,14 +332,25 @@ void RenderCore::CreateImage(VkFormat const &            ImageFormat,
     vmaSetAllocationName(Allocator, Allocation, std::data(std::format("Image: {}", std::data(Identifier))));
 }
 
-void RenderCore::CreateImageView(VkImage const &Image, VkFormat const &Format, VkImageAspectFlags const &AspectFlags, VkImageView &ImageView)
+void RenderCore::CreateImageView(VkImage const &           Image,
+                                 VkFormat const &          Format,
+                                 VkImageAspectFlags const &AspectFlags,
+                                 VkImageView &             ImageView,
+                                 std::uint32_t const       BaseMipLevel,
+                                 std::uint32_t const       LevelCount)
 {
     VkImageViewCreateInfo const ImageViewCreateInfo {
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
             .image = Image,
             .viewType = VK_IMAGE_VIEW_TYPE_2D,
             .format = Format,
-            .subresourceRange = { .aspectMask = AspectFlags, .baseMipLevel = 0U, .levelCount = 1U, .baseArrayLayer = 0U, .layerCount = 1U }
+            .subresourceRange = {
+                    .aspectMask = AspectFlags,
+                    .baseMipLevel = BaseMipLevel,
+                    .levelCount = LevelCount,
+                    .baseArrayLayer = 0U,
+                    .layerCount = 1U
+            }
     };
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
@@ -297,121 +376,589 @@ void RenderCore::CopyBufferToImage(VkCommandBuffer const &CommandBuffer, VkBuffe
     vkCmdCopyBufferToImage(CommandBuffer, Source, Destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1U, &BufferImageCopy);
 }
 
-std::tuple<std::uint32_t, VkBuffer, VmaAllocation> RenderCore::AllocateTexture(VkCommandBuffer const &CommandBuffer,
-                                                                               unsigned char const *  Data,
-                                                                               std::uint32_t const    Width,
-                                                                               std::uint32_t const    Height,
-                                                                               VkFormat const         ImageFormat,
-                                                                               VkDeviceSize const     AllocationSize)
+constexpr VkImageUsageFlags g_TextureUsage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+// Full chain down to 1x1, or a single level when the format can't be blitted with linear filtering
+std::uint32_t GetTextureMipLevels(VkFormat const Format, std::uint32_t const Width, std::uint32_t const Height)
+{
+    if (!g_GenerateTextureMipmaps)
+    {
+        return 1U;
+    }
+
+    constexpr VkFormatFeatureFlags RequiredFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                      VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    VkFormatProperties FormatProperties;
+    vkGetPhysicalDeviceFormatProperties(GetPhysicalDevice(), Format, &FormatProperties);
+
+    if (!HasFlag<VkFormatFeatureFlags>(FormatProperties.optimalTilingFeatures, RequiredFeatures))
+    {
+        return 1U;
+    }
+
+    return static_cast<std::uint32_t>(std::bit_width(std::max(Width, Height)));
+}
+
+std::uint32_t RegisterImageAllocation(ImageAllocation &&Allocation)
 {
     if (std::empty(g_AllocatedImages))
     {
         g_ImageAllocationIDCounter.fetch_sub(g_ImageAllocationIDCounter.load());
     }
 
-    std::pair<VkBuffer, VmaAllocation> Output;
-    VmaAllocationInfo StagingInfo = CreateBuffer(AllocationSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, "STAGING_TEXTURE", Output.first, Output.second);
+    std::uint32_t const BufferID = g_ImageAllocationIDCounter.fetch_add(1U);
+    g_AllocatedImages.emplace(BufferID, std::move(Allocation));
 
-    VmaAllocator const &Allocator = GetAllocator();
+    if (g_ImageAllocationCounter.contains(BufferID))
+    {
+        g_ImageAllocationCounter.at(BufferID) += 1U;
+    }
+    else
+    {
+        g_ImageAllocationCounter.emplace(BufferID, 1U);
+    }
 
-    CheckVulkanResult(vmaMapMemory(Allocator, Output.second, &StagingInfo.pMappedData));
-    std::memcpy(StagingInfo.pMappedData, Data, AllocationSize);
+    return BufferID;
+}
 
-    ImageAllocation NewAllocation { .Extent = { .width = Width, .height = Height }, .Format = ImageFormat };
+std::uint32_t RenderCore::AllocateTexture(VkCommandBuffer const &CommandBuffer,
+                                          unsigned char const *  Data,
+                                          std::uint32_t const    Width,
+                                          std::uint32_t const    Height,
+                                          VkFormat const         ImageFormat,
+                                          VkDeviceSize const     AllocationSize)
+{
+    ImageAllocation NewAllocation {
+            .Extent = { .width = Width, .height = Height },
+            .Format = ImageFormat,
+            .MipLevels = GetTextureMipLevels(ImageFormat, Width, Height)
+    };
 
     CreateImage(ImageFormat,
                 NewAllocation.Extent,
                 g_ImageTiling,
-                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                g_TextureUsage,
                 g_TextureMemoryUsage,
                 "TEXTURE",
                 NewAllocation.Image,
-                NewAllocation.Allocation);
+                NewAllocation.Allocation,
+                NewAllocation.MipLevels);
 
-    RequestImageLayoutTransition<g_UndefinedLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, g_ImageAspect>(CommandBuffer,
-        NewAllocation.Image,
-        NewAllocation.Format);
+    QueueImageUpload(CommandBuffer, NewAllocation.Image, NewAllocation.Format, NewAllocation.Extent, Data, AllocationSize);
+    QueueMipGeneration(CommandBuffer, NewAllocation.Image, NewAllocation.Format, NewAllocation.Extent, 0U, NewAllocation.MipLevels);
 
-    CopyBufferToImage(CommandBuffer, Output.first, NewAllocation.Image, NewAllocation.Extent);
+    CreateImageView(NewAllocation.Image, NewAllocation.Format, g_ImageAspect, NewAllocation.View, 0U, NewAllocation.MipLevels);
 
-    RequestImageLayoutTransition<VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, g_ReadLayout, g_ImageAspect>(CommandBuffer,
-                                                                                                        NewAllocation.Image,
-                                                                                                        NewAllocation.Format);
+    return RegisterImageAllocation(std::move(NewAllocation));
+}
 
-    CreateImageView(NewAllocation.Image, NewAllocation.Format, g_ImageAspect, NewAllocation.View);
-    vmaUnmapMemory(Allocator, Output.second);
+std::uint32_t RenderCore::AllocateStreamedTexture(std::uint32_t const Width,
+                                                  std::uint32_t const Height,
+                                                  VkFormat const      ImageFormat,
+                                                  std::uint32_t const MipLevels)
+{
+    ImageAllocation NewAllocation {
+            .Extent = { .width = Width, .height = Height },
+            .Format = ImageFormat,
+            .MipLevels = MipLevels,
+            .BaseMipLevel = MipLevels
+    };
 
-    std::uint32_t const BufferID = g_ImageAllocationIDCounter.fetch_add(1U);
-    g_AllocatedImages.emplace(BufferID, std::move(NewAllocation));
+    CreateImage(ImageFormat,
+                NewAllocation.Extent,
+                g_ImageTiling,
+                g_TextureUsage,
+                g_TextureMemoryUsage,
+                "STREAMED_TEXTURE",
+                NewAllocation.Image,
+                NewAllocation.Allocation,
+                MipLevels);
 
-    if (g_ImageAllocationCounter.contains(BufferID))
+    return RegisterImageAllocation(std::move(NewAllocation));
+}
+
+void RenderCore::QueueImageLevelUpload(VkCommandBuffer const &CommandBuffer,
+                                       std::uint32_t const    ID,
+                                       std::uint32_t const    Level,
+                                       void const *const      Data,
+                                       VkDeviceSize const     Size)
+{
+    ImageAllocation const &Allocation = g_AllocatedImages.at(ID);
+    if (!Allocation.IsValid() || Level >= Allocation.MipLevels)
     {
-        g_ImageAllocationCounter.at(BufferID) += 1U;
+        return;
+    }
+
+    QueueImageUpload(CommandBuffer, Allocation.Image, Allocation.Format, Allocation.GetLevelExtent(Level), Data, Size, Level);
+}
+
+void RenderCore::QueueImageMipGeneration(VkCommandBuffer const &CommandBuffer, std::uint32_t const ID, std::uint32_t const SourceLevel)
+{
+    ImageAllocation const &Allocation = g_AllocatedImages.at(ID);
+    if (!Allocation.IsValid())
+    {
+        return;
+    }
+
+    QueueMipGeneration(CommandBuffer, Allocation.Image, Allocation.Format, Allocation.Extent, SourceLevel, Allocation.MipLevels);
+}
+
+void RenderCore::SetImageAllocationBaseLevel(std::uint32_t const ID, std::uint32_t const Level)
+{
+    ImageAllocation &Allocation = g_AllocatedImages.at(ID);
+    if (!Allocation.IsValid() || Level >= Allocation.MipLevels || (Allocation.View != VK_NULL_HANDLE && Allocation.BaseMipLevel == Level))
+    {
+        return;
+    }
+
+    if (Allocation.View != VK_NULL_HANDLE)
+    {
+        RetireResource([View = Allocation.View]
+        {
+            vkDestroyImageView(GetLogicalDevice(), View, nullptr);
+        });
+    }
+
+    CreateImageView(Allocation.Image, Allocation.Format, g_ImageAspect, Allocation.View, Level, Allocation.MipLevels - Level);
+    Allocation.BaseMipLevel = Level;
+}
+
+VkDeviceSize RenderCore::GetImageAllocationSize(std::uint32_t const ID)
+{
+    ImageAllocation const &Allocation = g_AllocatedImages.at(ID);
+    if (!Allocation.IsValid())
+    {
+        return 0U;
+    }
+
+    VmaAllocationInfo AllocationInfo;
+    vmaGetAllocationInfo(g_Allocator, Allocation.Allocation, &AllocationInfo);
+
+    return AllocationInfo.size;
+}
+
+void RenderCore::EvictImageAllocation(std::uint32_t const ID)
+{
+    ImageAllocation &Allocation = g_AllocatedImages.at(ID);
+    if (!Allocation.IsValid())
+    {
+        return;
+    }
+
+    RetireResource([Retired = Allocation]() mutable
+    {
+        Retired.DestroyResources(GetAllocator());
+    });
+
+    Allocation.Image      = VK_NULL_HANDLE;
+    Allocation.View       = VK_NULL_HANDLE;
+    Allocation.Allocation = VK_NULL_HANDLE;
+}
+
+void RenderCore::RecreateImageAllocation(std::uint32_t const ID)
+{
+    ImageAllocation &Allocation = g_AllocatedImages.at(ID);
+    if (Allocation.IsValid())
+    {
+        return;
+    }
+
+    CreateImage(Allocation.Format,
+                Allocation.Extent,
+                g_ImageTiling,
+                g_TextureUsage,
+                g_TextureMemoryUsage,
+                "TEXTURE",
+                Allocation.Image,
+                Allocation.Allocation,
+                Allocation.MipLevels);
+
+    Allocation.BaseMipLevel = Allocation.MipLevels;
+}
+
+constexpr VkDeviceSize AlignToVertexStride(VkDeviceSize const Offset)
+{
+    return (Offset + sizeof(Vertex) - 1U) / sizeof(Vertex) * sizeof(Vertex);
+}
+
+VkDeviceSize RenderCore::WriteObjectGeometry(std::shared_ptr<Object> const &Object, void *const Destination, VkDeviceSize Offset)
+{
+    auto const &Mesh       = Object->GetMesh();
+    auto const  MappedData = static_cast<char *>(Destination);
+
+    VkDeviceSize const VertexBufferSize = std::size(Mesh->GetVertices()) * sizeof(Vertex);
+    VkDeviceSize const IndexBufferSize  = std::size(Mesh->GetIndices()) * sizeof(std::uint32_t);
+
+    Offset = AlignToVertexStride(Offset);
+
+    Mesh->SetVertexOffset(Offset);
+    std::memcpy(MappedData + Offset, std::data(Mesh->GetVertices()), VertexBufferSize);
+    Offset += VertexBufferSize;
+
+    Mesh->SetIndexOffset(Offset);
+    std::memcpy(MappedData + Offset, std::data(Mesh->GetIndices()), IndexBufferSize);
+    Offset += IndexBufferSize;
+
+    return AlignToVertexStride(Offset);
+}
+
+VkDeviceSize RenderCore::GetObjectGeometrySize(std::shared_ptr<Object> const &Object)
+{
+    auto const &Mesh = Object->GetMesh();
+    return AlignToVertexStride(std::size(Mesh->GetVertices()) * sizeof(Vertex) + std::size(Mesh->GetIndices()) * sizeof(std::uint32_t));
+}
+
+void LogBufferPlacement(strzilla::string_view const Name, BufferAllocation const &Allocation)
+{
+    VkMemoryPropertyFlags MemoryProperties { 0U };
+    vmaGetAllocationMemoryProperties(g_Allocator, Allocation.Allocation, &MemoryProperties);
+
+    BOOST_LOG_TRIVIAL(info) << "[" << __func__ << "]: " << std::data(Name) << " buffer of " << Allocation.Size << " bytes, device local: "
+                            << HasFlag<VkMemoryPropertyFlags>(MemoryProperties, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) << ", host visible: "
+                            << HasFlag<VkMemoryPropertyFlags>(MemoryProperties, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+}
+
+void CreateGeometryHeap(VkDeviceSize const Size)
+{
+    RetireBufferAllocation(g_BufferAllocation);
+    DestroyGeometryBlock();
+    InvalidateCachedSceneCommands();
+
+    // The block counts in vertices, so every range it hands out starts on a vertex boundary
+    VkDeviceSize const NumVertexSlots = std::max<VkDeviceSize>(Size / sizeof(Vertex), 1U);
+
+    g_BufferAllocation.Size = NumVertexSlots * sizeof(Vertex);
+
+    if (g_GeometryPlacement == GeometryPlacement::STAGED)
+    {
+        CreateBuffer(g_BufferAllocation.Size,
+                     g_GeometryBufferUsage,
+                     "DEVICE_MODEL_GEOMETRY_BUFFER",
+                     g_BufferAllocation.Buffer,
+                     g_BufferAllocation.Allocation);
     }
     else
     {
-        g_ImageAllocationCounter.emplace(BufferID, 1U);
+        CreateBuffer(g_BufferAllocation.Size, g_GeometryBufferUsage, "MODEL_GEOMETRY_BUFFER", g_BufferAllocation.Buffer, g_BufferAllocation.Allocation);
+        CheckVulkanResult(vmaMapMemory(GetAllocator(), g_BufferAllocation.Allocation, &g_BufferAllocation.MappedData));
     }
 
-    return { BufferID, Output.first, Output.second };
+    LogBufferPlacement(g_GeometryPlacement == GeometryPlacement::STAGED ? "Staged geometry" : "Mapped geometry", g_BufferAllocation);
+
+    VmaVirtualBlockCreateInfo const BlockCreateInfo { .size = NumVertexSlots };
+    CheckVulkanResult(vmaCreateVirtualBlock(&BlockCreateInfo, &g_GeometryBlock));
 }
 
-void RenderCore::AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> const &Objects)
+bool ReserveObjectGeometry(std::shared_ptr<Object> const &Object, VkDeviceSize &Offset)
+{
+    VmaVirtualAllocationCreateInfo const AllocationCreateInfo { .size = GetObjectGeometrySize(Object) / sizeof(Vertex) };
+
+    VmaVirtualAllocation Allocation { VK_NULL_HANDLE };
+    VkDeviceSize         FirstVertexSlot { 0U };
+
+    if (vmaVirtualAllocate(g_GeometryBlock, &AllocationCreateInfo, &Allocation, &FirstVertexSlot) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    Object->GetMesh()->SetGeometryAllocation(Allocation);
+    Offset = FirstVertexSlot * sizeof(Vertex);
+
+    return true;
+}
+
+void FreeObjectGeometry(std::shared_ptr<Object> const &Object)
 {
-    if (g_BufferAllocation.IsValid())
+    if (auto const &Mesh = Object->GetMesh();
+        Mesh && Mesh->GetGeometryAllocation() != VK_NULL_HANDLE)
     {
-        g_BufferAllocation.DestroyResources(g_Allocator);
+        vmaVirtualFree(g_GeometryBlock, Mesh->GetGeometryAllocation());
+        Mesh->SetGeometryAllocation(VK_NULL_HANDLE);
     }
+}
 
-    std::vector<Vertex>        Vertices;
-    std::vector<std::uint32_t> Indices;
+bool HasObjectGeometry(std::shared_ptr<Object> const &Object)
+{
+    return Object->GetMesh() && GetObjectGeometrySize(Object) > 0U;
+}
 
+void RenderCore::RebuildGeometryHeap(VkDeviceSize const AdditionalSize)
+{
+    // Staged copies still in flight target the current buffer
+    FlushUploads();
+
+    BufferAllocation OldAllocation = std::exchange(g_BufferAllocation, {});
+
+    VkDeviceSize LiveSize = 0U;
+    for (auto const &ObjectIter : g_GeometryObjects)
+    {
+        LiveSize += GetObjectGeometrySize(ObjectIter);
+    }
+
+    CreateGeometryHeap(std::max(LiveSize + AdditionalSize, OldAllocation.Size) * 2U);
+
+    // Live ranges move on the GPU, so the staged placement never has to keep a CPU copy of the meshes around
+    std::vector<VkBufferCopy> Regions;
+    Regions.reserve(std::size(g_GeometryObjects));
+
+    for (auto const &ObjectIter : g_GeometryObjects)
+    {
+        auto const &       Mesh            = ObjectIter->GetMesh();
+        VkDeviceSize const OldVertexOffset = Mesh->GetVertexOffset();
+        VkDeviceSize       NewOffset       = 0U;
+
+        if (!ReserveObjectGeometry(ObjectIter, NewOffset))
+        {
+            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to re-pack the geometry heap";
+            break;
+        }
+
+        Mesh->SetIndexOffset(NewOffset + Mesh->GetIndexOffset() - OldVertexOffset);
+        Mesh->SetVertexOffset(NewOffset);
+
+        Regions.push_back(VkBufferCopy { .srcOffset = OldVertexOffset, .dstOffset = NewOffset, .size = GetObjectGeometrySize(ObjectIter) });
+    }
+
+    if (!std::empty(Regions) && OldAllocation.IsValid())
+    {
+        auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
+
+        ImmediateSubmit        Commands { FamilyIndex, Queue };
+        VkCommandBuffer const &CommandBuffer = Commands.GetCommandBuffer();
+
+        vkCmdCopyBuffer(CommandBuffer, OldAllocation.Buffer, g_BufferAllocation.Buffer, static_cast<std::uint32_t>(std::size(Regions)), std::data(Regions));
+
+        VkBufferMemoryBarrier2 const BufferBarrier {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
+                .dstAccessMask = VK_ACCESS_2_INDEX_READ_BIT | VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = g_BufferAllocation.Buffer,
+                .offset = 0U,
+                .size = VK_WHOLE_SIZE
+        };
+
+        VkDependencyInfo const DependencyInfo {
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount = 1U,
+                .pBufferMemoryBarriers = &BufferBarrier
+        };
+
+        vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+        Commands.Submit();
+    }
+
+    RetireBufferAllocation(OldAllocation);
+}
+
+void RenderCore::AllocateModelsGeometry(std::vector<std::shared_ptr<Object>> const &Objects, VkCommandBuffer const &UploadCommandBuffer)
+{
+    std::vector<std::pair<std::shared_ptr<Object>, VkDeviceSize>> Placements;
+    Placements.reserve(std::size(Objects));
+
+    VkDeviceSize RequiredSize = 0U;
     for (auto const &ObjectIter : Objects)
     {
-        auto const &Mesh = ObjectIter->GetMesh();
+        if (HasObjectGeometry(ObjectIter))
+        {
+            Placements.emplace_back(ObjectIter, 0U);
+            RequiredSize += GetObjectGeometrySize(ObjectIter);
+        }
+    }
+
+    if (std::empty(Placements))
+    {
+        return;
+    }
 
-        Mesh->SetVertexOffset(std::size(Vertices) * sizeof(Vertex));
-        Mesh->SetIndexOffset(std::size(Indices) * sizeof(std::uint32_t));
+    if (!g_BufferAllocation.IsValid())
+    {
+        CreateGeometryHeap(RequiredSize * 2U);
+    }
 
-        Vertices.insert(std::end(Vertices), std::begin(Mesh->GetVertices()), std::end(Mesh->GetVertices()));
-        Indices.insert(std::end(Indices), std::begin(Mesh->GetIndices()), std::end(Mesh->GetIndices()));
+    // Meshes that already live in the heap keep their ranges; only when the new ones don't fit is everything re-packed into a larger heap
+    auto const ReservePlacements = [&Placements]
+    {
+        for (auto &[ObjectIter, Offset] : Placements)
+        {
+            if (!ReserveObjectGeometry(ObjectIter, Offset))
+            {
+                for (auto const &ReservedIter : Placements | std::views::keys)
+                {
+                    FreeObjectGeometry(ReservedIter);
+                }
+
+                return false;
+            }
+        }
 
-        ObjectIter->MarkAsRenderDirty();
+        return true;
+    };
+
+    if (!ReservePlacements())
+    {
+        RebuildGeometryHeap(RequiredSize);
+
+        if (!ReservePlacements())
+        {
+            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to allocate " << RequiredSize << " bytes of geometry";
+            return;
+        }
     }
 
-    VkDeviceSize const VertexBufferSize = std::size(Vertices) * sizeof(Vertex);
-    VkDeviceSize const IndexBufferSize  = std::size(Indices) * sizeof(std::uint32_t);
-    VkDeviceSize       UniformOffset    = VertexBufferSize + IndexBufferSize;
+    if (g_GeometryPlacement == GeometryPlacement::STAGED)
+    {
+        for (auto const &[ObjectIter, Offset] : Placements)
+        {
+            auto const &       Mesh             = ObjectIter->GetMesh();
+            VkDeviceSize const VertexBufferSize = std::size(Mesh->GetVertices()) * sizeof(Vertex);
+            VkDeviceSize const IndexBufferSize  = std::size(Mesh->GetIndices()) * sizeof(std::uint32_t);
 
-    if (VkDeviceSize const MinAlignment = GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
-        MinAlignment > 0U)
+            Mesh->SetVertexOffset(Offset);
+            Mesh->SetIndexOffset(Offset + VertexBufferSize);
+
+            QueueBufferUpload(UploadCommandBuffer, g_BufferAllocation.Buffer, Offset, std::data(Mesh->GetVertices()), VertexBufferSize);
+            QueueBufferUpload(UploadCommandBuffer, g_BufferAllocation.Buffer, Offset + VertexBufferSize, std::data(Mesh->GetIndices()), IndexBufferSize);
+        }
+    }
+    else
     {
-        UniformOffset = UniformOffset + MinAlignment - 1U & ~(MinAlignment - 1U);
+        VkDeviceSize WrittenBegin = std::numeric_limits<VkDeviceSize>::max();
+        VkDeviceSize WrittenEnd   = 0U;
+
+        for (auto const &[ObjectIter, Offset] : Placements)
+        {
+            WrittenBegin = std::min(WrittenBegin, Offset);
+            WrittenEnd   = std::max(WrittenEnd, WriteObjectGeometry(ObjectIter, g_BufferAllocation.MappedData, Offset));
+        }
+
+        CheckVulkanResult(vmaFlushAllocation(GetAllocator(), g_BufferAllocation.Allocation, WrittenBegin, WrittenEnd - WrittenBegin));
     }
 
-    VmaAllocator const &Allocator  = GetAllocator();
-    VkDeviceSize const  BufferSize = UniformOffset + sizeof(ModelUniformData) * std::size(Objects);
+    for (auto const &ObjectIter : Placements | std::views::keys)
+    {
+        g_GeometryObjects.push_back(ObjectIter);
+    }
+}
+
+void RenderCore::AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> const &Objects)
+{
+    if (std::empty(Objects))
+    {
+        return;
+    }
 
-    CreateBuffer(BufferSize, g_ModelBufferUsage, "MODEL_UNIFIED_BUFFER", g_BufferAllocation.Buffer, g_BufferAllocation.Allocation);
+    auto const &SceneObjects = GetObjects();
 
-    CheckVulkanResult(vmaMapMemory(Allocator, g_BufferAllocation.Allocation, &g_BufferAllocation.MappedData));
-    std::memcpy(g_BufferAllocation.MappedData, std::data(Vertices), VertexBufferSize);
-    std::memcpy(static_cast<char *>(g_BufferAllocation.MappedData) + VertexBufferSize, std::data(Indices), IndexBufferSize);
+    if (g_ModelUniformStride == 0U)
+    {
+        g_ModelUniformStride = sizeof(ModelUniformData);
 
-    CheckVulkanResult(vmaFlushAllocation(Allocator, g_BufferAllocation.Allocation, VertexBufferSize, IndexBufferSize));
-    vmaUnmapMemory(Allocator, g_BufferAllocation.Allocation);
+        if (VkDeviceSize const MinAlignment = GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
+            MinAlignment > 0U)
+        {
+            g_ModelUniformStride = g_ModelUniformStride + MinAlignment - 1U & ~(MinAlignment - 1U);
+        }
+    }
 
     for (auto const &ObjectIter : Objects)
     {
-        auto const &Mesh = ObjectIter->GetMesh();
+        if (!std::empty(g_FreeUniformSlots))
+        {
+            ObjectIter->SetBufferIndex(g_FreeUniformSlots.back());
+            g_FreeUniformSlots.pop_back();
+        }
+        else
+        {
+            ObjectIter->SetBufferIndex(g_NextUniformSlot++);
+        }
+    }
 
-        Mesh->SetIndexOffset(Mesh->GetIndexOffset() + VertexBufferSize);
+    VkDeviceSize const ObjectUniformSize = g_ModelUniformStride * g_MaxFramesInFlight;
 
-        ObjectIter->SetUniformOffset(UniformOffset + sizeof(ModelUniformData) * std::distance(std::data(Objects), &ObjectIter));
+    auto const SetupObjectUniform = [ObjectUniformSize](std::shared_ptr<Object> const &ObjectIter)
+    {
+        ObjectIter->SetUniformOffset(static_cast<std::uint32_t>(ObjectIter->GetBufferIndex() * ObjectUniformSize));
         ObjectIter->SetupUniformDescriptor();
+        ObjectIter->InvalidateUniformFrames();
+    };
+
+    if (!g_UniformAllocation.IsValid() || g_NextUniformSlot > g_UniformSlotCapacity)
+    {
+        RetireBufferAllocation(g_UniformAllocation);
+
+        g_UniformSlotCapacity = std::max(g_NextUniformSlot, g_UniformSlotCapacity * 2U);
+        CreateUniformBuffers(g_UniformAllocation, ObjectUniformSize * g_UniformSlotCapacity, "MODEL_UNIFORM_BUFFER");
+        LogBufferPlacement("Model uniform", g_UniformAllocation);
+        ++g_ModelsBufferGeneration;
+        InvalidateCachedSceneCommands();
+
+        std::for_each(std::execution::unseq, std::cbegin(SceneObjects), std::cend(SceneObjects), SetupObjectUniform);
+    }
+    else
+    {
+        std::for_each(std::execution::unseq, std::cbegin(Objects), std::cend(Objects), SetupObjectUniform);
     }
 }
 
+void RenderCore::ReleaseModelsBuffers(std::shared_ptr<Object> &&Object)
+{
+    // Leaves re-packs right away, but its range only goes back to the heap once no frame in flight draws from it, unless the heap was
+    // rebuilt in the meantime. Uniform growth keeps slot indices, so only a reset drops the slot
+    std::erase(g_GeometryObjects, Object);
+
+    RetireResource([Slot               = Object->GetBufferIndex(),
+                    SlotEpoch          = g_UniformSlotEpoch,
+                    GeometryGeneration = g_GeometryHeapGeneration,
+                    Object             = std::move(Object)]
+    {
+        if (SlotEpoch == g_UniformSlotEpoch)
+        {
+            g_FreeUniformSlots.push_back(Slot);
+        }
+
+        if (GeometryGeneration == g_GeometryHeapGeneration)
+        {
+            FreeObjectGeometry(Object);
+        }
+    });
+}
+
+void RenderCore::ResetModelsBuffers()
+{
+    RetireBufferAllocation(g_BufferAllocation);
+    RetireBufferAllocation(g_UniformAllocation);
+    DestroyGeometryBlock();
+    g_GeometryObjects.clear();
+
+    g_UniformSlotCapacity = 0U;
+    g_NextUniformSlot     = 0U;
+    g_FreeUniformSlots.clear();
+    ++g_ModelsBufferGeneration;
+    ++g_UniformSlotEpoch;
+    InvalidateCachedSceneCommands();
+}
+
+void RenderCore::RetireBufferAllocation(BufferAllocation &Allocation)
+{
+    if (!Allocation.IsValid())
+    {
+        Allocation = {};
+        return;
+    }
+
+    RetireResource([Allocation]() mutable
+    {
+        Allocation.DestroyResources(GetAllocator());
+    });
+
+    Allocation = {};
+}
+
 void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view const Path, VkExtent2D const &Extent)
 {
     VkBuffer            Buffer;
@@ -422,10 +969,10 @@ void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view con
 
     auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
 
-    VkCommandPool                CommandPool { VK_NULL_HANDLE };
-    std::vector<VkCommandBuffer> CommandBuffer { VK_NULL_HANDLE };
-    InitializeSingleCommandQueue(CommandPool, CommandBuffer, FamilyIndex);
     {
+        ImmediateSubmit        Commands { FamilyIndex, Queue };
+        VkCommandBuffer const &CommandBuffer = Commands.GetCommandBuffer();
+
         VkImageSubresource SubResource { .aspectMask = g_ImageAspect, .mipLevel = 0, .arrayLayer = 0 };
 
         VkDevice const &LogicalDevice = GetLogicalDevice();
@@ -487,13 +1034,13 @@ void RenderCore::SaveImageToFile(VkImage const &Image, strzilla::string_view con
                 .pImageMemoryBarriers = &PreCopyBarrier
         };
 
-        vkCmdPipelineBarrier2(CommandBuffer.back(), &DependencyInfo);
-        vkCmdCopyImageToBuffer(CommandBuffer.back(), Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Buffer, 1U, &Region);
+        vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+        vkCmdCopyImageToBuffer(CommandBuffer, Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Buffer, 1U, &Region);
 
         DependencyInfo.pImageMemoryBarriers = &PostCopyBarrier;
-        vkCmdPipelineBarrier2(CommandBuffer.back(), &DependencyInfo);
+        vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+        Commands.Submit();
     }
-    FinishSingleCommandQueue(Queue, CommandPool, CommandBuffer);
 
     void *ImageData;
     vmaMapMemory(g_Allocator, Allocation, &ImageData);
@@ -536,3 +1083,29 @@ strzilla::string RenderCore::GetMemoryAllocatorStats(bool const DetailedMap)
 
     return Output;
 }
+
+DeviceMemoryUsage RenderCore::GetDeviceMemoryUsage()
+{
+    VkPhysicalDeviceMemoryProperties const *MemoryProperties = nullptr;
+    vmaGetMemoryProperties(g_Allocator, &MemoryProperties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> Budgets {};
+    vmaGetHeapBudgets(g_Allocator, std::data(Budgets));
+
+    DeviceMemoryUsage Output {};
+
+    for (std::uint32_t HeapIndex = 0U; HeapIndex < MemoryProperties->memoryHeapCount; ++HeapIndex)
+    {
+        if ((MemoryProperties->memoryHeaps[HeapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0U)
+        {
+            continue;
+        }
+
+        VmaBudget const &Budget = Budgets.at(HeapIndex);
+        Output.AllocatedBytes += Budget.statistics.allocationBytes;
+        Output.UsageBytes += Budget.usage;
+        Output.BudgetBytes += Budget.budget;
+    }
+
+    return Output;
+}
@@ -10,17 +10,10 @@ import RenderCore.Runtime.Memory;
 
 using namespace RenderCore;
 
-void RenderCore::CreateOffscreenResources(SurfaceProperties const &SurfaceProperties)
+void RenderCore::CreateOffscreenResources(SurfaceProperties const &SurfaceProperties, std::uint32_t const NumImages)
 {
-    VmaAllocator const &Allocator = GetAllocator();
-
-    std::for_each(std::execution::unseq,
-                  std::begin(g_OffscreenImages),
-                  std::end(g_OffscreenImages),
-                  [&](ImageAllocation &ImageIter)
-                  {
-                      ImageIter.DestroyResources(Allocator);
-                  });
+    DestroyOffscreenImages();
+    g_OffscreenImages.resize(NumImages);
 
     constexpr VkImageUsageFlags UsageFlags = VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
@@ -56,4 +49,6 @@ void RenderCore::DestroyOffscreenImages()
                   {
                       ImageIter.DestroyResources(Allocator);
                   });
+
+    g_OffscreenImages.clear();
 }
@@ -6,7 +6,9 @@ module;
 
 module RenderCore.Runtime.Pipeline;
 
+import RenderCore.Runtime.Command;
 import RenderCore.Runtime.Device;
+import RenderCore.Runtime.IndirectDraw;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.ShaderCompiler;
 import RenderCore.Runtime.SwapChain;
@@ -107,7 +109,7 @@ void PipelineData::DestroyResources(VkDevice const &LogicalDevice, bool const In
 
 void PipelineData::CreateMainCache(VkDevice const &LogicalDevice)
 {
-    if (g_PipelineData.PipelineCache == VK_NULL_HANDLE)
+    if (PipelineCache == VK_NULL_HANDLE)
     {
         CheckVulkanResult(vkCreatePipelineCache(LogicalDevice, &g_PipelineCacheCreateInfo, nullptr, &PipelineCache));
     }
@@ -115,7 +117,7 @@ void PipelineData::CreateMainCache(VkDevice const &LogicalDevice)
 
 void PipelineData::CreateLibraryCache(VkDevice const &LogicalDevice)
 {
-    if (g_PipelineData.PipelineLibraryCache == VK_NULL_HANDLE)
+    if (PipelineLibraryCache == VK_NULL_HANDLE)
     {
         CheckVulkanResult(vkCreatePipelineCache(LogicalDevice, &g_PipelineCacheCreateInfo, nullptr, &PipelineLibraryCache));
     }
@@ -126,6 +128,12 @@ void PipelineDescriptorData::DestroyResources(VmaAllocator const &Allocator, boo
     SceneData.DestroyResources(Allocator, IncludeStatic);
     ModelData.DestroyResources(Allocator, IncludeStatic);
     TextureData.DestroyResources(Allocator, IncludeStatic);
+    IndirectTextureData.DestroyResources(Allocator, IncludeStatic);
+
+    if (IncludeStatic)
+    {
+        IndirectTextureCapacity = 0U;
+    }
 }
 
 void PipelineDescriptorData::SetDescriptorLayoutSize()
@@ -133,21 +141,26 @@ void PipelineDescriptorData::SetDescriptorLayoutSize()
     VkPhysicalDeviceProperties2 DeviceProperties { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &g_DescriptorBufferProperties };
     vkGetPhysicalDeviceProperties2(GetPhysicalDevice(), &DeviceProperties);
 
-    SceneData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
-    ModelData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
-    TextureData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment);
+    constexpr auto NumTextures = static_cast<std::uint32_t>(TextureType::Count);
+
+    SceneData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment, 1U);
+    ModelData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment, 1U);
+    TextureData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment, NumTextures);
+    IndirectTextureData.SetDescriptorLayoutSize(g_DescriptorBufferProperties.descriptorBufferOffsetAlignment, 1U);
 }
 
 void PipelineDescriptorData::SetupSceneBuffer(BufferAllocation const &SceneAllocation)
 {
+    InvalidateCachedSceneCommands();
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     {
         VmaAllocator const &         Allocator   = GetAllocator();
         constexpr VkBufferUsageFlags BufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
-        SceneData.Buffer.Size = SceneData.LayoutSize;
-        CreateBuffer(SceneData.LayoutSize, BufferUsage, "Scene Descriptor Buffer", SceneData.Buffer.Buffer, SceneData.Buffer.Allocation);
+        SceneData.Buffer.Size = g_MaxFramesInFlight * SceneData.LayoutSize;
+        CreateBuffer(SceneData.Buffer.Size, BufferUsage, "Scene Descriptor Buffer", SceneData.Buffer.Buffer, SceneData.Buffer.Allocation);
         vmaMapMemory(Allocator, SceneData.Buffer.Allocation, &SceneData.Buffer.MappedData);
 
         VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
@@ -166,29 +179,42 @@ void PipelineDescriptorData::SetupSceneBuffer(BufferAllocation const &SceneAlloc
 
         VkDeviceSize const SceneUniformAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
 
-        VkDescriptorAddressInfoEXT const SceneDescriptorAddressInfo {
-                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
-                .address = SceneUniformAddress,
-                .range = sizeof(SceneUniformData),
-                .format = VK_FORMAT_UNDEFINED
-        };
+        for (std::uint32_t FrameIndex = 0U; FrameIndex < g_MaxFramesInFlight; ++FrameIndex)
+        {
+            VkDescriptorAddressInfoEXT const SceneDescriptorAddressInfo {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                    .address = SceneUniformAddress + FrameIndex * GetSceneUniformStride(),
+                    .range = sizeof(SceneUniformData),
+                    .format = VK_FORMAT_UNDEFINED
+            };
 
-        VkDescriptorGetInfoEXT const SceneDescriptorInfo {
-                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
-                .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .data = VkDescriptorDataEXT { .pUniformBuffer = &SceneDescriptorAddressInfo }
-        };
+            VkDescriptorGetInfoEXT const SceneDescriptorInfo {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                    .data = VkDescriptorDataEXT { .pUniformBuffer = &SceneDescriptorAddressInfo }
+            };
 
-        vkGetDescriptorEXT(LogicalDevice,
-                           &SceneDescriptorInfo,
-                           g_DescriptorBufferProperties.uniformBufferDescriptorSize,
-                           static_cast<unsigned char *>(SceneData.Buffer.MappedData) + SceneData.LayoutOffset);
+            VkDeviceSize const BufferOffset = FrameIndex * SceneData.LayoutSize + SceneData.LayoutOffset;
+
+            vkGetDescriptorEXT(LogicalDevice,
+                               &SceneDescriptorInfo,
+                               g_DescriptorBufferProperties.uniformBufferDescriptorSize,
+                               static_cast<unsigned char *>(SceneData.Buffer.MappedData) + BufferOffset);
+        }
     }
 }
 
 void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Object>> const &Objects)
 {
-    if (std::empty(Objects))
+    RetireBufferAllocation(ModelData.Buffer);
+    RetireBufferAllocation(TextureData.Buffer);
+    RetireBufferAllocation(IndirectTextureData.Buffer);
+    InvalidateCachedSceneCommands();
+
+    ModelsCapacity   = GetUniformSlotCapacity();
+    ModelsGeneration = GetModelsBufferGeneration();
+
+    if (ModelsCapacity == 0U)
     {
         return;
     }
@@ -199,7 +225,7 @@ void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Objec
     {
         constexpr VkBufferUsageFlags BufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
-        ModelData.Buffer.Size = static_cast<std::uint32_t>(std::size(Objects)) * ModelData.LayoutSize;
+        ModelData.Buffer.Size = ModelsCapacity * g_MaxFramesInFlight * ModelData.LayoutSize;
 
         CreateBuffer(ModelData.Buffer.Size, BufferUsage, "Model Descriptor Buffer", ModelData.Buffer.Buffer, ModelData.Buffer.Allocation);
 
@@ -213,13 +239,12 @@ void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Objec
         ModelData.BufferDeviceAddress.deviceAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
     }
 
-    constexpr std::uint8_t NumTextures = static_cast<std::uint8_t>(TextureType::Count);
-
     {
         constexpr VkBufferUsageFlags BufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
                                                    VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
-        TextureData.Buffer.Size = NumTextures * static_cast<std::uint32_t>(std::size(Objects)) * TextureData.LayoutSize;
+        // One copy per frame in flight, like the model descriptors: residency changes rewrite them while earlier frames still read theirs
+        TextureData.Buffer.Size = ModelsCapacity * g_MaxFramesInFlight * TextureData.LayoutSize;
         CreateBuffer(TextureData.Buffer.Size, BufferUsage, "Texture Descriptor Buffer", TextureData.Buffer.Buffer, TextureData.Buffer.Allocation);
 
         vmaMapMemory(Allocator, TextureData.Buffer.Allocation, &TextureData.Buffer.MappedData);
@@ -232,89 +257,192 @@ void PipelineDescriptorData::SetupModelsBuffer(std::vector<std::shared_ptr<Objec
         TextureData.BufferDeviceAddress.deviceAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
     }
 
-    auto const ModelBuffer   = static_cast<unsigned char *>(ModelData.Buffer.MappedData);
-    auto const TextureBuffer = static_cast<unsigned char *>(TextureData.Buffer.MappedData);
+    {
+        constexpr VkBufferUsageFlags BufferUsage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                                                   VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        IndirectTextureData.Buffer.Size = g_MaxFramesInFlight * IndirectTextureData.LayoutSize;
+        CreateBuffer(IndirectTextureData.Buffer.Size,
+                     BufferUsage,
+                     "Indirect Texture Descriptor Buffer",
+                     IndirectTextureData.Buffer.Buffer,
+                     IndirectTextureData.Buffer.Allocation);
+
+        vmaMapMemory(Allocator, IndirectTextureData.Buffer.Allocation, &IndirectTextureData.Buffer.MappedData);
+
+        VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = IndirectTextureData.Buffer.Buffer
+        };
+
+        IndirectTextureData.BufferDeviceAddress.deviceAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
+    }
+
+    for (std::shared_ptr<Object> const &ObjectIter : Objects)
+    {
+        SetupObjectDescriptors(ObjectIter);
+    }
+}
+
+void PipelineDescriptorData::UpdateModelsBuffer(std::vector<std::shared_ptr<Object>> const &Objects)
+{
+    if (!ModelData.Buffer.IsValid() || !TextureData.Buffer.IsValid() || !IndirectTextureData.Buffer.IsValid() || ModelsGeneration != GetModelsBufferGeneration() ||
+        ModelsCapacity != GetUniformSlotCapacity())
+    {
+        SetupModelsBuffer(GetObjects());
+        return;
+    }
+
+    for (std::shared_ptr<Object> const &ObjectIter : Objects)
+    {
+        SetupObjectDescriptors(ObjectIter);
+    }
+}
+
+void PipelineDescriptorData::SetupObjectDescriptors(std::shared_ptr<Object> const &Object) const
+{
+    VkDevice const &    LogicalDevice = GetLogicalDevice();
+    std::uint32_t const Slot          = Object->GetBufferIndex();
 
-    std::uint32_t ObjectCount = 0U;
+    auto const ModelBuffer = static_cast<unsigned char *>(ModelData.Buffer.MappedData);
 
     VkBufferDeviceAddressInfo const BufferDeviceAddressInfo {
             .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-            .buffer = GetAllocationBuffer()
+            .buffer = GetUniformAllocationBuffer()
     };
 
-    for (std::shared_ptr<Object> const &ObjectIter : Objects)
+    VkDeviceSize const ModelUniformAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
+
+    for (std::uint32_t FrameIndex = 0U; FrameIndex < g_MaxFramesInFlight; ++FrameIndex)
     {
-        {
-            VkDeviceSize const ModelUniformAddress = vkGetBufferDeviceAddress(LogicalDevice, &BufferDeviceAddressInfo);
+        VkDescriptorAddressInfoEXT ModelDescriptorAddressInfo {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                .address = ModelUniformAddress + Object->GetUniformOffset() + FrameIndex * GetModelUniformStride(),
+                .range = sizeof(ModelUniformData)
+        };
 
-            VkDescriptorAddressInfoEXT ModelDescriptorAddressInfo {
-                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
-                    .address = ModelUniformAddress + ObjectIter->GetUniformOffset(),
-                    .range = sizeof(ModelUniformData)
-            };
+        VkDescriptorGetInfoEXT const ModelDescriptorInfo {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                .data = VkDescriptorDataEXT { .pUniformBuffer = &ModelDescriptorAddressInfo }
+        };
 
-            VkDescriptorGetInfoEXT const ModelDescriptorInfo {
-                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
-                    .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                    .data = VkDescriptorDataEXT { .pUniformBuffer = &ModelDescriptorAddressInfo }
-            };
+        VkDeviceSize const BufferOffset = (Slot * g_MaxFramesInFlight + FrameIndex) * ModelData.LayoutSize + ModelData.LayoutOffset;
 
-            VkDeviceSize const BufferOffset = ObjectCount * ModelData.LayoutSize + ModelData.LayoutOffset;
+        vkGetDescriptorEXT(LogicalDevice,
+                           &ModelDescriptorInfo,
+                           g_DescriptorBufferProperties.uniformBufferDescriptorSize,
+                           ModelBuffer + BufferOffset);
 
-            vkGetDescriptorEXT(LogicalDevice,
-                               &ModelDescriptorInfo,
-                               g_DescriptorBufferProperties.uniformBufferDescriptorSize,
-                               ModelBuffer + BufferOffset);
-        }
+        SetupTextureDescriptors(Object, FrameIndex);
+    }
+}
 
-        auto const &  Textures     = ObjectIter->GetMesh()->GetTextures();
-        std::uint32_t TextureCount = 0U;
+void PipelineDescriptorData::SetupTextureDescriptors(std::shared_ptr<Object> const &Object, std::uint32_t const FrameIndex) const
+{
+    VkDevice const &    LogicalDevice = GetLogicalDevice();
+    std::uint32_t const Slot          = Object->GetBufferIndex();
 
-        for (std::uint8_t TypeIter = 0U; TypeIter < NumTextures; ++TypeIter)
-        {
-            auto MatchingTexture = std::ranges::find_if(Textures,
-                                                        [TypeIter](std::shared_ptr<Texture> const &Texture)
-                                                        {
-                                                            auto const Types = Texture->GetTypes();
-                                                            return std::ranges::find_if(Types,
-                                                                                        [TypeIter](TextureType const &TextureType)
-                                                                                        {
-                                                                                            return static_cast<std::uint8_t>(TextureType) == TypeIter;
-                                                                                        }) != std::end(Types);
-                                                        });
-
-            auto const &ImageDescriptor = MatchingTexture != std::cend(Textures)
-                                              ? (*MatchingTexture)->GetImageDescriptor()
-                                              : GetAllocationImageDescriptor(0U);
-
-            VkDescriptorGetInfoEXT const TextureDescriptorInfo {
-                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
-                    .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    .data = VkDescriptorDataEXT { .pCombinedImageSampler = &ImageDescriptor }
-            };
+    auto const TextureBuffer         = static_cast<unsigned char *>(TextureData.Buffer.MappedData);
+    auto const IndirectTextureBuffer = static_cast<unsigned char *>(IndirectTextureData.Buffer.MappedData);
+    bool const HasIndirectTextures   = CanDrawSlotIndirect(Slot);
+
+    constexpr std::uint8_t NumTextures = static_cast<std::uint8_t>(TextureType::Count);
+    auto const &           Textures    = Object->GetMesh()->GetTextures();
+
+    for (std::uint8_t TypeIter = 0U; TypeIter < NumTextures; ++TypeIter)
+    {
+        auto MatchingTexture = std::ranges::find_if(Textures,
+                                                    [TypeIter](std::shared_ptr<Texture> const &Texture)
+                                                    {
+                                                        auto const Types = Texture->GetTypes();
+                                                        return std::ranges::find_if(Types,
+                                                                                    [TypeIter](TextureType const &TextureType)
+                                                                                    {
+                                                                                        return static_cast<std::uint8_t>(TextureType) == TypeIter;
+                                                                                    }) != std::end(Types);
+                                                    });
+
+        auto const &ImageDescriptor = MatchingTexture != std::cend(Textures)
+                                          ? (*MatchingTexture)->GetImageDescriptor()
+                                          : GetAllocationImageDescriptor(0U);
+
+        VkDescriptorGetInfoEXT const TextureDescriptorInfo {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .data = VkDescriptorDataEXT { .pCombinedImageSampler = &ImageDescriptor }
+        };
 
-            VkDeviceSize const BufferOffset = (TextureCount + ObjectCount * NumTextures) * TextureData.LayoutSize + TextureData.LayoutOffset;
+        VkDeviceSize const BufferOffset = (Slot * g_MaxFramesInFlight + FrameIndex) * TextureData.LayoutSize + TextureData.BindingOffsets.at(TypeIter);
+
+        vkGetDescriptorEXT(LogicalDevice,
+                           &TextureDescriptorInfo,
+                           g_DescriptorBufferProperties.combinedImageSamplerDescriptorSize,
+                           TextureBuffer + BufferOffset);
+
+        if (HasIndirectTextures)
+        {
+            VkDeviceSize const DescriptorIndex = Slot * NumTextures + TypeIter;
+            VkDeviceSize const IndirectOffset  = FrameIndex * IndirectTextureData.LayoutSize + IndirectTextureData.LayoutOffset +
+                                                DescriptorIndex * g_DescriptorBufferProperties.combinedImageSamplerDescriptorSize;
 
             vkGetDescriptorEXT(LogicalDevice,
                                &TextureDescriptorInfo,
                                g_DescriptorBufferProperties.combinedImageSamplerDescriptorSize,
-                               TextureBuffer + BufferOffset);
-
-            ++TextureCount;
+                               IndirectTextureBuffer + IndirectOffset);
         }
-
-        ++ObjectCount;
     }
 }
 
-void RenderCore::CreatePipelineDynamicResources()
+void PipelineDescriptorData::BindSceneDescriptorBuffers(CommandStateTracker &StateTracker) const
 {
-    std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
-    std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
+    std::array const BufferBindingInfos {
+            VkDescriptorBufferBindingInfoEXT
+            {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = SceneData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            },
+            VkDescriptorBufferBindingInfoEXT {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = ModelData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            },
+            VkDescriptorBufferBindingInfoEXT {
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                    .address = TextureData.BufferDeviceAddress.deviceAddress,
+                    .usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+            }
+    };
 
-    for (auto const &[StageInfo, ShaderCode] : GetStageData())
+    StateTracker.BindDescriptorBuffers(BufferBindingInfos);
+}
+
+void PipelineDescriptorData::SetObjectDescriptorOffsets(CommandStateTracker &   StateTracker,
+                                                        VkPipelineLayout const &PipelineLayout,
+                                                        std::uint32_t const     FrameIndex,
+                                                        std::uint32_t const     Slot) const
+{
+    std::array const BufferOffsets {
+            FrameIndex * SceneData.LayoutSize,
+            (Slot * g_MaxFramesInFlight + FrameIndex) * ModelData.LayoutSize,
+            (Slot * g_MaxFramesInFlight + FrameIndex) * TextureData.LayoutSize
+    };
+
+    StateTracker.SetDescriptorBufferOffsets(PipelineLayout, BufferOffsets);
+}
+
+void CollectShaderStages(std::vector<ShaderStageData> const &            Stages,
+                         VkShaderStageFlagBits const                     Stage,
+                         std::vector<VkPipelineShaderStageCreateInfo> &ShaderStagesInfo,
+                         std::vector<VkShaderModuleCreateInfo> &        ShaderModuleInfo)
+{
+    // pNext points into ShaderModuleInfo, it must not reallocate while stages are collected
+    ShaderModuleInfo.reserve(std::size(Stages));
+
+    for (auto const &[StageInfo, ShaderCode] : Stages)
     {
-        if (StageInfo.stage == VK_SHADER_STAGE_FRAGMENT_BIT)
+        if (StageInfo.stage == Stage)
         {
             auto const CodeSize                            = static_cast<std::uint32_t>(std::size(ShaderCode) * sizeof(std::uint32_t));
             ShaderStagesInfo.emplace_back(StageInfo).pNext = &ShaderModuleInfo.emplace_back(VkShaderModuleCreateInfo {
@@ -325,28 +453,63 @@ void RenderCore::CreatePipelineDynamicResources()
                                                                                             });
         }
     }
-
-    CreateMainPipeline(g_PipelineData, ShaderStagesInfo, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, g_DepthStencilState, g_MultisampleState);
 }
 
-void RenderCore::CreatePipelineLibraries()
+void RenderCore::CreatePipelineDynamicResources()
 {
-    std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
-    std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
+    {
+        std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
+        std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
+        CollectShaderStages(GetStageData(), VK_SHADER_STAGE_FRAGMENT_BIT, ShaderStagesInfo, ShaderModuleInfo);
+
+        CreateMainPipeline(g_PipelineData, ShaderStagesInfo, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, g_DepthStencilState, g_MultisampleState);
+    }
 
-    for (auto const &[StageInfo, ShaderCode] : GetStageData())
+    if (g_IndirectPipelineData.PipelineLayout != VK_NULL_HANDLE)
     {
-        if (StageInfo.stage == VK_SHADER_STAGE_VERTEX_BIT)
+        std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
+        std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
+        CollectShaderStages(GetIndirectStageData(), VK_SHADER_STAGE_FRAGMENT_BIT, ShaderStagesInfo, ShaderModuleInfo);
+
+        CreateMainPipeline(g_IndirectPipelineData,
+                           ShaderStagesInfo,
+                           VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+                           g_DepthStencilState,
+                           g_MultisampleState);
+    }
+
+    if (g_CullingPipelineData.PipelineLayout != VK_NULL_HANDLE)
+    {
+        std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
+        std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
+        CollectShaderStages(GetCullingStageData(), VK_SHADER_STAGE_COMPUTE_BIT, ShaderStagesInfo, ShaderModuleInfo);
+
+        if (!std::empty(ShaderStagesInfo))
         {
-            auto const CodeSize                            = static_cast<std::uint32_t>(std::size(ShaderCode) * sizeof(std::uint32_t));
-            ShaderStagesInfo.emplace_back(StageInfo).pNext = &ShaderModuleInfo.emplace_back(VkShaderModuleCreateInfo {
-                                                                                                    .sType =
-                                                                                                    VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-                                                                                                    .codeSize = CodeSize,
-                                                                                                    .pCode = std::data(ShaderCode)
-                                                                                            });
+            VkDevice const &LogicalDevice = GetLogicalDevice();
+            g_CullingPipelineData.CreateMainCache(LogicalDevice);
+
+            VkComputePipelineCreateInfo const ComputePipelineCreateInfo {
+                    .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                    .stage = ShaderStagesInfo.at(0U),
+                    .layout = g_CullingPipelineData.PipelineLayout
+            };
+
+            CheckVulkanResult(vkCreateComputePipelines(LogicalDevice,
+                                                       g_CullingPipelineData.PipelineCache,
+                                                       1U,
+                                                       &ComputePipelineCreateInfo,
+                                                       nullptr,
+                                                       &g_CullingPipelineData.MainPipeline));
         }
     }
+}
+
+void RenderCore::CreatePipelineLibraries()
+{
+    std::vector<VkPipelineShaderStageCreateInfo> ShaderStagesInfo {};
+    std::vector<VkShaderModuleCreateInfo>        ShaderModuleInfo {};
+    CollectShaderStages(GetStageData(), VK_SHADER_STAGE_VERTEX_BIT, ShaderStagesInfo, ShaderModuleInfo);
 
     constexpr VkPipelineColorBlendAttachmentState ColorBlendAttachmentStates {
             .blendEnable = VK_TRUE,
@@ -390,6 +553,18 @@ void RenderCore::CreatePipelineLibraries()
     };
 
     CreatePipelineLibraries(g_PipelineData, Arguments, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, true);
+
+    if (g_IndirectPipelineData.PipelineLayout != VK_NULL_HANDLE)
+    {
+        std::vector<VkPipelineShaderStageCreateInfo> IndirectStagesInfo {};
+        std::vector<VkShaderModuleCreateInfo>        IndirectModuleInfo {};
+        CollectShaderStages(GetIndirectStageData(), VK_SHADER_STAGE_VERTEX_BIT, IndirectStagesInfo, IndirectModuleInfo);
+
+        PipelineLibraryCreationArguments IndirectArguments = Arguments;
+        IndirectArguments.ShaderStages                     = IndirectStagesInfo;
+
+        CreatePipelineLibraries(g_IndirectPipelineData, IndirectArguments, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, true);
+    }
 }
 
 void CreateDescriptorSetLayout(VkDescriptorSetLayoutBinding const &Binding, std::uint32_t const Bindings, VkDescriptorSetLayout &DescriptorSetLayout)
@@ -450,6 +625,64 @@ void RenderCore::SetupPipelineLayouts()
 
     VkDevice const &LogicalDevice = GetLogicalDevice();
     CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutCreateInfo, nullptr, &g_PipelineData.PipelineLayout));
+
+    // Indirect path: camera set plus one bindless texture array, per-draw data is read through a buffer address pushed as constant
+    {
+        constexpr auto              NumTextures = static_cast<std::uint32_t>(TextureType::Count);
+        VkPhysicalDeviceLimits const &Limits      = GetPhysicalDeviceProperties().limits;
+
+        g_DescriptorData.IndirectTextureCapacity = std::min({
+                                                           g_MaxIndirectTextureDescriptors,
+                                                           Limits.maxPerStageDescriptorSamplers,
+                                                           Limits.maxPerStageDescriptorSampledImages,
+                                                           Limits.maxDescriptorSetSamplers,
+                                                           Limits.maxDescriptorSetSampledImages
+                                                   }) / NumTextures * NumTextures;
+
+        VkDescriptorSetLayoutBinding IndirectTextureBinding = LayoutBindings.at(1U);
+        IndirectTextureBinding.descriptorCount              = g_DescriptorData.IndirectTextureCapacity;
+
+        CreateDescriptorSetLayout(IndirectTextureBinding, 1U, g_DescriptorData.IndirectTextureData.SetLayout);
+
+        std::array const IndirectDescriptorLayouts {
+                g_DescriptorData.SceneData.SetLayout,
+                g_DescriptorData.IndirectTextureData.SetLayout
+        };
+
+        constexpr VkPushConstantRange PushConstantRange {
+                .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                .offset = 0U,
+                .size = sizeof(VkDeviceAddress)
+        };
+
+        VkPipelineLayoutCreateInfo const IndirectPipelineLayoutCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .setLayoutCount = static_cast<std::uint32_t>(std::size(IndirectDescriptorLayouts)),
+                .pSetLayouts = std::data(IndirectDescriptorLayouts),
+                .pushConstantRangeCount = 1U,
+                .pPushConstantRanges = &PushConstantRange
+        };
+
+        CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice, &IndirectPipelineLayoutCreateInfo, nullptr, &g_IndirectPipelineData.PipelineLayout));
+    }
+
+    // Culling pass: every buffer it touches is reached through addresses in the push constants
+    {
+        constexpr VkPushConstantRange PushConstantRange {
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0U,
+                .size = sizeof(IndirectCullingConstants)
+        };
+
+        VkPipelineLayoutCreateInfo const CullingPipelineLayoutCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .pushConstantRangeCount = 1U,
+                .pPushConstantRanges = &PushConstantRange
+        };
+
+        CheckVulkanResult(vkCreatePipelineLayout(LogicalDevice, &CullingPipelineLayoutCreateInfo, nullptr, &g_CullingPipelineData.PipelineLayout));
+    }
+
     g_DescriptorData.SetDescriptorLayoutSize();
 }
 
@@ -461,6 +694,18 @@ void RenderCore::ReleasePipelineResources(bool const IncludeStatic)
         g_PipelineData.DestroyResources(LogicalDevice, IncludeStatic);
     }
 
+    if (g_IndirectPipelineData.IsValid())
+    {
+        VkDevice const &LogicalDevice = GetLogicalDevice();
+        g_IndirectPipelineData.DestroyResources(LogicalDevice, IncludeStatic);
+    }
+
+    if (g_CullingPipelineData.IsValid())
+    {
+        VkDevice const &LogicalDevice = GetLogicalDevice();
+        g_CullingPipelineData.DestroyResources(LogicalDevice, IncludeStatic);
+    }
+
     VmaAllocator const &Allocator = GetAllocator();
     g_DescriptorData.DestroyResources(Allocator, IncludeStatic);
 }
@@ -552,7 +797,7 @@ void RenderCore::CreatePipelineLibraries(PipelineData &
     // Fragment output library
     {
         VkFormat const SwapChainImageFormat = GetSwapChainImageFormat();
-        VkFormat const DepthFormat          = EnableDepth ? GetDepthImage().Format : VK_FORMAT_UNDEFINED;
+        VkFormat const DepthFormat          = EnableDepth ? GetDepthFormat() : VK_FORMAT_UNDEFINED;
 
         VkPipelineRenderingCreateInfo const RenderingCreateInfo {
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
@@ -602,11 +847,13 @@ void RenderCore::CreateMainPipeline(PipelineData &
                                     VkPipelineDepthStencilStateCreateInfo const &       DepthStencilState,
                                     VkPipelineMultisampleStateCreateInfo const &        MultisampleState)
 {
+    InvalidateCachedSceneCommands();
+
     VkDevice const &LogicalDevice = GetLogicalDevice();
     Data.CreateMainCache(LogicalDevice);
 
     VkFormat const SwapChainImageFormat = GetSwapChainImageFormat();
-    VkFormat const DepthFormat          = GetDepthImage().Format;
+    VkFormat const DepthFormat          = GetDepthFormat();
 
     VkPipelineRenderingCreateInfo const RenderingCreateInfo {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
@@ -0,0 +1,301 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Query;
+
+import RenderCore.Runtime.Device;
+import RenderCore.Utils.Helpers;
+
+using namespace RenderCore;
+
+constexpr std::uint32_t g_FrameQueryOffset     = 0U;
+constexpr std::uint32_t g_PassQueryOffset      = 2U;
+constexpr std::uint32_t g_ThreadQueryOffset    = g_PassQueryOffset + 2U * g_MaxTimedPasses;
+constexpr std::uint32_t g_NumTimestampQueries  = g_ThreadQueryOffset + 2U * g_MaxTimedRecordingThreads;
+constexpr std::uint32_t g_NumStatisticsQueries = g_MaxTimedRecordingThreads;
+
+constexpr VkQueryPipelineStatisticFlags g_PipelineStatisticsFlags = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+                                                                    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+                                                                    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                                                                    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+                                                                    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+                                                                    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+static_assert(sizeof(GPUPipelineStatistics) == std::popcount(g_PipelineStatisticsFlags) * sizeof(std::uint64_t));
+
+bool ReadTimestampPair(VkQueryPool const &QueryPool, std::uint32_t const FirstQuery, double &Output)
+{
+    std::array<std::uint64_t, 2U> Timestamps {};
+
+    if (vkGetQueryPoolResults(GetLogicalDevice(),
+                              QueryPool,
+                              FirstQuery,
+                              static_cast<std::uint32_t>(std::size(Timestamps)),
+                              sizeof(Timestamps),
+                              std::data(Timestamps),
+                              sizeof(std::uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    std::uint64_t const Ticks = (Timestamps.at(1U) - Timestamps.at(0U)) & g_TimestampMask;
+    Output                    = static_cast<double>(Ticks) * g_TimestampPeriod / 1000000.0;
+
+    return true;
+}
+
+void CollectFrameQueries(FrameQueries &Queries)
+{
+    if (!Queries.HasPendingResults)
+    {
+        return;
+    }
+
+    Queries.HasPendingResults = false;
+
+    GPUFrameTimings Output { .FrameNumber = Queries.FrameNumber, .HasPipelineStatistics = Queries.HasStatistics };
+
+    if (!ReadTimestampPair(Queries.TimestampPool, g_FrameQueryOffset, Output.FrameTime))
+    {
+        return;
+    }
+
+    Output.Passes.reserve(std::size(Queries.PassNames));
+
+    for (std::uint32_t PassIndex = 0U; PassIndex < std::size(Queries.PassNames); ++PassIndex)
+    {
+        if (GPUPassTiming PassTiming { .Name = Queries.PassNames.at(PassIndex) };
+            ReadTimestampPair(Queries.TimestampPool, g_PassQueryOffset + 2U * PassIndex, PassTiming.Time))
+        {
+            Output.Passes.push_back(std::move(PassTiming));
+        }
+    }
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < g_MaxTimedRecordingThreads; ++ThreadIndex)
+    {
+        if (!Queries.ThreadsWritten.at(ThreadIndex))
+        {
+            continue;
+        }
+
+        GPUThreadTiming ThreadTiming { .ThreadIndex = ThreadIndex };
+
+        if (!ReadTimestampPair(Queries.TimestampPool, g_ThreadQueryOffset + 2U * ThreadIndex, ThreadTiming.Time))
+        {
+            continue;
+        }
+
+        if (Queries.HasStatistics)
+        {
+            [[maybe_unused]] VkResult const _ = vkGetQueryPoolResults(LogicalDevice,
+                                                                      Queries.StatisticsPool,
+                                                                      ThreadIndex,
+                                                                      1U,
+                                                                      sizeof(GPUPipelineStatistics),
+                                                                      &ThreadTiming.Statistics,
+                                                                      sizeof(GPUPipelineStatistics),
+                                                                      VK_QUERY_RESULT_64_BIT);
+        }
+
+        Output.RecordingThreads.push_back(ThreadTiming);
+    }
+
+    std::lock_guard const Lock { g_GPUFrameTimingsMutex };
+    g_LatestGPUFrameTimings = std::move(Output);
+}
+
+void RenderCore::CreateQueryResources()
+{
+    VkPhysicalDevice const &      PhysicalDevice = GetPhysicalDevice();
+    VkPhysicalDeviceLimits const &Limits         = GetPhysicalDeviceProperties().limits;
+
+    std::uint32_t QueueFamilyCount = 0U;
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &QueueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(PhysicalDevice, &QueueFamilyCount, std::data(QueueFamilies));
+
+    std::uint32_t const ValidBits = QueueFamilies.at(GetGraphicsQueue().first).timestampValidBits;
+    g_TimestampsSupported         = Limits.timestampComputeAndGraphics == VK_TRUE && ValidBits > 0U;
+
+    if (!g_TimestampsSupported)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "[" << __func__ << "]: Timestamp queries are not supported by the graphics queue";
+        return;
+    }
+
+    g_TimestampPeriod = static_cast<double>(Limits.timestampPeriod);
+    g_TimestampMask   = ValidBits >= 64U ? std::numeric_limits<std::uint64_t>::max() : (1ULL << ValidBits) - 1ULL;
+
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    constexpr VkQueryPoolCreateInfo TimestampPoolCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = g_NumTimestampQueries
+    };
+
+    constexpr VkQueryPoolCreateInfo StatisticsPoolCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+            .queryCount = g_NumStatisticsQueries,
+            .pipelineStatistics = g_PipelineStatisticsFlags
+    };
+
+    for (FrameQueries &QueriesIter : g_FrameQueries)
+    {
+        CheckVulkanResult(vkCreateQueryPool(LogicalDevice, &TimestampPoolCreateInfo, nullptr, &QueriesIter.TimestampPool));
+        CheckVulkanResult(vkCreateQueryPool(LogicalDevice, &StatisticsPoolCreateInfo, nullptr, &QueriesIter.StatisticsPool));
+    }
+}
+
+void RenderCore::ReleaseQueryResources()
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    for (FrameQueries &QueriesIter : g_FrameQueries)
+    {
+        if (QueriesIter.TimestampPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(LogicalDevice, QueriesIter.TimestampPool, nullptr);
+        }
+
+        if (QueriesIter.StatisticsPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(LogicalDevice, QueriesIter.StatisticsPool, nullptr);
+        }
+
+        QueriesIter = {};
+    }
+
+    g_TimestampsSupported = false;
+}
+
+void RenderCore::BeginFrameQueries(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex)
+{
+    if (!g_TimestampsSupported)
+    {
+        return;
+    }
+
+    FrameQueries &Queries = g_FrameQueries.at(FrameIndex);
+    CollectFrameQueries(Queries);
+
+    Queries.FrameNumber   = g_QueryFrameCounter++;
+    Queries.HasStatistics = g_CollectPipelineStatistics;
+    Queries.PassNames.clear();
+    Queries.ThreadsWritten.fill(false);
+
+    vkCmdResetQueryPool(CommandBuffer, Queries.TimestampPool, 0U, g_NumTimestampQueries);
+
+    if (Queries.HasStatistics)
+    {
+        vkCmdResetQueryPool(CommandBuffer, Queries.StatisticsPool, 0U, g_NumStatisticsQueries);
+    }
+
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, Queries.TimestampPool, g_FrameQueryOffset);
+}
+
+void RenderCore::EndFrameQueries(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex)
+{
+    if (!g_TimestampsSupported)
+    {
+        return;
+    }
+
+    FrameQueries &Queries = g_FrameQueries.at(FrameIndex);
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, Queries.TimestampPool, g_FrameQueryOffset + 1U);
+
+    Queries.HasPendingResults = true;
+}
+
+std::uint32_t RenderCore::BeginPassQuery(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex, strzilla::string_view const Name)
+{
+    FrameQueries &Queries = g_FrameQueries.at(FrameIndex);
+
+    if (!g_TimestampsSupported || std::size(Queries.PassNames) >= g_MaxTimedPasses)
+    {
+        return g_MaxTimedPasses;
+    }
+
+    auto const PassIndex = static_cast<std::uint32_t>(std::size(Queries.PassNames));
+    Queries.PassNames.emplace_back(Name);
+
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, Queries.TimestampPool, g_PassQueryOffset + 2U * PassIndex);
+
+    return PassIndex;
+}
+
+void RenderCore::EndPassQuery(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex, std::uint32_t const PassIndex)
+{
+    if (!g_TimestampsSupported || PassIndex >= g_MaxTimedPasses)
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp2(CommandBuffer,
+                         VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
+                         g_FrameQueries.at(FrameIndex).TimestampPool,
+                         g_PassQueryOffset + 2U * PassIndex + 1U);
+}
+
+void RenderCore::BeginThreadQueries(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex, std::uint32_t const ThreadIndex)
+{
+    if (!g_TimestampsSupported || ThreadIndex >= g_MaxTimedRecordingThreads)
+    {
+        return;
+    }
+
+    FrameQueries &Queries = g_FrameQueries.at(FrameIndex);
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, Queries.TimestampPool, g_ThreadQueryOffset + 2U * ThreadIndex);
+
+    if (Queries.HasStatistics)
+    {
+        vkCmdBeginQuery(CommandBuffer, Queries.StatisticsPool, ThreadIndex, 0U);
+    }
+}
+
+void RenderCore::EndThreadQueries(VkCommandBuffer const &CommandBuffer, std::uint32_t const FrameIndex, std::uint32_t const ThreadIndex)
+{
+    if (!g_TimestampsSupported || ThreadIndex >= g_MaxTimedRecordingThreads)
+    {
+        return;
+    }
+
+    FrameQueries &Queries = g_FrameQueries.at(FrameIndex);
+
+    if (Queries.HasStatistics)
+    {
+        vkCmdEndQuery(CommandBuffer, Queries.StatisticsPool, ThreadIndex);
+    }
+
+    vkCmdWriteTimestamp2(CommandBuffer, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, Queries.TimestampPool, g_ThreadQueryOffset + 2U * ThreadIndex + 1U);
+    MarkThreadQueriesWritten(FrameIndex, ThreadIndex);
+}
+
+void RenderCore::MarkThreadQueriesWritten(std::uint32_t const FrameIndex, std::uint32_t const ThreadIndex)
+{
+    if (!g_TimestampsSupported || ThreadIndex >= g_MaxTimedRecordingThreads)
+    {
+        return;
+    }
+
+    g_FrameQueries.at(FrameIndex).ThreadsWritten.at(ThreadIndex) = true;
+}
+
+bool RenderCore::HasFrameStatistics(std::uint32_t const FrameIndex)
+{
+    return g_TimestampsSupported && g_FrameQueries.at(FrameIndex).HasStatistics;
+}
+
+GPUFrameTimings RenderCore::GetLatestGPUFrameTimings()
+{
+    std::lock_guard const Lock { g_GPUFrameTimingsMutex };
+    return g_LatestGPUFrameTimings;
+}
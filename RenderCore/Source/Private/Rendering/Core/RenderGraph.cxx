@@ -0,0 +1,568 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.RenderGraph;
+
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.Memory;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.EnumHelpers;
+import RenderCore.Utils.Helpers;
+
+using namespace RenderCore;
+
+struct AccessInfo
+{
+    VkImageLayout         Layout { g_UndefinedLayout };
+    VkPipelineStageFlags2 Stages { VK_PIPELINE_STAGE_2_NONE };
+    VkAccessFlags2        Access { VK_ACCESS_2_NONE };
+    bool                  IsWrite { false };
+};
+
+constexpr AccessInfo GetAccessInfo(RenderGraphAccess const Access)
+{
+    switch (Access)
+    {
+        case RenderGraphAccess::ColorAttachmentWrite:
+            return AccessInfo {
+                    .Layout = g_AttachmentLayout,
+                    .Stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    .Access = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                    .IsWrite = true
+            };
+
+        case RenderGraphAccess::DepthAttachmentWrite:
+            return AccessInfo {
+                    .Layout = g_AttachmentLayout,
+                    .Stages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    .Access = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    .IsWrite = true
+            };
+
+        case RenderGraphAccess::ShaderRead:
+            return AccessInfo {
+                    .Layout = g_ReadLayout,
+                    .Stages = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                    .Access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                    .IsWrite = false
+            };
+
+        case RenderGraphAccess::TransferRead:
+            return AccessInfo {
+                    .Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .Stages = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                    .Access = VK_ACCESS_2_TRANSFER_READ_BIT,
+                    .IsWrite = false
+            };
+
+        case RenderGraphAccess::TransferWrite:
+            return AccessInfo {
+                    .Layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .Stages = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                    .Access = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    .IsWrite = true
+            };
+    }
+
+    return AccessInfo {};
+}
+
+constexpr AccessInfo GetFinalAccessInfo(VkImageLayout const Layout)
+{
+    switch (Layout)
+    {
+        case g_PresentLayout:
+            return AccessInfo { .Layout = Layout, .Stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, .Access = VK_ACCESS_2_NONE };
+
+        case g_ReadLayout:
+            return AccessInfo { .Layout = Layout, .Stages = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, .Access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+
+        default:
+            return AccessInfo { .Layout = Layout, .Stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, .Access = VK_ACCESS_2_MEMORY_READ_BIT };
+    }
+}
+
+constexpr bool IsSameDescription(RenderGraphImageDescription const &Lhs, RenderGraphImageDescription const &Rhs)
+{
+    return Lhs.Format == Rhs.Format && Lhs.Extent.width == Rhs.Extent.width && Lhs.Extent.height == Rhs.Extent.height && Lhs.Usage == Rhs.Usage &&
+           Lhs.Aspect == Rhs.Aspect;
+}
+
+void SubmitBarriers(VkCommandBuffer const &CommandBuffer, std::vector<VkImageMemoryBarrier2> const &Barriers)
+{
+    if (std::empty(Barriers))
+    {
+        return;
+    }
+
+    VkDependencyInfo const DependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
+            .imageMemoryBarrierCount = static_cast<std::uint32_t>(std::size(Barriers)),
+            .pImageMemoryBarriers = std::data(Barriers)
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+RenderGraphResource RenderGraph::ImportImage(strzilla::string_view const Name,
+                                             ImageAllocation const &     Image,
+                                             VkImageAspectFlags const    Aspect,
+                                             VkImageLayout const         FinalLayout)
+{
+    m_Resources.push_back(ResourceEntry {
+            .Name = strzilla::string { Name },
+            .Image = Image,
+            .Description = { .Format = Image.Format, .Extent = Image.Extent, .Usage = 0U, .Aspect = Aspect },
+            .FinalLayout = FinalLayout,
+            .IsTransient = false,
+            .IsOutput = FinalLayout != g_UndefinedLayout
+    });
+
+    return static_cast<RenderGraphResource>(std::size(m_Resources) - 1U);
+}
+
+RenderGraphResource RenderGraph::CreateTransientImage(strzilla::string_view const Name, RenderGraphImageDescription const &Description)
+{
+    m_Resources.push_back(ResourceEntry {
+            .Name = strzilla::string { Name },
+            .Image = { .Extent = Description.Extent, .Format = Description.Format },
+            .Description = Description,
+            .IsTransient = true
+    });
+
+    return static_cast<RenderGraphResource>(std::size(m_Resources) - 1U);
+}
+
+void RenderGraph::MarkOutput(RenderGraphResource const Resource)
+{
+    m_Resources.at(Resource).IsOutput = true;
+}
+
+void RenderGraph::AddPass(strzilla::string_view const                                      Name,
+                          std::vector<std::pair<RenderGraphResource, RenderGraphAccess>> &&Accesses,
+                          PassCallback &&                                                  Callback,
+                          bool const                                                       HasSideEffects)
+{
+    m_Passes.push_back(PassEntry {
+            .Name = strzilla::string { Name },
+            .Accesses = std::move(Accesses),
+            .Callback = std::move(Callback),
+            .HasSideEffects = HasSideEffects
+    });
+}
+
+void RenderGraph::Execute(VkCommandBuffer const &CommandBuffer)
+{
+    CullPasses();
+    RealizeTransientImages();
+
+    for (MemorySlot &SlotIter : m_MemorySlots)
+    {
+        SlotIter.LastState = {};
+    }
+
+    m_Stats.NumBarriers       = 0U;
+    m_Stats.NumBarrierBatches = 0U;
+
+    std::vector<VkImageMemoryBarrier2> Barriers;
+    Barriers.reserve(std::size(m_Resources));
+
+    auto const FlushBarriers = [&]
+    {
+        if (!std::empty(Barriers))
+        {
+            SubmitBarriers(CommandBuffer, Barriers);
+            m_Stats.NumBarriers += static_cast<std::uint32_t>(std::size(Barriers));
+            ++m_Stats.NumBarrierBatches;
+            Barriers.clear();
+        }
+    };
+
+    for (std::uint32_t PassIndex = 0U; PassIndex < std::size(m_Passes); ++PassIndex)
+    {
+        PassEntry const &Pass = m_Passes.at(PassIndex);
+
+        if (Pass.IsCulled)
+        {
+            continue;
+        }
+
+        // A transient placed in memory that an earlier transient used this frame must wait for that image's last access
+        for (TransientImage const &TransientIter : m_TransientImages)
+        {
+            if (TransientIter.FirstPass == PassIndex)
+            {
+                ResourceState const &SlotState = m_MemorySlots.at(TransientIter.MemorySlot).LastState;
+
+                m_Resources.at(TransientIter.Resource).State = ResourceState {
+                        .Layout = g_UndefinedLayout,
+                        .WriteStages = SlotState.WriteStages | SlotState.ReadStages,
+                        .WriteAccess = SlotState.WriteAccess,
+                        .ReadStages = VK_PIPELINE_STAGE_2_NONE
+                };
+            }
+        }
+
+        for (auto const &[Resource, Access] : Pass.Accesses)
+        {
+            auto const [Layout, Stages, AccessMask, IsWrite] = GetAccessInfo(Access);
+            TransitionResource(m_Resources.at(Resource), Layout, Stages, AccessMask, IsWrite, Barriers);
+        }
+
+        FlushBarriers();
+
+        if (Pass.Callback)
+        {
+            Pass.Callback(CommandBuffer, *this);
+        }
+
+        for (TransientImage const &TransientIter : m_TransientImages)
+        {
+            if (TransientIter.LastPass == PassIndex)
+            {
+                m_MemorySlots.at(TransientIter.MemorySlot).LastState = m_Resources.at(TransientIter.Resource).State;
+            }
+        }
+    }
+
+    for (ResourceEntry &ResourceIter : m_Resources)
+    {
+        if (ResourceIter.IsTransient || ResourceIter.FinalLayout == g_UndefinedLayout || ResourceIter.State.Layout == ResourceIter.FinalLayout)
+        {
+            continue;
+        }
+
+        auto const [Layout, Stages, AccessMask, IsWrite] = GetFinalAccessInfo(ResourceIter.FinalLayout);
+        TransitionResource(ResourceIter, Layout, Stages, AccessMask, IsWrite, Barriers);
+    }
+
+    FlushBarriers();
+}
+
+void RenderGraph::Reset()
+{
+    m_Resources.clear();
+    m_Passes.clear();
+}
+
+void RenderGraph::Release()
+{
+    Reset();
+    ReleaseTransientImages();
+    m_Stats = {};
+}
+
+ImageAllocation const &RenderGraph::GetImage(RenderGraphResource const Resource) const
+{
+    return m_Resources.at(Resource).Image;
+}
+
+void RenderGraph::CullPasses()
+{
+    std::vector<bool> IsResourceNeeded(std::size(m_Resources), false);
+
+    for (std::size_t Iterator = 0U; Iterator < std::size(m_Resources); ++Iterator)
+    {
+        IsResourceNeeded.at(Iterator) = m_Resources.at(Iterator).IsOutput;
+    }
+
+    m_Stats.NumPasses       = static_cast<std::uint32_t>(std::size(m_Passes));
+    m_Stats.NumCulledPasses = 0U;
+
+    for (auto PassIt = std::rbegin(m_Passes); PassIt != std::rend(m_Passes); ++PassIt)
+    {
+        PassIt->IsCulled = !PassIt->HasSideEffects && std::ranges::none_of(PassIt->Accesses,
+                                                                           [&](auto const &AccessIter)
+                                                                           {
+                                                                               return GetAccessInfo(AccessIter.second).IsWrite &&
+                                                                                      IsResourceNeeded.at(AccessIter.first);
+                                                                           });
+
+        if (PassIt->IsCulled)
+        {
+            ++m_Stats.NumCulledPasses;
+            continue;
+        }
+
+        for (auto const &[Resource, Access] : PassIt->Accesses)
+        {
+            if (!GetAccessInfo(Access).IsWrite)
+            {
+                IsResourceNeeded.at(Resource) = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::RealizeTransientImages()
+{
+    constexpr auto InvalidPass = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector FirstPasses(std::size(m_Resources), InvalidPass);
+    std::vector LastPasses(std::size(m_Resources), InvalidPass);
+
+    for (std::uint32_t PassIndex = 0U; PassIndex < std::size(m_Passes); ++PassIndex)
+    {
+        if (m_Passes.at(PassIndex).IsCulled)
+        {
+            continue;
+        }
+
+        for (RenderGraphResource const Resource : m_Passes.at(PassIndex).Accesses | std::views::keys)
+        {
+            if (FirstPasses.at(Resource) == InvalidPass)
+            {
+                FirstPasses.at(Resource) = PassIndex;
+            }
+
+            LastPasses.at(Resource) = PassIndex;
+        }
+    }
+
+    std::vector<TransientImage> Requested;
+
+    for (RenderGraphResource Resource = 0U; Resource < std::size(m_Resources); ++Resource)
+    {
+        if (m_Resources.at(Resource).IsTransient && FirstPasses.at(Resource) != InvalidPass)
+        {
+            Requested.push_back(TransientImage {
+                    .Description = m_Resources.at(Resource).Description,
+                    .Resource = Resource,
+                    .FirstPass = FirstPasses.at(Resource),
+                    .LastPass = LastPasses.at(Resource)
+            });
+        }
+    }
+
+    bool const IsCached = std::size(Requested) == std::size(m_TransientImages) && std::ranges::equal(Requested,
+                              m_TransientImages,
+                              [](TransientImage const &Lhs, TransientImage const &Rhs)
+                              {
+                                  return IsSameDescription(Lhs.Description, Rhs.Description) && Lhs.FirstPass == Rhs.FirstPass &&
+                                         Lhs.LastPass == Rhs.LastPass;
+                              });
+
+    if (IsCached)
+    {
+        for (std::uint32_t Iterator = 0U; Iterator < std::size(Requested); ++Iterator)
+        {
+            m_TransientImages.at(Iterator).Resource = Requested.at(Iterator).Resource;
+        }
+    }
+    else
+    {
+        ReleaseTransientImages();
+        m_TransientImages = std::move(Requested);
+
+        VkDevice const &    LogicalDevice = GetLogicalDevice();
+        VmaAllocator const &Allocator     = GetAllocator();
+
+        for (TransientImage &ImageIter : m_TransientImages)
+        {
+            auto const &[Format, Extent, Usage, Aspect] = ImageIter.Description;
+
+            VkImageCreateInfo const ImageCreateInfo {
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                    .imageType = VK_IMAGE_TYPE_2D,
+                    .format = Format,
+                    .extent = { .width = Extent.width, .height = Extent.height, .depth = 1U },
+                    .mipLevels = 1U,
+                    .arrayLayers = 1U,
+                    .samples = g_MSAASamples,
+                    .tiling = g_ImageTiling,
+                    .usage = Usage,
+                    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                    .initialLayout = g_UndefinedLayout
+            };
+
+            CheckVulkanResult(vkCreateImage(LogicalDevice, &ImageCreateInfo, nullptr, &ImageIter.Image.Image));
+            vkGetImageMemoryRequirements(LogicalDevice, ImageIter.Image.Image, &ImageIter.Requirements);
+
+            ImageIter.Image.Extent = Extent;
+            ImageIter.Image.Format = Format;
+        }
+
+        std::vector<std::uint32_t> PlacementOrder(std::size(m_TransientImages));
+        std::iota(std::begin(PlacementOrder), std::end(PlacementOrder), 0U);
+
+        std::ranges::stable_sort(PlacementOrder,
+                                 [this](std::uint32_t const Lhs, std::uint32_t const Rhs)
+                                 {
+                                     return m_TransientImages.at(Lhs).FirstPass < m_TransientImages.at(Rhs).FirstPass;
+                                 });
+
+        // Greedy interval placement: reuse the first slot whose last user finished before this image starts and that shares a memory type
+        for (std::uint32_t const ImageIndex : PlacementOrder)
+        {
+            TransientImage &ImageIter = m_TransientImages.at(ImageIndex);
+
+            auto const SlotIt = std::ranges::find_if(m_MemorySlots,
+                                                     [&ImageIter](MemorySlot const &SlotIter)
+                                                     {
+                                                         return SlotIter.LastPass < ImageIter.FirstPass &&
+                                                                (SlotIter.Requirements.memoryTypeBits & ImageIter.Requirements.memoryTypeBits) != 0U;
+                                                     });
+
+            if (SlotIt == std::end(m_MemorySlots))
+            {
+                ImageIter.MemorySlot = static_cast<std::uint32_t>(std::size(m_MemorySlots));
+                m_MemorySlots.push_back(MemorySlot { .Requirements = ImageIter.Requirements, .LastPass = ImageIter.LastPass });
+                continue;
+            }
+
+            ImageIter.MemorySlot                  = static_cast<std::uint32_t>(std::distance(std::begin(m_MemorySlots), SlotIt));
+            SlotIt->Requirements.size           = std::max(SlotIt->Requirements.size, ImageIter.Requirements.size);
+            SlotIt->Requirements.alignment      = std::max(SlotIt->Requirements.alignment, ImageIter.Requirements.alignment);
+            SlotIt->Requirements.memoryTypeBits &= ImageIter.Requirements.memoryTypeBits;
+            SlotIt->LastPass                    = ImageIter.LastPass;
+        }
+
+        constexpr VmaAllocationCreateInfo AllocationCreateInfo { .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, .priority = 1.F };
+
+        for (MemorySlot &SlotIter : m_MemorySlots)
+        {
+            CheckVulkanResult(vmaAllocateMemory(Allocator, &SlotIter.Requirements, &AllocationCreateInfo, &SlotIter.Allocation, nullptr));
+            vmaSetAllocationName(Allocator, SlotIter.Allocation, "Render Graph Transient Memory");
+        }
+
+        m_Stats.TransientMemoryRequested = 0U;
+        m_Stats.TransientMemoryAllocated = 0U;
+
+        for (TransientImage &ImageIter : m_TransientImages)
+        {
+            ImageIter.Image.Allocation = m_MemorySlots.at(ImageIter.MemorySlot).Allocation;
+            CheckVulkanResult(vmaBindImageMemory(Allocator, ImageIter.Image.Allocation, ImageIter.Image.Image));
+            CreateImageView(ImageIter.Image.Image, ImageIter.Image.Format, ImageIter.Description.Aspect, ImageIter.Image.View);
+
+            m_Stats.TransientMemoryRequested += ImageIter.Requirements.size;
+        }
+
+        for (MemorySlot const &SlotIter : m_MemorySlots)
+        {
+            m_Stats.TransientMemoryAllocated += SlotIter.Requirements.size;
+        }
+
+        m_Stats.NumTransientImages      = static_cast<std::uint32_t>(std::size(m_TransientImages));
+        m_Stats.NumTransientAllocations = static_cast<std::uint32_t>(std::size(m_MemorySlots));
+
+        BOOST_LOG_TRIVIAL(debug) << "[" << __func__ << "]: Placed " << m_Stats.NumTransientImages << " transient images in "
+                                 << m_Stats.NumTransientAllocations << " allocations (" << m_Stats.TransientMemoryAllocated << " of "
+                                 << m_Stats.TransientMemoryRequested << " bytes)";
+    }
+
+    for (std::uint32_t Iterator = 0U; Iterator < std::size(m_TransientImages); ++Iterator)
+    {
+        ResourceEntry &Resource = m_Resources.at(m_TransientImages.at(Iterator).Resource);
+        Resource.TransientIndex = Iterator;
+        Resource.Image          = m_TransientImages.at(Iterator).Image;
+    }
+}
+
+void RenderGraph::ReleaseTransientImages()
+{
+    if (std::empty(m_TransientImages) && std::empty(m_MemorySlots))
+    {
+        return;
+    }
+
+    VkDevice const &    LogicalDevice = GetLogicalDevice();
+    VmaAllocator const &Allocator     = GetAllocator();
+
+    for (TransientImage &ImageIter : m_TransientImages)
+    {
+        if (ImageIter.Image.View != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(LogicalDevice, ImageIter.Image.View, nullptr);
+        }
+
+        if (ImageIter.Image.Image != VK_NULL_HANDLE)
+        {
+            vkDestroyImage(LogicalDevice, ImageIter.Image.Image, nullptr);
+        }
+    }
+
+    for (MemorySlot const &SlotIter : m_MemorySlots)
+    {
+        if (SlotIter.Allocation != VK_NULL_HANDLE)
+        {
+            vmaFreeMemory(Allocator, SlotIter.Allocation);
+        }
+    }
+
+    m_TransientImages.clear();
+    m_MemorySlots.clear();
+}
+
+void RenderGraph::TransitionResource(ResourceEntry &                     Resource,
+                                     VkImageLayout const                 Layout,
+                                     VkPipelineStageFlags2 const         Stages,
+                                     VkAccessFlags2 const                Access,
+                                     bool const                          IsWrite,
+                                     std::vector<VkImageMemoryBarrier2> &Barriers)
+{
+    ResourceState &State = Resource.State;
+
+    bool const HasLayoutChange = State.Layout != Layout;
+    bool const HasWriteHazard  = IsWrite && (State.WriteStages | State.ReadStages) != VK_PIPELINE_STAGE_2_NONE;
+    bool const HasReadHazard   = !IsWrite && State.WriteAccess != VK_ACCESS_2_NONE && (Stages & ~State.ReadStages) != VK_PIPELINE_STAGE_2_NONE;
+
+    if (!HasLayoutChange && !HasWriteHazard && !HasReadHazard)
+    {
+        State.ReadStages |= IsWrite ? VK_PIPELINE_STAGE_2_NONE : Stages;
+        return;
+    }
+
+    VkPipelineStageFlags2 SourceStages = State.WriteStages;
+
+    if (IsWrite || HasLayoutChange)
+    {
+        SourceStages |= State.ReadStages;
+    }
+
+    // Nothing touched the image yet in this graph: chain the transition to the destination scope so semaphore waits on it still apply
+    if (SourceStages == VK_PIPELINE_STAGE_2_NONE)
+    {
+        SourceStages = Stages;
+    }
+
+    VkImageAspectFlags AspectMask = Resource.Description.Aspect;
+
+    if (HasFlag<VkImageAspectFlags>(AspectMask, g_DepthAspect) && DepthHasStencil(Resource.Image.Format))
+    {
+        AspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    Barriers.push_back(VkImageMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = SourceStages,
+            .srcAccessMask = State.WriteAccess,
+            .dstStageMask = Stages,
+            .dstAccessMask = Access,
+            .oldLayout = State.Layout,
+            .newLayout = Layout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = Resource.Image.Image,
+            .subresourceRange = {
+                    .aspectMask = AspectMask,
+                    .baseMipLevel = 0U,
+                    .levelCount = VK_REMAINING_MIP_LEVELS,
+                    .baseArrayLayer = 0U,
+                    .layerCount = VK_REMAINING_ARRAY_LAYERS
+            }
+    });
+
+    if (IsWrite)
+    {
+        State = ResourceState { .Layout = Layout, .WriteStages = Stages, .WriteAccess = Access, .ReadStages = VK_PIPELINE_STAGE_2_NONE };
+    }
+    else
+    {
+        State.Layout = Layout;
+        State.ReadStages |= Stages;
+    }
+}
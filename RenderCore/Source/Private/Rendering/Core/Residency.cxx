@@ -0,0 +1,433 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Residency;
+
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Scene;
+import RenderCore.Runtime.SwapChain;
+import RenderCore.Runtime.Synchronization;
+import RenderCore.Runtime.Upload;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.Transform;
+
+using namespace RenderCore;
+
+struct TextureResidency
+{
+    std::weak_ptr<Texture>                  Owner {};
+    std::vector<std::vector<unsigned char>> Levels {};
+    VkExtent2D                              Extent {};
+    VkDeviceSize                            Size { 0U };
+    std::uint64_t                           LastUsedFrame { 0U };
+    std::uint32_t                           TailLevel { 0U };
+    std::uint32_t                           ResidentLevel { 0U };
+    std::uint32_t                           RequestedLevel { 0U };
+    bool                                    IsResident { true };
+    bool                                    IsRestoring { false };
+    bool                                    IsStreaming { false };
+};
+
+// Keyed by image allocation ID
+std::unordered_map<std::uint32_t, TextureResidency> g_TextureResidency {};
+std::uint64_t                                       g_ResidencyFrame { 0U };
+VkDeviceSize                                        g_RetiringTextureBytes { 0U };
+std::uint64_t                                       g_NumTextureEvictions { 0U };
+std::uint64_t                                       g_NumTextureRestores { 0U };
+std::uint64_t                                       g_NumStreamedLevels { 0U };
+VkDeviceSize                                        g_StreamedTextureBytes { 0U };
+
+void RefreshTextureDescriptors(std::vector<std::uint32_t> const &IDs)
+{
+    if (std::empty(IDs))
+    {
+        return;
+    }
+
+    for (std::uint32_t const IDIter : IDs)
+    {
+        if (auto const MatchingIter = g_TextureResidency.find(IDIter);
+            MatchingIter != std::end(g_TextureResidency))
+        {
+            if (std::shared_ptr<Texture> const Owner = MatchingIter->second.Owner.lock())
+            {
+                Owner->SetupTexture();
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<Object>> AffectedObjects;
+
+    for (auto const &ObjectIter : GetObjects())
+    {
+        auto const &Mesh = ObjectIter->GetMesh();
+        if (!Mesh)
+        {
+            continue;
+        }
+
+        if (std::ranges::any_of(Mesh->GetTextures(),
+                                [&IDs](std::shared_ptr<Texture> const &TextureIter)
+                                {
+                                    return std::ranges::find(IDs, TextureIter->GetBufferIndex()) != std::end(IDs);
+                                }))
+        {
+            AffectedObjects.push_back(ObjectIter);
+        }
+    }
+
+    // Frames in flight keep reading their own copy of the descriptors, which still points to a live view: replaced views are retired with
+    // them. Each copy is rewritten when its frame slot is recorded again.
+    for (auto const &ObjectIter : AffectedObjects)
+    {
+        ObjectIter->InvalidateTextureFrames();
+    }
+}
+
+// Pixels covered on screen by the bounding sphere of the mesh, from its distance to the camera and the vertical field of view
+float EstimateScreenSize(Camera const &Camera, Mesh const &Mesh, float const ProjectionScale)
+{
+    Bounds const &MeshBounds = Mesh.GetBounds();
+
+    float const Radius   = length(MeshBounds.Max - MeshBounds.Min) * 0.5F;
+    float const Distance = std::max(length(Mesh.GetCenter() - Camera.GetPosition()) - Radius, Camera.GetNearPlane());
+
+    return 2.F * Radius * ProjectionScale / Distance;
+}
+
+// Finest level worth having when the whole texture is mapped once over the screen size of the mesh
+std::uint32_t GetRequiredLevel(TextureResidency const &Residency, float const ScreenSize)
+{
+    auto const TextureSize = static_cast<float>(std::max(Residency.Extent.width, Residency.Extent.height));
+    if (ScreenSize >= TextureSize)
+    {
+        return 0U;
+    }
+
+    auto const Level = static_cast<std::uint32_t>(std::floor(std::log2(TextureSize / std::max(ScreenSize, 1.F))));
+    return std::min(Level, Residency.TailLevel);
+}
+
+void StreamTextureLevels()
+{
+    // Textures furthest from the level they need go first
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> Candidates;
+
+    for (auto const &[IDIter, Residency] : g_TextureResidency)
+    {
+        if (Residency.IsResident && !Residency.IsRestoring && !Residency.IsStreaming && Residency.RequestedLevel < Residency.ResidentLevel)
+        {
+            Candidates.emplace_back(Residency.ResidentLevel - Residency.RequestedLevel, IDIter);
+        }
+    }
+
+    if (std::empty(Candidates))
+    {
+        return;
+    }
+
+    std::ranges::sort(Candidates, std::ranges::greater {});
+
+    VkCommandBuffer                                      CommandBuffer = VK_NULL_HANDLE;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> StreamedLevels;
+    VkDeviceSize                                         StreamedBytes = 0U;
+
+    // One level per texture and frame, so the budget is shared among every texture that needs finer levels
+    for (std::uint32_t const IDIter : Candidates | std::views::values)
+    {
+        TextureResidency &Residency = g_TextureResidency.at(IDIter);
+
+        std::uint32_t const               Level     = Residency.ResidentLevel - 1U;
+        std::vector<unsigned char> const &LevelData = Residency.Levels.at(Level);
+
+        if (!std::empty(StreamedLevels) && StreamedBytes + std::size(LevelData) > g_StreamingBandwidth)
+        {
+            continue;
+        }
+
+        if (CommandBuffer == VK_NULL_HANDLE)
+        {
+            CommandBuffer = BeginUpload();
+        }
+
+        QueueImageLevelUpload(CommandBuffer, IDIter, Level, std::data(LevelData), std::size(LevelData));
+
+        Residency.IsStreaming = true;
+        StreamedBytes += std::size(LevelData);
+        StreamedLevels.emplace_back(IDIter, Level);
+    }
+
+    g_StreamedTextureBytes += StreamedBytes;
+
+    SubmitUpload(CommandBuffer,
+                 [StreamedLevels]
+                 {
+                     std::vector<std::uint32_t> Refreshed;
+
+                     for (auto const &[IDIter, Level] : StreamedLevels)
+                     {
+                         auto const MatchingIter = g_TextureResidency.find(IDIter);
+                         if (MatchingIter == std::end(g_TextureResidency) || MatchingIter->second.Owner.expired())
+                         {
+                             continue;
+                         }
+
+                         TextureResidency &Residency = MatchingIter->second;
+                         Residency.IsStreaming       = false;
+
+                         SetImageAllocationBaseLevel(IDIter, Level);
+                         Residency.ResidentLevel = Level;
+                         ++g_NumStreamedLevels;
+
+                         // Nothing left to stream and, without a budget, nothing to restore later
+                         if (Level == 0U && g_ResidencyBudget == 0U)
+                         {
+                             Residency.Levels = {};
+                         }
+
+                         Refreshed.push_back(IDIter);
+                     }
+
+                     RefreshTextureDescriptors(Refreshed);
+                 });
+}
+
+void RenderCore::RegisterTextureResidency(std::shared_ptr<Texture> const &Texture, TextureMipChain &&MipChain)
+{
+    if (!Texture || std::empty(MipChain.Levels) || (g_ResidencyBudget == 0U && MipChain.TailLevel == 0U))
+    {
+        return;
+    }
+
+    std::uint32_t const ID = Texture->GetBufferIndex();
+
+    g_TextureResidency.insert_or_assign(ID,
+                                        TextureResidency {
+                                                .Owner = Texture,
+                                                .Levels = std::move(MipChain.Levels),
+                                                .Extent = MipChain.Extent,
+                                                .Size = GetImageAllocationSize(ID),
+                                                .LastUsedFrame = g_ResidencyFrame,
+                                                .TailLevel = MipChain.TailLevel,
+                                                .ResidentLevel = MipChain.TailLevel,
+                                                .RequestedLevel = MipChain.TailLevel
+                                        });
+}
+
+void RenderCore::UpdateTextureResidency(SceneSnapshot const &Snapshot)
+{
+    if (std::empty(g_TextureResidency))
+    {
+        return;
+    }
+
+    ++g_ResidencyFrame;
+
+    std::erase_if(g_TextureResidency,
+                  [](auto const &EntryIter)
+                  {
+                      return EntryIter.second.Owner.expired();
+                  });
+
+    for (TextureResidency &Residency : g_TextureResidency | std::views::values)
+    {
+        Residency.RequestedLevel = Residency.ResidentLevel;
+    }
+
+    VkExtent2D const &ViewportExtent  = GetSwapChainExtent();
+    float const       ProjectionScale = static_cast<float>(ViewportExtent.height) / (2.F * std::tan(glm::radians(Snapshot.Camera.GetFieldOfView()) * 0.5F));
+
+    std::vector<std::uint32_t> PendingRestores;
+
+    for (ObjectSnapshot const &SnapshotIter : Snapshot.Objects)
+    {
+        auto const &Object = SnapshotIter.Object;
+        auto const &Mesh   = Object->GetMesh();
+
+        if (!Mesh || Object->IsPendingDestroy() || !Snapshot.Camera.CanDrawObject(Object))
+        {
+            continue;
+        }
+
+        float const ScreenSize = g_UseTextureStreaming ? EstimateScreenSize(Snapshot.Camera, *Mesh, ProjectionScale) : 0.F;
+
+        for (auto const &TextureIter : Mesh->GetTextures())
+        {
+            auto const MatchingIter = g_TextureResidency.find(TextureIter->GetBufferIndex());
+            if (MatchingIter == std::end(g_TextureResidency))
+            {
+                continue;
+            }
+
+            TextureResidency &Residency = MatchingIter->second;
+            Residency.LastUsedFrame     = g_ResidencyFrame;
+
+            if (!Residency.IsResident && !Residency.IsRestoring)
+            {
+                Residency.IsRestoring = true;
+                PendingRestores.push_back(MatchingIter->first);
+            }
+
+            if (g_UseTextureStreaming && Residency.ResidentLevel > 0U)
+            {
+                Residency.RequestedLevel = std::min(Residency.RequestedLevel, GetRequiredLevel(Residency, ScreenSize));
+            }
+        }
+    }
+
+    // Objects keep drawing with the empty texture until their textures are back on the GPU. Only the tail is uploaded again, streaming
+    // brings the finer levels back as the texture asks for them.
+    if (!std::empty(PendingRestores))
+    {
+        VkCommandBuffer const CommandBuffer = BeginUpload();
+
+        for (std::uint32_t const IDIter : PendingRestores)
+        {
+            TextureResidency const &Residency = g_TextureResidency.at(IDIter);
+
+            RecreateImageAllocation(IDIter);
+
+            for (std::uint32_t Level = Residency.TailLevel; Level < std::size(Residency.Levels); ++Level)
+            {
+                std::vector<unsigned char> const &LevelData = Residency.Levels.at(Level);
+                QueueImageLevelUpload(CommandBuffer, IDIter, Level, std::data(LevelData), std::size(LevelData));
+            }
+
+            // Textures without a CPU chain get their smaller levels blitted again
+            QueueImageMipGeneration(CommandBuffer, IDIter, static_cast<std::uint32_t>(std::size(Residency.Levels)) - 1U);
+        }
+
+        SubmitUpload(CommandBuffer,
+                     [PendingRestores]
+                     {
+                         for (std::uint32_t const IDIter : PendingRestores)
+                         {
+                             if (auto const MatchingIter = g_TextureResidency.find(IDIter);
+                                 MatchingIter != std::end(g_TextureResidency) && !MatchingIter->second.Owner.expired())
+                             {
+                                 TextureResidency &Residency = MatchingIter->second;
+
+                                 SetImageAllocationBaseLevel(IDIter, Residency.TailLevel);
+
+                                 Residency.ResidentLevel = Residency.TailLevel;
+                                 Residency.IsResident    = true;
+                                 Residency.IsRestoring   = false;
+                                 ++g_NumTextureRestores;
+                             }
+                         }
+
+                         RefreshTextureDescriptors(PendingRestores);
+                     });
+    }
+
+    if (g_UseTextureStreaming)
+    {
+        StreamTextureLevels();
+    }
+
+    if (g_ResidencyBudget == 0U)
+    {
+        return;
+    }
+
+    DeviceMemoryUsage const MemoryUsage = GetDeviceMemoryUsage();
+    VkDeviceSize const      Limit       = MemoryUsage.BudgetBytes > 0U ? std::min(g_ResidencyBudget, MemoryUsage.BudgetBytes) : g_ResidencyBudget;
+
+    // Allocation bytes instead of the heap usage: evicting from a pool block frees its range, not the block. Evictions still waiting on
+    // their frames count as freed already.
+    VkDeviceSize AllocatedBytes = MemoryUsage.AllocatedBytes - std::min(MemoryUsage.AllocatedBytes, g_RetiringTextureBytes);
+
+    if (AllocatedBytes <= Limit)
+    {
+        return;
+    }
+
+    // Textures drawn by a frame that may still be in flight are not candidates, neither are the ones that could not be uploaded again
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> Candidates;
+
+    for (auto const &[IDIter, Residency] : g_TextureResidency)
+    {
+        if (Residency.IsResident && !Residency.IsRestoring && !Residency.IsStreaming && !std::empty(Residency.Levels) &&
+            Residency.LastUsedFrame + GetFramesInFlight() < g_ResidencyFrame)
+        {
+            Candidates.emplace_back(Residency.LastUsedFrame, IDIter);
+        }
+    }
+
+    std::ranges::sort(Candidates);
+
+    std::vector<std::uint32_t> Evicted;
+
+    for (std::uint32_t const IDIter : Candidates | std::views::values)
+    {
+        if (AllocatedBytes <= Limit)
+        {
+            break;
+        }
+
+        TextureResidency &Residency = g_TextureResidency.at(IDIter);
+
+        EvictImageAllocation(IDIter);
+        Residency.IsResident = false;
+
+        AllocatedBytes -= std::min(AllocatedBytes, Residency.Size);
+        g_RetiringTextureBytes += Residency.Size;
+
+        RetireResource([Size = Residency.Size]
+        {
+            g_RetiringTextureBytes -= std::min(g_RetiringTextureBytes, Size);
+        });
+
+        ++g_NumTextureEvictions;
+        Evicted.push_back(IDIter);
+    }
+
+    RefreshTextureDescriptors(Evicted);
+}
+
+void RenderCore::ReleaseTextureResidency()
+{
+    g_TextureResidency.clear();
+    g_ResidencyFrame       = 0U;
+    g_RetiringTextureBytes = 0U;
+    g_NumTextureEvictions  = 0U;
+    g_NumTextureRestores   = 0U;
+    g_NumStreamedLevels    = 0U;
+    g_StreamedTextureBytes = 0U;
+}
+
+TextureResidencyStats RenderCore::GetTextureResidencyStats()
+{
+    TextureResidencyStats Output {
+            .NumEvictions = g_NumTextureEvictions,
+            .NumRestores = g_NumTextureRestores,
+            .NumStreamedLevels = g_NumStreamedLevels,
+            .StreamedBytes = g_StreamedTextureBytes
+    };
+
+    for (TextureResidency const &Residency : g_TextureResidency | std::views::values)
+    {
+        if (Residency.IsResident)
+        {
+            Output.ResidentBytes += Residency.Size;
+            ++Output.NumResident;
+
+            if (Residency.ResidentLevel > 0U)
+            {
+                ++Output.NumPartiallyStreamed;
+            }
+        }
+        else
+        {
+            ++Output.NumEvicted;
+        }
+    }
+
+    return Output;
+}
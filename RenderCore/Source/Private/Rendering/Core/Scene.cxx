@@ -20,74 +20,138 @@ module RenderCore.Runtime.Scene;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Device;
 import RenderCore.Runtime.Command;
+import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Residency;
+import RenderCore.Runtime.Synchronization;
+import RenderCore.Runtime.Upload;
 import RenderCore.Factories.Mesh;
 import RenderCore.Factories.Texture;
 import RenderCore.Types.UniformBufferObject;
 import RenderCore.Types.Texture;
 import RenderCore.Types.Mesh;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
 
 using namespace RenderCore;
 
 std::mutex g_ObjectMutex {};
 
+// Few distinct samplers exist per scene, a linear search beats hashing the description
+std::mutex                                            g_SamplerMutex {};
+std::vector<std::pair<SamplerDescription, VkSampler>> g_SamplerCache {};
+
+VkSamplerAddressMode GetSamplerAddressMode(std::int32_t const Wrap)
+{
+    switch (Wrap)
+    {
+        case TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE:
+            return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        case TINYGLTF_TEXTURE_WRAP_MIRRORED_REPEAT:
+            return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+        default:
+            return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    }
+}
+
+// Undefined filters fall back to trilinear filtering
+SamplerDescription GetSamplerDescription(tinygltf::Sampler const &Sampler)
+{
+    SamplerDescription Output {
+            .MagFilter = Sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST ? VK_FILTER_NEAREST : VK_FILTER_LINEAR,
+            .AddressModeU = GetSamplerAddressMode(Sampler.wrapS),
+            .AddressModeV = GetSamplerAddressMode(Sampler.wrapT)
+    };
+
+    switch (Sampler.minFilter)
+    {
+        case TINYGLTF_TEXTURE_FILTER_NEAREST:
+            Output.MinFilter = VK_FILTER_NEAREST;
+            Output.MaxLod    = 0.F;
+            break;
+        case TINYGLTF_TEXTURE_FILTER_LINEAR:
+            Output.MaxLod = 0.F;
+            break;
+        case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST:
+            Output.MinFilter  = VK_FILTER_NEAREST;
+            Output.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            break;
+        case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST:
+            Output.MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            break;
+        case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR:
+            Output.MinFilter = VK_FILTER_NEAREST;
+            break;
+        default:
+            break;
+    }
+
+    return Output;
+}
+
 void RenderCore::CreateSceneUniformBuffer()
 {
-    constexpr VkDeviceSize BufferSize = sizeof(SceneUniformData);
+    g_SceneUniformStride = sizeof(SceneUniformData);
+
+    if (VkDeviceSize const MinAlignment = GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
+        MinAlignment > 0U)
+    {
+        g_SceneUniformStride = g_SceneUniformStride + MinAlignment - 1U & ~(MinAlignment - 1U);
+    }
+
+    VkDeviceSize const BufferSize = g_SceneUniformStride * g_MaxFramesInFlight;
     CreateUniformBuffers(m_UniformBufferAllocation.first, BufferSize, "SCENE_UNIFORM");
-    m_UniformBufferAllocation.second = { .buffer = m_UniformBufferAllocation.first.Buffer, .offset = 0U, .range = BufferSize };
+    m_UniformBufferAllocation.second = { .buffer = m_UniformBufferAllocation.first.Buffer, .offset = 0U, .range = sizeof(SceneUniformData) };
 }
 
 void RenderCore::CreateImageSampler()
 {
-    VkPhysicalDeviceProperties SurfaceProperties;
-    vkGetPhysicalDeviceProperties(GetPhysicalDevice(), &SurfaceProperties);
+    g_Sampler = AcquireSampler(SamplerDescription {});
+}
+
+VkSampler RenderCore::AcquireSampler(SamplerDescription const &Description)
+{
+    std::lock_guard Lock { g_SamplerMutex };
+
+    if (auto const MatchingIter = std::ranges::find(g_SamplerCache, Description, &std::pair<SamplerDescription, VkSampler>::first);
+        MatchingIter != std::end(g_SamplerCache))
+    {
+        return MatchingIter->second;
+    }
+
+    bool const IsTrilinear = Description.MinFilter == VK_FILTER_LINEAR && Description.MipmapMode == VK_SAMPLER_MIPMAP_MODE_LINEAR &&
+                             Description.MaxLod > 0.F;
 
     VkSamplerCreateInfo const SamplerCreateInfo {
             .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-            .magFilter = VK_FILTER_LINEAR,
-            .minFilter = VK_FILTER_LINEAR,
-            .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
-            .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+            .magFilter = Description.MagFilter,
+            .minFilter = Description.MinFilter,
+            .mipmapMode = Description.MipmapMode,
+            .addressModeU = Description.AddressModeU,
+            .addressModeV = Description.AddressModeV,
             .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
             .mipLodBias = 0.F,
-            .anisotropyEnable = VK_FALSE,
-            .maxAnisotropy = SurfaceProperties.limits.maxSamplerAnisotropy,
+            .anisotropyEnable = IsTrilinear ? VK_TRUE : VK_FALSE,
+            .maxAnisotropy = IsTrilinear ? GetPhysicalDeviceProperties().limits.maxSamplerAnisotropy : 1.F,
             .compareEnable = VK_FALSE,
             .compareOp = VK_COMPARE_OP_ALWAYS,
             .minLod = 0.F,
-            .maxLod = FLT_MAX,
+            .maxLod = Description.MaxLod,
             .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
             .unnormalizedCoordinates = VK_FALSE
     };
 
-    CheckVulkanResult(vkCreateSampler(GetLogicalDevice(), &SamplerCreateInfo, nullptr, &g_Sampler));
-}
-
-void RenderCore::CreateDepthResources(SurfaceProperties const &SurfaceProperties)
-{
-    if (g_DepthImage.IsValid())
-    {
-        VmaAllocator const &Allocator = GetAllocator();
-        g_DepthImage.DestroyResources(Allocator);
-    }
-
-    constexpr VkImageUsageFlagBits Usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    VkSampler Output { VK_NULL_HANDLE };
+    CheckVulkanResult(vkCreateSampler(GetLogicalDevice(), &SamplerCreateInfo, nullptr, &Output));
 
-    g_DepthImage.Format                  = SurfaceProperties.DepthFormat;
-    VkImageAspectFlags const DepthAspect = DepthHasStencil(g_DepthImage.Format) ? g_DepthAspect | VK_IMAGE_ASPECT_STENCIL_BIT : g_DepthAspect;
+    g_SamplerCache.emplace_back(Description, Output);
 
-    CreateImage(g_DepthImage.Format,
-                SurfaceProperties.Extent,
-                g_ImageTiling,
-                Usage,
-                g_TextureMemoryUsage,
-                "DEPTH",
-                g_DepthImage.Image,
-                g_DepthImage.Allocation);
+    return Output;
+}
 
-    CreateImageView(g_DepthImage.Image, g_DepthImage.Format, DepthAspect, g_DepthImage.View);
+std::uint32_t RenderCore::GetNumSamplers()
+{
+    std::lock_guard Lock { g_SamplerMutex };
+    return static_cast<std::uint32_t>(std::size(g_SamplerCache));
 }
 
 void RenderCore::AllocateEmptyTexture(VkFormat const TextureFormat)
@@ -96,29 +160,28 @@ void RenderCore::AllocateEmptyTexture(VkFormat const TextureFormat)
     constexpr std::uint32_t                                DefaultTextureSize { DefaultTextureHalfSize * DefaultTextureHalfSize };
     constexpr std::array<std::uint8_t, DefaultTextureSize> DefaultTextureData {};
 
-    VkCommandPool                CommandPool { VK_NULL_HANDLE };
-    std::vector<VkCommandBuffer> CommandBuffers(1U, VK_NULL_HANDLE);
-
-    auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
-
-    InitializeSingleCommandQueue(CommandPool, CommandBuffers, FamilyIndex);
-    auto const [Index, Buffer, Allocation] = AllocateTexture(CommandBuffers.at(0U),
-                                                             std::data(DefaultTextureData),
-                                                             DefaultTextureHalfSize,
-                                                             DefaultTextureHalfSize,
-                                                             TextureFormat,
-                                                             DefaultTextureSize * DefaultTextureSize);
+    VkCommandBuffer const CommandBuffer = BeginUpload();
 
-    FinishSingleCommandQueue(Queue, CommandPool, CommandBuffers);
+    std::ignore = AllocateTexture(CommandBuffer,
+                                  std::data(DefaultTextureData),
+                                  DefaultTextureHalfSize,
+                                  DefaultTextureHalfSize,
+                                  TextureFormat,
+                                  DefaultTextureSize * DefaultTextureSize);
 
-    VmaAllocator const &Allocator = GetAllocator();
-    vmaDestroyBuffer(Allocator, Buffer, Allocation);
+    SubmitUpload(CommandBuffer, {});
 }
 
-void RenderCore::LoadScene(strzilla::string_view const ModelPath)
+void RenderCore::LoadScene(strzilla::string_view const ModelPath, std::function<void(std::vector<std::shared_ptr<Object>> const &)> &&OnLoaded)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
+    std::vector<std::shared_ptr<Object>> NewObjects {};
+
     tinygltf::Model Model {};
     {
+        RENDERCORE_PROFILE_SCOPE("ParseGLTF");
+
         tinygltf::TinyGLTF          ModelLoader {};
         std::string                 Error {};
         std::string                 Warning {};
@@ -143,17 +206,11 @@ void RenderCore::LoadScene(strzilla::string_view const ModelPath)
         }
     }
 
-    VkCommandPool                CommandPool { VK_NULL_HANDLE };
-    std::vector<VkCommandBuffer> CommandBuffers { VK_NULL_HANDLE };
-
-    auto const &                                                [QueueIndex, Queue] = GetGraphicsQueue();
-    std::unordered_map<VkBuffer, VmaAllocation>                 BufferAllocations {};
-    std::unordered_map<std::uint32_t, std::shared_ptr<Texture>> TextureMap {};
+    std::unordered_map<std::uint32_t, std::shared_ptr<Texture>>     TextureMap {};
+    std::vector<std::pair<std::shared_ptr<Texture>, TextureMipChain>> ManagedTextures {};
 
-    InitializeSingleCommandQueue(CommandPool, CommandBuffers, QueueIndex);
+    VkCommandBuffer const CommandBuffer = BeginUpload();
     {
-        VkCommandBuffer &CommandBuffer = CommandBuffers.at(0U);
-
         for (std::uint32_t Iterator = 0U; Iterator < std::size(Model.textures); ++Iterator)
         {
             tinygltf::Texture const &TextureIter = Model.textures.at(Iterator);
@@ -165,16 +222,28 @@ void RenderCore::LoadScene(strzilla::string_view const ModelPath)
             TextureConstructionInputParameters Input {
                     .ID = FetchID(),
                     .Image = Model.images.at(TextureIter.source),
+                    .Sampler = TextureIter.sampler >= 0 ? AcquireSampler(GetSamplerDescription(Model.samplers.at(TextureIter.sampler))) : VK_NULL_HANDLE,
                     .AllocationCmdBuffer = CommandBuffer
             };
 
-            TextureConstructionOutputParameters Output {};
-
-            if (std::shared_ptr<Texture> NewTexture = ConstructTexture(Input, Output);
-                NewTexture)
+            if (GetUseTextureStreaming())
+            {
+                if (TextureMipChain MipChain = GenerateMipChain(Input.Image);
+                    std::shared_ptr<Texture> NewTexture = ConstructStreamedTexture(Input, MipChain))
+                {
+                    ManagedTextures.emplace_back(NewTexture, std::move(MipChain));
+                    TextureMap.emplace(Iterator, std::move(NewTexture));
+                }
+            }
+            else if (std::shared_ptr<Texture> NewTexture = ConstructTexture(Input);
+                     NewTexture)
             {
+                if (GetResidencyBudget() > 0U)
+                {
+                    ManagedTextures.emplace_back(NewTexture, TextureMipChain { .Levels = { Input.Image.image } });
+                }
+
                 TextureMap.emplace(Iterator, std::move(NewTexture));
-                BufferAllocations.emplace(std::move(Output.StagingBuffer), std::move(Output.StagingAllocation));
             }
         }
 
@@ -208,42 +277,55 @@ void RenderCore::LoadScene(strzilla::string_view const ModelPath)
                     NewMesh->Optimize();
                     NewObject->SetMesh(std::move(NewMesh));
 
-                    g_Objects.push_back(std::move(NewObject));
+                    NewObjects.push_back(std::move(NewObject));
                 }
             }
         }
-
-        AllocateModelsBuffers(g_Objects);
     }
-    FinishSingleCommandQueue(Queue, CommandPool, CommandBuffers);
 
-    VmaAllocator const &Allocator = GetAllocator();
-    for (auto &[Buffer, Allocation] : BufferAllocations)
-    {
-        vmaDestroyBuffer(Allocator, Buffer, Allocation);
-    }
+    AllocateModelsGeometry(NewObjects, CommandBuffer);
+
+    // Objects only join the scene once their textures and geometry are on the GPU, the renderer keeps drawing the current scene meanwhile
+    SubmitUpload(CommandBuffer,
+                 [NewObjects = std::move(NewObjects), ManagedTextures = std::move(ManagedTextures), OnLoaded = std::move(OnLoaded)]() mutable
+                 {
+                     for (auto &[TextureIter, MipChain] : ManagedTextures)
+                     {
+                         RegisterTextureResidency(TextureIter, std::move(MipChain));
+                     }
+
+                     {
+                         std::lock_guard Lock { g_ObjectMutex };
+                         g_Objects.insert(std::end(g_Objects), std::cbegin(NewObjects), std::cend(NewObjects));
+                     }
+
+                     AllocateModelsBuffers(NewObjects);
+
+                     if (OnLoaded)
+                     {
+                         OnLoaded(NewObjects);
+                     }
+                 });
 }
 
 void RenderCore::UnloadObjects(std::vector<std::uint32_t> const &ObjectIDs)
 {
     std::lock_guard Lock { g_ObjectMutex };
 
-    std::for_each(std::execution::unseq,
-                  std::begin(ObjectIDs),
-                  std::end(ObjectIDs),
-                  [&](std::uint32_t const ObjectIDIter)
-                  {
-                      if (auto const MatchingIter = std::ranges::find_if(g_Objects,
-                                                                         [ObjectIDIter](std::shared_ptr<Object> const &ObjectIter)
-                                                                         {
-                                                                             return ObjectIter->GetID() == ObjectIDIter;
-                                                                         });
-                          MatchingIter != std::end(g_Objects))
-                      {
-                          MatchingIter->get()->Destroy();
-                          g_Objects.erase(MatchingIter);
-                      }
-                  });
+    for (std::uint32_t const ObjectIDIter : ObjectIDs)
+    {
+        if (auto const MatchingIter = std::ranges::find_if(g_Objects,
+                                                           [ObjectIDIter](std::shared_ptr<Object> const &ObjectIter)
+                                                           {
+                                                               return ObjectIter->GetID() == ObjectIDIter;
+                                                           });
+            MatchingIter != std::end(g_Objects))
+        {
+            MatchingIter->get()->Destroy();
+            ReleaseModelsBuffers(std::move(*MatchingIter));
+            g_Objects.erase(MatchingIter);
+        }
+    }
 
     if (std::empty(g_Objects))
     {
@@ -255,15 +337,20 @@ void RenderCore::ReleaseSceneResources()
 {
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
-    if (g_Sampler != VK_NULL_HANDLE)
     {
-        vkDestroySampler(LogicalDevice, g_Sampler, nullptr);
+        std::lock_guard Lock { g_SamplerMutex };
+
+        for (VkSampler const &SamplerIter : g_SamplerCache | std::views::values)
+        {
+            vkDestroySampler(LogicalDevice, SamplerIter, nullptr);
+        }
+
+        g_SamplerCache.clear();
         g_Sampler = VK_NULL_HANDLE;
     }
 
     VmaAllocator const &Allocator = GetAllocator();
     m_UniformBufferAllocation.first.DestroyResources(Allocator);
-    g_DepthImage.DestroyResources(Allocator);
 
     DestroyObjects();
 }
@@ -276,7 +363,12 @@ void RenderCore::DestroyObjects()
     {
         Object->Destroy();
     }
-    g_Objects.clear();
+
+    RetireResource([Objects = std::exchange(g_Objects, {})]
+    {
+    });
+
+    ResetModelsBuffers();
 
     g_ObjectAllocationIDCounter.fetch_sub(g_ObjectAllocationIDCounter.load());
 }
@@ -297,30 +389,71 @@ void RenderCore::TickObjects(float const DeltaTime)
                   });
 }
 
-void RenderCore::UpdateSceneUniformBuffer()
+void RenderCore::CaptureSceneSnapshot(SceneSnapshot &Snapshot)
 {
-    if (g_Camera.IsRenderDirty() || g_Illumination.IsRenderDirty())
-    {
-        constexpr auto SceneUBOSize = sizeof(SceneUniformData);
+    Snapshot.Camera    = g_Camera;
+    Snapshot.SceneData = SceneUniformData {
+            .ProjectionView = g_Camera.GetProjectionMatrix() * g_Camera.GetViewMatrix(),
+            .LightPosition = g_Illumination.GetPosition(),
+            .LightColor = g_Illumination.GetColor() * g_Illumination.GetIntensity(),
+            .AmbientLight = g_Illumination.GetAmbient()
+    };
+
+    std::lock_guard Lock { g_ObjectMutex };
 
-        SceneUniformData const UpdatedUBO {
-                .ProjectionView = g_Camera.GetProjectionMatrix() * g_Camera.GetViewMatrix(),
-                .LightPosition = g_Illumination.GetPosition(),
-                .LightColor = g_Illumination.GetColor() * g_Illumination.GetIntensity(),
-                .AmbientLight = g_Illumination.GetAmbient()
-        };
+    Snapshot.Objects.resize(std::size(g_Objects));
+
+    std::transform(std::execution::unseq,
+                   std::cbegin(g_Objects),
+                   std::cend(g_Objects),
+                   std::begin(Snapshot.Objects),
+                   [](std::shared_ptr<Object> const &ObjectIter)
+                   {
+                       return ObjectSnapshot {
+                               .Object = ObjectIter,
+                               .UniformData = ObjectIter->GetUniformData(),
+                               .NumInstances = ObjectIter->GetNumInstances(),
+                               .IsRenderDirty = ObjectIter->ConsumeRenderDirty()
+                       };
+                   });
+}
 
-        std::memcpy(m_UniformBufferAllocation.first.MappedData, &UpdatedUBO, SceneUBOSize);
-    }
+void RenderCore::UpdateSceneUniformBuffer(std::uint32_t const FrameIndex, SceneSnapshot const &Snapshot)
+{
+    std::memcpy(GetSceneUniformData(FrameIndex), &Snapshot.SceneData, sizeof(SceneUniformData));
 }
 
-void RenderCore::UpdateObjectsUniformBuffer()
+void RenderCore::UpdateObjectsUniformBuffer(std::uint32_t const FrameIndex, SceneSnapshot const &Snapshot)
 {
     std::for_each(std::execution::unseq,
-                  std::begin(g_Objects),
-                  std::end(g_Objects),
-                  [](std::shared_ptr<Object> const &ObjectIter)
+                  std::cbegin(Snapshot.Objects),
+                  std::cend(Snapshot.Objects),
+                  [FrameIndex](ObjectSnapshot const &SnapshotIter)
                   {
-                      ObjectIter->UpdateUniformBuffers();
+                      // Unloaded after the capture: its slot is on its way back to the allocator
+                      if (SnapshotIter.Object->IsPendingDestroy())
+                      {
+                          return;
+                      }
+
+                      SnapshotIter.Object->UpdateUniformBuffers(FrameIndex, SnapshotIter.UniformData, SnapshotIter.IsRenderDirty);
                   });
+}
+
+void RenderCore::UpdateObjectsTextureDescriptors(std::uint32_t const FrameIndex, SceneSnapshot const &Snapshot)
+{
+    PipelineDescriptorData const &DescriptorData = GetPipelineDescriptorData();
+
+    if (!DescriptorData.TextureData.Buffer.IsValid())
+    {
+        return;
+    }
+
+    for (ObjectSnapshot const &SnapshotIter : Snapshot.Objects)
+    {
+        if (!SnapshotIter.Object->IsPendingDestroy() && SnapshotIter.Object->ConsumeTextureFrame(FrameIndex))
+        {
+            DescriptorData.SetupTextureDescriptors(SnapshotIter.Object, FrameIndex);
+        }
+    }
 }
\ No newline at end of file
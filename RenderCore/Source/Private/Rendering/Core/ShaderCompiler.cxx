@@ -15,6 +15,8 @@ module;
 
 module RenderCore.Runtime.ShaderCompiler;
 
+import RenderCore.Utils.Profiler;
+
 using namespace RenderCore;
 
 bool CompileInternal(ShaderType const            ShaderType,
@@ -24,6 +26,8 @@ bool CompileInternal(ShaderType const            ShaderType,
                      std::int32_t const          Version,
                      std::vector<std::uint32_t> &OutSPIRVCode)
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     glslang::InitializeProcess();
 
     glslang::TShader Shader(Language);
@@ -231,14 +235,18 @@ void RenderCore::CompileDefaultShaders()
     constexpr auto GlslVersion = 450;
     constexpr auto EntryPoint  = "main";
 
-    auto const CompileAndStage = [EntryPoint, GlslVersion](strzilla::string_view const Shader, EShLanguage const Language)
+    auto const CompileAndStage = [EntryPoint, GlslVersion](std::vector<ShaderStageData> &Stages, strzilla::string_view const Shader, EShLanguage const Language)
     {
-        if (auto &[StageInfo, ShaderCode] = g_StageInfos.emplace_back();
+        if (auto &[StageInfo, ShaderCode] = Stages.emplace_back();
             CompileOrLoadIfExists(Shader, ShaderType::GLSL, EntryPoint, GlslVersion, Language, ShaderCode))
         {
             StageInfo = VkPipelineShaderStageCreateInfo {
                     .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-                    .stage = Language == EShLangVertex ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT,
+                    .stage = Language == EShLangVertex
+                                 ? VK_SHADER_STAGE_VERTEX_BIT
+                                 : Language == EShLangCompute
+                                       ? VK_SHADER_STAGE_COMPUTE_BIT
+                                       : VK_SHADER_STAGE_FRAGMENT_BIT,
                     .pName = EntryPoint
             };
         }
@@ -246,17 +254,27 @@ void RenderCore::CompileDefaultShaders()
 
     // constexpr auto TaskLang { EShLangTask };
     // constexpr auto TaskShader { DEFAULT_TASK_SHADER };
-    // CompileAndStage(TaskShader, TaskLang);
+    // CompileAndStage(g_StageInfos, TaskShader, TaskLang);
 
     // constexpr auto MeshLang { EShLangMesh };
     // constexpr auto MeshShader { DEFAULT_MESH_SHADER };
-    // CompileAndStage(MeshShader, MeshLang);
+    // CompileAndStage(g_StageInfos, MeshShader, MeshLang);
 
     constexpr auto VertexLang { EShLangVertex };
     constexpr auto VertexShader { DEFAULT_VERTEX_SHADER };
-    CompileAndStage(VertexShader, VertexLang);
+    CompileAndStage(g_StageInfos, VertexShader, VertexLang);
 
     constexpr auto FragmentLang { EShLangFragment };
     constexpr auto FragmentShader { DEFAULT_FRAGMENT_SHADER };
-    CompileAndStage(FragmentShader, FragmentLang);
+    CompileAndStage(g_StageInfos, FragmentShader, FragmentLang);
+
+    constexpr auto IndirectVertexShader { INDIRECT_VERTEX_SHADER };
+    CompileAndStage(g_IndirectStageInfos, IndirectVertexShader, VertexLang);
+
+    constexpr auto IndirectFragmentShader { INDIRECT_FRAGMENT_SHADER };
+    CompileAndStage(g_IndirectStageInfos, IndirectFragmentShader, FragmentLang);
+
+    constexpr auto ComputeLang { EShLangCompute };
+    constexpr auto CullingComputeShader { CULLING_COMPUTE_SHADER };
+    CompileAndStage(g_CullingStageInfos, CullingComputeShader, ComputeLang);
 }
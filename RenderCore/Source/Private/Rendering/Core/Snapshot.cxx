@@ -0,0 +1,42 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Snapshot;
+
+using namespace RenderCore;
+
+SceneSnapshot &RenderCore::BeginSnapshotWrite()
+{
+    g_SnapshotsFree.acquire();
+
+    SceneSnapshot &Output = g_Snapshots.at(g_SnapshotWriteIndex);
+    Output.TickIndex      = ++g_SnapshotTickCounter;
+    Output.Objects.clear();
+
+    return Output;
+}
+
+void RenderCore::PublishSnapshot()
+{
+    g_SnapshotWriteIndex = (g_SnapshotWriteIndex + 1U) % g_NumSnapshots;
+    g_SnapshotsReady.release();
+}
+
+SceneSnapshot const *RenderCore::AcquireSnapshot(std::chrono::milliseconds const Timeout)
+{
+    if (!g_SnapshotsReady.try_acquire_for(Timeout))
+    {
+        return nullptr;
+    }
+
+    return &g_Snapshots.at(g_SnapshotReadIndex);
+}
+
+void RenderCore::ReleaseSnapshot()
+{
+    g_SnapshotReadIndex = (g_SnapshotReadIndex + 1U) % g_NumSnapshots;
+    g_SnapshotsFree.release();
+}
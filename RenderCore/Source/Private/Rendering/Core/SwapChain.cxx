@@ -6,7 +6,6 @@ module;
 
 module RenderCore.Runtime.SwapChain;
 
-import RenderCore.Renderer;
 import RenderCore.Runtime.Device;
 import RenderCore.Runtime.Instance;
 import RenderCore.Runtime.Synchronization;
@@ -58,6 +57,8 @@ void RenderCore::CreateSwapChain(SurfaceProperties const &SurfaceProperties, VkS
     std::vector<VkImage> SwapChainImages(ImageCount, VK_NULL_HANDLE);
     CheckVulkanResult(vkGetSwapchainImagesKHR(LogicalDevice, g_SwapChain, &ImageCount, std::data(SwapChainImages)));
 
+    g_SwapChainImages.resize(ImageCount);
+
     std::ranges::transform(SwapChainImages,
                            std::begin(g_SwapChainImages),
                            [SurfaceProperties](VkImage const &Image)
@@ -70,23 +71,19 @@ void RenderCore::CreateSwapChain(SurfaceProperties const &SurfaceProperties, VkS
                            });
 
     CreateSwapChainImageViews(g_SwapChainImages);
+    CreatePresentationSemaphores(ImageCount);
 }
 
-bool RenderCore::RequestSwapChainImage(std::uint32_t &Output)
+bool RenderCore::RequestSwapChainImage(std::uint32_t const FrameIndex, std::uint32_t &Output)
 {
     VkDevice const &   LogicalDevice = GetLogicalDevice();
-    std::uint8_t const SyncIndex     = Output + 1U >= g_ImageCount ? 0U : Output + 1U;
-    VkSemaphore const &Semaphore     = GetImageAvailableSemaphore(SyncIndex);
-
-    if (!Renderer::GetUseDefaultSync())
-    {
-        WaitAndResetFence(SyncIndex);
-    }
+    VkSemaphore const &Semaphore     = GetImageAvailableSemaphore(FrameIndex);
 
-    return vkAcquireNextImageKHR(LogicalDevice, g_SwapChain, g_Timeout, Semaphore, VK_NULL_HANDLE, &Output) == VK_SUCCESS;
+    VkResult const AcquireResult = vkAcquireNextImageKHR(LogicalDevice, g_SwapChain, g_Timeout, Semaphore, VK_NULL_HANDLE, &Output);
+    return AcquireResult == VK_SUCCESS || AcquireResult == VK_SUBOPTIMAL_KHR;
 }
 
-void RenderCore::CreateSwapChainImageViews(std::array<ImageAllocation, g_ImageCount> &Images)
+void RenderCore::CreateSwapChainImageViews(std::vector<ImageAllocation> &Images)
 {
     std::for_each(std::execution::unseq,
                   std::begin(Images),
@@ -132,8 +129,11 @@ void RenderCore::ReleaseSwapChainResources()
         g_OldSwapChain = VK_NULL_HANDLE;
     }
 
-    vkDestroySurfaceKHR(GetInstance(), g_Surface, nullptr);
-    g_Surface = VK_NULL_HANDLE;
+    if (g_Surface != VK_NULL_HANDLE)
+    {
+        vkDestroySurfaceKHR(GetInstance(), g_Surface, nullptr);
+        g_Surface = VK_NULL_HANDLE;
+    }
 }
 
 void RenderCore::DestroySwapChainImages()
@@ -146,4 +146,6 @@ void RenderCore::DestroySwapChainImages()
                   {
                       ImageIter.DestroyResources(Allocator);
                   });
+
+    g_SwapChainImages.clear();
 }
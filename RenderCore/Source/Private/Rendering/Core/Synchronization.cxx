@@ -6,28 +6,11 @@ module;
 
 module RenderCore.Runtime.Synchronization;
 
-import RenderCore.Renderer;
 import RenderCore.Runtime.Device;
-import RenderCore.Runtime.Command;
 import RenderCore.Utils.Helpers;
 
 using namespace RenderCore;
 
-void RenderCore::WaitAndResetFence(std::uint32_t const Index)
-{
-    if (!Renderer::GetUseDefaultSync() && g_Fences.at(Index) == VK_NULL_HANDLE || !g_FenceInUse.at(Index))
-    {
-        return;
-    }
-
-    VkDevice const &LogicalDevice = GetLogicalDevice();
-    CheckVulkanResult(vkWaitForFences(LogicalDevice, 1U, &g_Fences.at(Index), VK_FALSE, g_Timeout));
-    CheckVulkanResult(vkResetFences(LogicalDevice, 1U, &g_Fences.at(Index)));
-    g_FenceInUse.at(Index) = false;
-
-    ResetCommandPool(Index);
-}
-
 void RenderCore::CreateSynchronizationObjects()
 {
     VkDevice const &LogicalDevice = GetLogicalDevice();
@@ -38,18 +21,21 @@ void RenderCore::CreateSynchronizationObjects()
         CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
     }
 
-    for (auto &Semaphore : g_RenderFinishedSemaphores)
-    {
-        CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
-    }
-
-    constexpr VkFenceCreateInfo FenceCreateInfo { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, .flags = VK_FENCE_CREATE_SIGNALED_BIT };
-    for (auto &Fence : g_Fences)
-    {
-        CheckVulkanResult(vkCreateFence(LogicalDevice, &FenceCreateInfo, nullptr, &Fence));
-    }
-
-    CheckVulkanResult(vkResetFences(LogicalDevice, static_cast<std::uint32_t>(std::size(g_Fences)), data(g_Fences)));
+    constexpr VkSemaphoreTypeCreateInfo TimelineTypeCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0U
+    };
+
+    VkSemaphoreCreateInfo const TimelineCreateInfo { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &TimelineTypeCreateInfo };
+    CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &TimelineCreateInfo, nullptr, &g_FrameTimelineSemaphore));
+    CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &TimelineCreateInfo, nullptr, &g_ComputeTimelineSemaphore));
+    CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &TimelineCreateInfo, nullptr, &g_TransferTimelineSemaphore));
+
+    g_FrameTimelineValue    = 0U;
+    g_ComputeTimelineValue  = 0U;
+    g_TransferTimelineValue = 0U;
+    g_FrameSignalValues.fill(0U);
 }
 
 void RenderCore::ReleaseSynchronizationObjects()
@@ -66,62 +52,145 @@ void RenderCore::ReleaseSynchronizationObjects()
         }
     }
 
-    for (auto &Semaphore : g_RenderFinishedSemaphores)
+    DestroyPresentationSemaphores();
+
+    if (g_FrameTimelineSemaphore != VK_NULL_HANDLE)
     {
-        if (Semaphore != VK_NULL_HANDLE)
-        {
-            vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
-            Semaphore = VK_NULL_HANDLE;
-        }
+        vkDestroySemaphore(LogicalDevice, g_FrameTimelineSemaphore, nullptr);
+        g_FrameTimelineSemaphore = VK_NULL_HANDLE;
     }
 
-    for (auto &Fence : g_Fences)
+    if (g_ComputeTimelineSemaphore != VK_NULL_HANDLE)
     {
-        if (Fence != VK_NULL_HANDLE)
-        {
-            vkDestroyFence(LogicalDevice, Fence, nullptr);
-            Fence = VK_NULL_HANDLE;
-        }
+        vkDestroySemaphore(LogicalDevice, g_ComputeTimelineSemaphore, nullptr);
+        g_ComputeTimelineSemaphore = VK_NULL_HANDLE;
+    }
+
+    if (g_TransferTimelineSemaphore != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(LogicalDevice, g_TransferTimelineSemaphore, nullptr);
+        g_TransferTimelineSemaphore = VK_NULL_HANDLE;
     }
 
-    ResetFenceStatus();
+    g_FrameTimelineValue    = 0U;
+    g_ComputeTimelineValue  = 0U;
+    g_TransferTimelineValue = 0U;
+    g_FrameSignalValues.fill(0U);
 }
 
-void RenderCore::ResetSemaphores()
+void RenderCore::CreatePresentationSemaphores(std::uint32_t const ImageCount)
 {
-    vkQueueWaitIdle(GetGraphicsQueue().second);
+    if (std::size(g_RenderFinishedSemaphores) >= ImageCount)
+    {
+        return;
+    }
 
     VkDevice const &                LogicalDevice = GetLogicalDevice();
     constexpr VkSemaphoreCreateInfo SemaphoreCreateInfo { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
 
-    for (auto &Semaphore : g_ImageAvailableSemaphores)
+    while (std::size(g_RenderFinishedSemaphores) < ImageCount)
     {
-        if (Semaphore != VK_NULL_HANDLE)
-        {
-            vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
-            CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
-        }
+        CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &g_RenderFinishedSemaphores.emplace_back(VK_NULL_HANDLE)));
     }
+}
 
-    for (auto &Semaphore : g_RenderFinishedSemaphores)
+void RenderCore::DestroyPresentationSemaphores()
+{
+    VkDevice const &LogicalDevice = GetLogicalDevice();
+
+    for (VkSemaphore const &Semaphore : g_RenderFinishedSemaphores)
     {
         if (Semaphore != VK_NULL_HANDLE)
         {
             vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
-            CheckVulkanResult(vkCreateSemaphore(LogicalDevice, &SemaphoreCreateInfo, nullptr, &Semaphore));
         }
     }
+
+    g_RenderFinishedSemaphores.clear();
 }
 
-void RenderCore::ResetFenceStatus()
+void RenderCore::WaitForFrame(std::uint32_t const FrameIndex)
 {
-    for (std::uint8_t Iterator = 0U; Iterator < g_ImageCount; ++Iterator)
+    std::uint64_t const &SignalValue = g_FrameSignalValues.at(FrameIndex);
+
+    if (SignalValue == 0U || g_FrameTimelineSemaphore == VK_NULL_HANDLE)
     {
-        if (bool &FenceStatus = g_FenceInUse.at(Iterator);
-            FenceStatus)
-        {
-            WaitAndResetFence(Iterator);
-            FenceStatus = false;
-        }
+        return;
+    }
+
+    VkSemaphoreWaitInfo const WaitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1U,
+            .pSemaphores = &g_FrameTimelineSemaphore,
+            .pValues = &SignalValue
+    };
+
+    CheckVulkanResult(vkWaitSemaphores(GetLogicalDevice(), &WaitInfo, g_Timeout));
+}
+
+void RenderCore::WaitForAllFrames()
+{
+    if (g_FrameTimelineValue == 0U || g_FrameTimelineSemaphore == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    VkSemaphoreWaitInfo const WaitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1U,
+            .pSemaphores = &g_FrameTimelineSemaphore,
+            .pValues = &g_FrameTimelineValue
+    };
+
+    CheckVulkanResult(vkWaitSemaphores(GetLogicalDevice(), &WaitInfo, g_Timeout));
+}
+
+std::uint64_t RenderCore::AdvanceFrameTimeline(std::uint32_t const FrameIndex)
+{
+    g_FrameSignalValues.at(FrameIndex) = ++g_FrameTimelineValue;
+    return g_FrameTimelineValue;
+}
+
+std::uint64_t RenderCore::GetCompletedFrameTimelineValue()
+{
+    if (g_FrameTimelineSemaphore == VK_NULL_HANDLE)
+    {
+        return 0U;
+    }
+
+    std::uint64_t Output = 0U;
+    CheckVulkanResult(vkGetSemaphoreCounterValue(GetLogicalDevice(), g_FrameTimelineSemaphore, &Output));
+
+    return Output;
+}
+
+void RenderCore::RetireResource(std::function<void()> &&Release)
+{
+    g_RetiredResources.emplace_back(g_FrameTimelineValue, std::move(Release));
+}
+
+void RenderCore::ReleaseRetiredResources(bool const Force)
+{
+    if (std::empty(g_RetiredResources))
+    {
+        return;
+    }
+
+    std::uint64_t const CompletedValue = Force ? std::numeric_limits<std::uint64_t>::max() : GetCompletedFrameTimelineValue();
+
+    auto const FirstPending = std::stable_partition(std::begin(g_RetiredResources),
+                                                    std::end(g_RetiredResources),
+                                                    [CompletedValue](auto const &RetiredIter)
+                                                    {
+                                                        return RetiredIter.first <= CompletedValue;
+                                                    });
+
+    std::vector<std::pair<std::uint64_t, std::function<void()>>> Released(std::make_move_iterator(std::begin(g_RetiredResources)),
+                                                                         std::make_move_iterator(FirstPending));
+    g_RetiredResources.erase(std::begin(g_RetiredResources), FirstPending);
+
+    for (auto &[Value, Release] : Released)
+    {
+        Release();
     }
 }
@@ -0,0 +1,753 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Runtime.Upload;
+
+import RenderCore.Runtime.Device;
+import RenderCore.Runtime.ImmediateSubmit;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Synchronization;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.Helpers;
+
+using namespace RenderCore;
+
+struct UploadedImage
+{
+    VkImage       Image { VK_NULL_HANDLE };
+    VkFormat      Format { VK_FORMAT_UNDEFINED };
+    std::uint32_t MipLevel { 0U };
+};
+
+struct ImageCopy
+{
+    UploadedImage Destination {};
+    VkExtent2D    Extent {};
+    VkBuffer      Source { VK_NULL_HANDLE };
+    VkDeviceSize  SourceOffset { 0U };
+};
+
+// Level 0 extent, the blits fill the levels after the source one
+struct MipGeneration
+{
+    VkImage       Image { VK_NULL_HANDLE };
+    VkFormat      Format { VK_FORMAT_UNDEFINED };
+    VkExtent2D    Extent {};
+    std::uint32_t SourceLevel { 0U };
+    std::uint32_t MipLevels { 1U };
+};
+
+struct BufferCopy
+{
+    VkBuffer     Destination { VK_NULL_HANDLE };
+    VkBuffer     Source { VK_NULL_HANDLE };
+    VkBufferCopy Region {};
+};
+
+struct UploadBatch
+{
+    TransientCommands *                             Commands { nullptr };
+    VkCommandBuffer                                 CommandBuffer { VK_NULL_HANDLE };
+    std::vector<std::pair<VkBuffer, VmaAllocation>> StagingBuffers {};
+    std::vector<BufferCopy>                         BufferCopies {};
+    std::vector<ImageCopy>                          Copies {};
+    std::vector<UploadedImage>                      Images {};
+    std::vector<MipGeneration>                      MipGenerations {};
+    std::function<void()>                           OnComplete {};
+    std::uint64_t                                   TimelineValue { 0U };
+};
+
+// Ring regions are handed out and given back in order, so only the consumed size of each one has to be remembered
+struct StagingRingRegion
+{
+    VkCommandBuffer CommandBuffer { VK_NULL_HANDLE };
+    VkDeviceSize    ConsumedSize { 0U };
+    std::uint64_t   TimelineValue { 0U };
+};
+
+struct StagingRing
+{
+    VkBuffer                      Buffer { VK_NULL_HANDLE };
+    VmaAllocation                 Allocation { VK_NULL_HANDLE };
+    std::byte *                   MappedData { nullptr };
+    VkDeviceSize                  Head { 0U };
+    VkDeviceSize                  UsedSize { 0U };
+    std::deque<StagingRingRegion> Regions {};
+};
+
+std::mutex                         g_UploadMutex {};
+std::vector<UploadBatch>           g_RecordingUploads {};
+std::deque<UploadBatch>            g_SubmittedUploads {};
+std::vector<UploadedImage>         g_PendingAcquires {};
+std::vector<MipGeneration>         g_PendingMipGenerations {};
+std::uint64_t                      g_PendingAcquireValue { 0U };
+std::vector<std::function<void()>> g_PendingCallbacks {};
+StagingRing                        g_StagingRing {};
+
+UploadBatch *FindRecordingUpload(VkCommandBuffer const &CommandBuffer)
+{
+    auto const MatchingIter = std::ranges::find(g_RecordingUploads, CommandBuffer, &UploadBatch::CommandBuffer);
+    return MatchingIter != std::end(g_RecordingUploads) ? &*MatchingIter : nullptr;
+}
+
+void DestroyUploadBatch(UploadBatch &Batch)
+{
+    VmaAllocator const &Allocator = GetAllocator();
+    for (auto const &[Buffer, Allocation] : Batch.StagingBuffers)
+    {
+        vmaDestroyBuffer(Allocator, Buffer, Allocation);
+    }
+
+    // Only set while the batch is still recording, submitted commands went back to the cache right away
+    if (Batch.Commands)
+    {
+        RecycleTransientCommands(*Batch.Commands);
+    }
+
+    Batch.StagingBuffers.clear();
+    Batch.Commands      = nullptr;
+    Batch.CommandBuffer = VK_NULL_HANDLE;
+}
+
+// Each upload writes a single mip level, the levels that were never uploaded stay undefined
+template<VkImageLayout OldLayout, VkImageLayout NewLayout>
+VkImageMemoryBarrier2 MountLevelBarrier(UploadedImage const &Destination,
+                                        std::uint32_t const  FromQueueIndex = VK_QUEUE_FAMILY_IGNORED,
+                                        std::uint32_t const  ToQueueIndex   = VK_QUEUE_FAMILY_IGNORED)
+{
+    VkImageMemoryBarrier2 Barrier = MountImageBarrier<OldLayout, NewLayout, g_ImageAspect>(Destination.Image,
+                                                                                          Destination.Format,
+                                                                                          FromQueueIndex,
+                                                                                          ToQueueIndex);
+
+    Barrier.subresourceRange.baseMipLevel = Destination.MipLevel;
+    Barrier.subresourceRange.levelCount   = 1U;
+
+    return Barrier;
+}
+
+void RecordImageBarriers(VkCommandBuffer const &CommandBuffer, std::vector<VkImageMemoryBarrier2> const &ImageBarriers)
+{
+    VkDependencyInfo const DependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .imageMemoryBarrierCount = static_cast<std::uint32_t>(std::size(ImageBarriers)),
+            .pImageMemoryBarriers = std::data(ImageBarriers)
+    };
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+void RecordOwnershipBarriers(VkCommandBuffer const &CommandBuffer, std::vector<UploadedImage> const &Images, bool const IsRelease)
+{
+    std::vector<VkImageMemoryBarrier2> ImageBarriers;
+    ImageBarriers.reserve(std::size(Images));
+
+    for (UploadedImage const &ImageIter : Images)
+    {
+        VkImageMemoryBarrier2 &Barrier = ImageBarriers.emplace_back(MountLevelBarrier<VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, g_ReadLayout>(ImageIter,
+                                                                                                                             GetTransferQueue().first,
+                                                                                                                             GetGraphicsQueue().first));
+
+        // Each half only names stages of its own queue; the release flushes the copies, the acquire chains after the timeline wait and makes
+        // them visible to sampling
+        Barrier.srcStageMask  = IsRelease ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : g_UploadWaitStages;
+        Barrier.srcAccessMask = IsRelease ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_NONE;
+        Barrier.dstStageMask  = IsRelease ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        Barrier.dstAccessMask = IsRelease ? VK_ACCESS_2_NONE : VK_ACCESS_2_SHADER_READ_BIT;
+    }
+
+    RecordImageBarriers(CommandBuffer, ImageBarriers);
+}
+
+// Consecutive copies between the same pair of buffers become the regions of a single copy command
+void RecordBufferCopies(UploadBatch &Batch)
+{
+    std::vector<VkBufferCopy2> Regions;
+
+    for (auto Iterator = std::cbegin(Batch.BufferCopies); Iterator != std::cend(Batch.BufferCopies);)
+    {
+        auto const RunEnd = std::find_if(Iterator,
+                                         std::cend(Batch.BufferCopies),
+                                         [&Iterator](BufferCopy const &CopyIter)
+                                         {
+                                             return CopyIter.Destination != Iterator->Destination || CopyIter.Source != Iterator->Source;
+                                         });
+
+        Regions.clear();
+        for (auto RegionIter = Iterator; RegionIter != RunEnd; ++RegionIter)
+        {
+            Regions.push_back(VkBufferCopy2 {
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2,
+                    .srcOffset = RegionIter->Region.srcOffset,
+                    .dstOffset = RegionIter->Region.dstOffset,
+                    .size = RegionIter->Region.size
+            });
+        }
+
+        VkCopyBufferInfo2 const CopyInfo {
+                .sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2,
+                .srcBuffer = Iterator->Source,
+                .dstBuffer = Iterator->Destination,
+                .regionCount = static_cast<std::uint32_t>(std::size(Regions)),
+                .pRegions = std::data(Regions)
+        };
+
+        vkCmdCopyBuffer2(Batch.CommandBuffer, &CopyInfo);
+        Iterator = RunEnd;
+    }
+
+    Batch.BufferCopies.clear();
+}
+
+// Every image of the batch shares one barrier into the transfer layout, its copies and one barrier out of it
+void RecordImageCopies(UploadBatch &Batch)
+{
+    if (std::empty(Batch.Copies))
+    {
+        return;
+    }
+
+    std::vector<VkImageMemoryBarrier2> ImageBarriers;
+    ImageBarriers.reserve(std::size(Batch.Copies));
+
+    for (auto const &[Destination, Extent, Source, SourceOffset] : Batch.Copies)
+    {
+        ImageBarriers.push_back(MountLevelBarrier<g_UndefinedLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL>(Destination));
+    }
+
+    RecordImageBarriers(Batch.CommandBuffer, ImageBarriers);
+
+    for (auto const &[Destination, Extent, Source, SourceOffset] : Batch.Copies)
+    {
+        VkBufferImageCopy2 const Region {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
+                .bufferOffset = SourceOffset,
+                .bufferRowLength = 0U,
+                .bufferImageHeight = 0U,
+                .imageSubresource = { .aspectMask = g_ImageAspect, .mipLevel = Destination.MipLevel, .baseArrayLayer = 0U, .layerCount = 1U },
+                .imageOffset = { .x = 0U, .y = 0U, .z = 0U },
+                .imageExtent = { .width = Extent.width, .height = Extent.height, .depth = 1U }
+        };
+
+        VkCopyBufferToImageInfo2 const CopyInfo {
+                .sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
+                .srcBuffer = Source,
+                .dstImage = Destination.Image,
+                .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .regionCount = 1U,
+                .pRegions = &Region
+        };
+
+        vkCmdCopyBufferToImage2(Batch.CommandBuffer, &CopyInfo);
+    }
+
+    if (HasDedicatedTransferQueue())
+    {
+        for (ImageCopy const &CopyIter : Batch.Copies)
+        {
+            Batch.Images.push_back(CopyIter.Destination);
+        }
+
+        RecordOwnershipBarriers(Batch.CommandBuffer, Batch.Images, true);
+    }
+    else
+    {
+        ImageBarriers.clear();
+
+        for (auto const &[Destination, Extent, Source, SourceOffset] : Batch.Copies)
+        {
+            ImageBarriers.push_back(MountLevelBarrier<VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, g_ReadLayout>(Destination));
+        }
+
+        RecordImageBarriers(Batch.CommandBuffer, ImageBarriers);
+    }
+
+    Batch.Copies.clear();
+}
+
+template<VkImageLayout OldLayout, VkImageLayout NewLayout>
+VkImageMemoryBarrier2 MountMipBarrier(MipGeneration const &Generation, std::uint32_t const BaseLevel, std::uint32_t const LevelCount)
+{
+    VkImageMemoryBarrier2 Barrier = MountImageBarrier<OldLayout, NewLayout, g_ImageAspect>(Generation.Image, Generation.Format);
+
+    Barrier.subresourceRange.baseMipLevel = BaseLevel;
+    Barrier.subresourceRange.levelCount   = LevelCount;
+
+    return Barrier;
+}
+
+constexpr VkOffset3D GetLevelOffset(VkExtent2D const &Extent, std::uint32_t const Level)
+{
+    return VkOffset3D {
+            .x = static_cast<std::int32_t>(std::max(Extent.width >> Level, 1U)),
+            .y = static_cast<std::int32_t>(std::max(Extent.height >> Level, 1U)),
+            .z = 1
+    };
+}
+
+// Blits every chain one level at a time, so the barriers of a level are shared by all the images of the batch. Graphics queue only, the
+// source level has to be in the read layout already.
+void RecordMipGenerations(VkCommandBuffer const &CommandBuffer, std::vector<MipGeneration> const &Generations)
+{
+    std::vector<VkImageMemoryBarrier2> ImageBarriers;
+    ImageBarriers.reserve(std::size(Generations) * 2U);
+
+    std::uint32_t MaxLevels = 0U;
+
+    for (MipGeneration const &GenerationIter : Generations)
+    {
+        VkImageMemoryBarrier2 &SourceBarrier = ImageBarriers.emplace_back(MountMipBarrier<g_ReadLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL>(GenerationIter,
+                                                                                                                                        GenerationIter.SourceLevel,
+                                                                                                                                        1U));
+
+        // Waits for the acquire or the copy barrier that moved the source level into the read layout
+        SourceBarrier.srcStageMask  = g_UploadWaitStages;
+        SourceBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+        SourceBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+        SourceBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+
+        ImageBarriers.push_back(MountMipBarrier<g_UndefinedLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL>(GenerationIter,
+                                                                                                       GenerationIter.SourceLevel + 1U,
+                                                                                                       GenerationIter.MipLevels -
+                                                                                                       GenerationIter.SourceLevel - 1U));
+
+        MaxLevels = std::max(MaxLevels, GenerationIter.MipLevels);
+    }
+
+    RecordImageBarriers(CommandBuffer, ImageBarriers);
+
+    for (std::uint32_t Level = 1U; Level < MaxLevels; ++Level)
+    {
+        ImageBarriers.clear();
+
+        for (MipGeneration const &GenerationIter : Generations)
+        {
+            if (Level <= GenerationIter.SourceLevel || Level >= GenerationIter.MipLevels)
+            {
+                continue;
+            }
+
+            VkImageBlit2 const Region {
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+                    .srcSubresource = { .aspectMask = g_ImageAspect, .mipLevel = Level - 1U, .baseArrayLayer = 0U, .layerCount = 1U },
+                    .srcOffsets = { VkOffset3D { .x = 0, .y = 0, .z = 0 }, GetLevelOffset(GenerationIter.Extent, Level - 1U) },
+                    .dstSubresource = { .aspectMask = g_ImageAspect, .mipLevel = Level, .baseArrayLayer = 0U, .layerCount = 1U },
+                    .dstOffsets = { VkOffset3D { .x = 0, .y = 0, .z = 0 }, GetLevelOffset(GenerationIter.Extent, Level) }
+            };
+
+            VkBlitImageInfo2 const BlitInfo {
+                    .sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+                    .srcImage = GenerationIter.Image,
+                    .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .dstImage = GenerationIter.Image,
+                    .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .regionCount = 1U,
+                    .pRegions = &Region,
+                    .filter = VK_FILTER_LINEAR
+            };
+
+            vkCmdBlitImage2(CommandBuffer, &BlitInfo);
+
+            VkImageMemoryBarrier2 &LevelBarrier = ImageBarriers.emplace_back(MountMipBarrier<VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                                                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL>(GenerationIter, Level, 1U));
+
+            LevelBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+            LevelBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            LevelBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            LevelBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT;
+        }
+
+        RecordImageBarriers(CommandBuffer, ImageBarriers);
+    }
+
+    ImageBarriers.clear();
+
+    for (MipGeneration const &GenerationIter : Generations)
+    {
+        VkImageMemoryBarrier2 &ReadBarrier = ImageBarriers.emplace_back(MountMipBarrier<VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, g_ReadLayout>(
+                GenerationIter,
+                GenerationIter.SourceLevel,
+                GenerationIter.MipLevels - GenerationIter.SourceLevel));
+
+        ReadBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_BLIT_BIT;
+        ReadBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+        ReadBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        ReadBarrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+    }
+
+    RecordImageBarriers(CommandBuffer, ImageBarriers);
+}
+
+std::pair<VkBuffer, VkDeviceSize> AllocateStaging(UploadBatch &               Batch,
+                                                  void const *const           Data,
+                                                  VkDeviceSize const          Size,
+                                                  VkDeviceSize const          Alignment,
+                                                  strzilla::string_view const Identifier)
+{
+    if (g_StagingRing.Buffer != VK_NULL_HANDLE && Size <= g_StagingRingSize)
+    {
+        VkDeviceSize Offset = (g_StagingRing.Head + Alignment - 1U) / Alignment * Alignment;
+        if (Offset + Size > g_StagingRingSize)
+        {
+            Offset = 0U;
+        }
+
+        // Wrapping around wastes the tail end of the ring until this region is given back
+        VkDeviceSize const ConsumedSize = Offset == 0U && g_StagingRing.Head != 0U
+                                              ? g_StagingRingSize - g_StagingRing.Head + Size
+                                              : Offset - g_StagingRing.Head + Size;
+
+        if (g_StagingRing.UsedSize + ConsumedSize <= g_StagingRingSize)
+        {
+            std::memcpy(g_StagingRing.MappedData + Offset, Data, Size);
+
+            g_StagingRing.Head = (Offset + Size) % g_StagingRingSize;
+            g_StagingRing.UsedSize += ConsumedSize;
+            g_StagingRing.Regions.push_back(StagingRingRegion { .CommandBuffer = Batch.CommandBuffer, .ConsumedSize = ConsumedSize });
+
+            return { g_StagingRing.Buffer, Offset };
+        }
+    }
+
+    // Too large for the ring or the ring is still busy with previous uploads
+    VkBuffer      Buffer { VK_NULL_HANDLE };
+    VmaAllocation Allocation { VK_NULL_HANDLE };
+    CreateBuffer(Size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, Identifier, Buffer, Allocation);
+
+    VmaAllocator const &Allocator = GetAllocator();
+
+    void *MappedData = nullptr;
+    CheckVulkanResult(vmaMapMemory(Allocator, Allocation, &MappedData));
+    std::memcpy(MappedData, Data, Size);
+    vmaUnmapMemory(Allocator, Allocation);
+
+    Batch.StagingBuffers.emplace_back(Buffer, Allocation);
+
+    return { Buffer, 0U };
+}
+
+void ReleaseCompletedStaging(std::uint64_t const CompletedValue)
+{
+    while (!std::empty(g_StagingRing.Regions))
+    {
+        StagingRingRegion const &Region = g_StagingRing.Regions.front();
+        if (Region.TimelineValue == 0U || Region.TimelineValue > CompletedValue)
+        {
+            break;
+        }
+
+        g_StagingRing.UsedSize -= Region.ConsumedSize;
+        g_StagingRing.Regions.pop_front();
+    }
+
+    if (g_StagingRing.UsedSize == 0U)
+    {
+        g_StagingRing.Head = 0U;
+    }
+}
+
+// Moves the uploads the transfer timeline already reached to the pending acquires. Their callbacks are only queued, so they never run outside
+// of ProcessCompletedUploads. Expects the upload mutex to be held.
+void RetireCompletedUploads()
+{
+    if (std::empty(g_SubmittedUploads))
+    {
+        return;
+    }
+
+    std::uint64_t CompletedValue = 0U;
+    CheckVulkanResult(vkGetSemaphoreCounterValue(GetLogicalDevice(), GetTransferTimelineSemaphore(), &CompletedValue));
+
+    ReleaseCompletedStaging(CompletedValue);
+
+    // Submissions signal increasing values on a single queue, so they complete in order
+    while (!std::empty(g_SubmittedUploads) && g_SubmittedUploads.front().TimelineValue <= CompletedValue)
+    {
+        UploadBatch &Batch = g_SubmittedUploads.front();
+
+        g_PendingAcquires.insert(std::end(g_PendingAcquires), std::cbegin(Batch.Images), std::cend(Batch.Images));
+        g_PendingMipGenerations.insert(std::end(g_PendingMipGenerations), std::cbegin(Batch.MipGenerations), std::cend(Batch.MipGenerations));
+        g_PendingAcquireValue = std::max(g_PendingAcquireValue, Batch.TimelineValue);
+
+        if (Batch.OnComplete)
+        {
+            g_PendingCallbacks.push_back(std::move(Batch.OnComplete));
+        }
+
+        DestroyUploadBatch(Batch);
+        g_SubmittedUploads.pop_front();
+    }
+}
+
+void RenderCore::CreateUploadResources()
+{
+    std::lock_guard Lock { g_UploadMutex };
+
+    CreateBuffer(g_StagingRingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, "STAGING_RING", g_StagingRing.Buffer, g_StagingRing.Allocation);
+
+    // Stays mapped until shutdown
+    void *MappedData = nullptr;
+    CheckVulkanResult(vmaMapMemory(GetAllocator(), g_StagingRing.Allocation, &MappedData));
+    g_StagingRing.MappedData = static_cast<std::byte *>(MappedData);
+}
+
+VkCommandBuffer RenderCore::BeginUpload()
+{
+    TransientCommands &Commands = AcquireTransientCommands(GetTransferQueue().first);
+
+    std::lock_guard Lock { g_UploadMutex };
+    g_RecordingUploads.push_back(UploadBatch { .Commands = &Commands, .CommandBuffer = Commands.CommandBuffer });
+
+    return Commands.CommandBuffer;
+}
+
+void RenderCore::QueueImageUpload(VkCommandBuffer const &CommandBuffer,
+                                  VkImage const &        Image,
+                                  VkFormat const         Format,
+                                  VkExtent2D const &     Extent,
+                                  void const *const      Data,
+                                  VkDeviceSize const     Size,
+                                  std::uint32_t const    MipLevel)
+{
+    std::lock_guard Lock { g_UploadMutex };
+
+    UploadBatch *const Batch = FindRecordingUpload(CommandBuffer);
+    if (!Batch)
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Command buffer was not opened with BeginUpload";
+        return;
+    }
+
+    // Buffer offsets of image copies have to be a multiple of the texel size, on top of the device's preferred copy alignment
+    VkDeviceSize const TexelSize = std::max<VkDeviceSize>(Size / std::max<VkDeviceSize>(static_cast<VkDeviceSize>(Extent.width) * Extent.height, 1U), 1U);
+    VkDeviceSize const Alignment = std::lcm(TexelSize, std::max<VkDeviceSize>(GetPhysicalDeviceProperties().limits.optimalBufferCopyOffsetAlignment, 4U));
+
+    auto const [Source, SourceOffset] = AllocateStaging(*Batch, Data, Size, Alignment, "STAGING_TEXTURE");
+
+    Batch->Copies.push_back(ImageCopy {
+            .Destination = { .Image = Image, .Format = Format, .MipLevel = MipLevel },
+            .Extent = Extent,
+            .Source = Source,
+            .SourceOffset = SourceOffset
+    });
+}
+
+void RenderCore::QueueMipGeneration(VkCommandBuffer const &CommandBuffer,
+                                    VkImage const &        Image,
+                                    VkFormat const         Format,
+                                    VkExtent2D const &     Extent,
+                                    std::uint32_t const    SourceLevel,
+                                    std::uint32_t const    MipLevels)
+{
+    if (SourceLevel + 1U >= MipLevels)
+    {
+        return;
+    }
+
+    std::lock_guard Lock { g_UploadMutex };
+
+    UploadBatch *const Batch = FindRecordingUpload(CommandBuffer);
+    if (!Batch)
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Command buffer was not opened with BeginUpload";
+        return;
+    }
+
+    Batch->MipGenerations.push_back(MipGeneration {
+            .Image = Image,
+            .Format = Format,
+            .Extent = Extent,
+            .SourceLevel = SourceLevel,
+            .MipLevels = MipLevels
+    });
+}
+
+void RenderCore::QueueBufferUpload(VkCommandBuffer const &CommandBuffer,
+                                   VkBuffer const &        Destination,
+                                   VkDeviceSize const      DestinationOffset,
+                                   void const *const       Data,
+                                   VkDeviceSize const      Size)
+{
+    if (Size == 0U)
+    {
+        return;
+    }
+
+    std::lock_guard Lock { g_UploadMutex };
+
+    UploadBatch *const Batch = FindRecordingUpload(CommandBuffer);
+    if (!Batch)
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Command buffer was not opened with BeginUpload";
+        return;
+    }
+
+    auto const [Source, SourceOffset] = AllocateStaging(*Batch, Data, Size, 16U, "STAGING_BUFFER");
+
+    Batch->BufferCopies.push_back(BufferCopy {
+            .Destination = Destination,
+            .Source = Source,
+            .Region = { .srcOffset = SourceOffset, .dstOffset = DestinationOffset, .size = Size }
+    });
+}
+
+void RenderCore::SubmitUpload(VkCommandBuffer const &CommandBuffer, std::function<void()> &&OnComplete)
+{
+    std::lock_guard Lock { g_UploadMutex };
+
+    auto const MatchingIter = std::ranges::find(g_RecordingUploads, CommandBuffer, &UploadBatch::CommandBuffer);
+    if (MatchingIter == std::end(g_RecordingUploads))
+    {
+        return;
+    }
+
+    UploadBatch Batch = std::move(*MatchingIter);
+    g_RecordingUploads.erase(MatchingIter);
+
+    RecordBufferCopies(Batch);
+    RecordImageCopies(Batch);
+
+    Batch.OnComplete    = std::move(OnComplete);
+    Batch.TimelineValue = AdvanceTransferTimeline();
+
+    for (StagingRingRegion &RegionIter : g_StagingRing.Regions)
+    {
+        if (RegionIter.CommandBuffer == Batch.CommandBuffer && RegionIter.TimelineValue == 0U)
+        {
+            RegionIter.TimelineValue = Batch.TimelineValue;
+        }
+    }
+
+    VkSemaphoreSubmitInfo const SignalSemaphoreInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = GetTransferTimelineSemaphore(),
+            .value = Batch.TimelineValue,
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT
+    };
+
+    SubmitTransientCommands(*Batch.Commands, GetTransferQueue().second, { &SignalSemaphoreInfo, 1U }, false);
+    Batch.Commands = nullptr;
+
+    g_SubmittedUploads.push_back(std::move(Batch));
+}
+
+void RenderCore::ProcessCompletedUploads()
+{
+    std::vector<std::function<void()>> Callbacks;
+    {
+        std::lock_guard Lock { g_UploadMutex };
+
+        RetireCompletedUploads();
+        Callbacks = std::exchange(g_PendingCallbacks, {});
+    }
+
+    for (std::function<void()> const &CallbackIter : Callbacks)
+    {
+        CallbackIter();
+    }
+}
+
+std::uint64_t RenderCore::RecordUploadAcquires(VkCommandBuffer const &CommandBuffer)
+{
+    std::lock_guard Lock { g_UploadMutex };
+
+    // Completed uploads without images still have their buffer writes made visible through the timeline wait
+    if (!std::empty(g_PendingAcquires))
+    {
+        RecordOwnershipBarriers(CommandBuffer, g_PendingAcquires, false);
+        g_PendingAcquires.clear();
+    }
+
+    // Blits need a graphics queue, so the chains of the completed uploads are filled here rather than on the transfer queue
+    if (!std::empty(g_PendingMipGenerations))
+    {
+        RecordMipGenerations(CommandBuffer, g_PendingMipGenerations);
+        g_PendingMipGenerations.clear();
+    }
+
+    return std::exchange(g_PendingAcquireValue, 0U);
+}
+
+void RenderCore::FlushUploads()
+{
+    std::uint64_t LastValue = 0U;
+    {
+        std::lock_guard Lock { g_UploadMutex };
+        LastValue = std::empty(g_SubmittedUploads) ? 0U : g_SubmittedUploads.back().TimelineValue;
+    }
+
+    if (LastValue != 0U)
+    {
+        VkSemaphoreWaitInfo const WaitInfo {
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                .semaphoreCount = 1U,
+                .pSemaphores = &GetTransferTimelineSemaphore(),
+                .pValues = &LastValue
+        };
+
+        CheckVulkanResult(vkWaitSemaphores(GetLogicalDevice(), &WaitInfo, g_Timeout));
+    }
+
+    {
+        std::lock_guard Lock { g_UploadMutex };
+        RetireCompletedUploads();
+
+        if (std::empty(g_PendingAcquires) && std::empty(g_PendingMipGenerations))
+        {
+            return;
+        }
+    }
+
+    auto const &[FamilyIndex, Queue] = GetGraphicsQueue();
+
+    ImmediateSubmit Commands { FamilyIndex, Queue };
+    std::ignore = RecordUploadAcquires(Commands.GetCommandBuffer());
+    Commands.Submit();
+}
+
+void RenderCore::ReleaseUploadResources()
+{
+    std::lock_guard Lock { g_UploadMutex };
+
+    if (VkQueue const &Queue = GetTransferQueue().second;
+        Queue != VK_NULL_HANDLE)
+    {
+        CheckVulkanResult(vkQueueWaitIdle(Queue));
+    }
+
+    for (UploadBatch &BatchIter : g_RecordingUploads)
+    {
+        DestroyUploadBatch(BatchIter);
+    }
+
+    for (UploadBatch &BatchIter : g_SubmittedUploads)
+    {
+        DestroyUploadBatch(BatchIter);
+    }
+
+    g_RecordingUploads.clear();
+    g_SubmittedUploads.clear();
+    g_PendingAcquires.clear();
+    g_PendingMipGenerations.clear();
+    g_PendingCallbacks.clear();
+    g_PendingAcquireValue = 0U;
+
+    if (g_StagingRing.Buffer != VK_NULL_HANDLE)
+    {
+        VmaAllocator const &Allocator = GetAllocator();
+        vmaUnmapMemory(Allocator, g_StagingRing.Allocation);
+        vmaDestroyBuffer(Allocator, g_StagingRing.Buffer, g_StagingRing.Allocation);
+    }
+
+    g_StagingRing = {};
+}
+
+bool RenderCore::HasPendingUploads()
+{
+    std::lock_guard Lock { g_UploadMutex };
+    return !std::empty(g_RecordingUploads) || !std::empty(g_SubmittedUploads) || !std::empty(g_PendingAcquires) ||
+           !std::empty(g_PendingMipGenerations) || !std::empty(g_PendingCallbacks);
+}
@@ -10,12 +10,57 @@ module RenderCore.Factories.Texture;
 
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Scene;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.Profiler;
 
 using namespace RenderCore;
 
-std::shared_ptr<Texture> RenderCore::ConstructTexture(TextureConstructionInputParameters const &Parameters,
-                                                      TextureConstructionOutputParameters &     Output)
+VkFormat GetTextureFormat(tinygltf::Image const &Image)
 {
+    return Image.component == 3 ? VK_FORMAT_R8G8B8_UNORM : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+std::vector<unsigned char> DownsampleLevel(std::vector<unsigned char> const &Source,
+                                           std::uint32_t const               Width,
+                                           std::uint32_t const               Height,
+                                           std::uint32_t const               Channels)
+{
+    std::uint32_t const LevelWidth  = std::max(Width / 2U, 1U);
+    std::uint32_t const LevelHeight = std::max(Height / 2U, 1U);
+
+    std::vector<unsigned char> Output(static_cast<std::size_t>(LevelWidth) * LevelHeight * Channels);
+
+    for (std::uint32_t Y = 0U; Y < LevelHeight; ++Y)
+    {
+        // Odd or unit dimensions clamp to the last row or column instead of reading past it
+        std::uint32_t const Y0 = std::min(Y * 2U, Height - 1U);
+        std::uint32_t const Y1 = std::min(Y * 2U + 1U, Height - 1U);
+
+        for (std::uint32_t X = 0U; X < LevelWidth; ++X)
+        {
+            std::uint32_t const X0 = std::min(X * 2U, Width - 1U);
+            std::uint32_t const X1 = std::min(X * 2U + 1U, Width - 1U);
+
+            for (std::uint32_t Channel = 0U; Channel < Channels; ++Channel)
+            {
+                auto const Texel = [&](std::uint32_t const SourceX, std::uint32_t const SourceY)
+                {
+                    return static_cast<std::uint32_t>(Source[(static_cast<std::size_t>(SourceY) * Width + SourceX) * Channels + Channel]);
+                };
+
+                std::uint32_t const Sum = Texel(X0, Y0) + Texel(X1, Y0) + Texel(X0, Y1) + Texel(X1, Y1);
+                Output[(static_cast<std::size_t>(Y) * LevelWidth + X) * Channels + Channel] = static_cast<unsigned char>((Sum + 2U) / 4U);
+            }
+        }
+    }
+
+    return Output;
+}
+
+std::shared_ptr<Texture> RenderCore::ConstructTexture(TextureConstructionInputParameters const &Parameters)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
     if (std::empty(Parameters.Image.image))
     {
         return nullptr;
@@ -24,22 +69,85 @@ std::shared_ptr<Texture> RenderCore::ConstructTexture(TextureConstructionInputPa
     strzilla::string const TextureName = std::format("{}_{:03d}", std::empty(Parameters.Image.name) ? "None" : Parameters.Image.name, Parameters.ID);
     auto              NewTexture  = std::shared_ptr<Texture>(new Texture { Parameters.ID, Parameters.Image.uri, TextureName }, TextureDeleter {});
 
-    auto [Index, Buffer, Allocation] = AllocateTexture(Parameters.AllocationCmdBuffer,
-                                                       std::data(Parameters.Image.image),
-                                                       Parameters.Image.width,
-                                                       Parameters.Image.height,
-                                                       Parameters.Image.component == 3 ? VK_FORMAT_R8G8B8_UNORM : VK_FORMAT_R8G8B8A8_UNORM,
-                                                       std::size(Parameters.Image.image));
+    std::uint32_t const Index = AllocateTexture(Parameters.AllocationCmdBuffer,
+                                                std::data(Parameters.Image.image),
+                                                Parameters.Image.width,
+                                                Parameters.Image.height,
+                                                GetTextureFormat(Parameters.Image),
+                                                std::size(Parameters.Image.image));
+
+    NewTexture->SetBufferIndex(Index);
+    NewTexture->SetSampler(Parameters.Sampler);
+
+    return NewTexture;
+}
+
+TextureMipChain RenderCore::GenerateMipChain(tinygltf::Image const &Image)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    TextureMipChain Output {};
+
+    if (std::empty(Image.image) || Image.width <= 0 || Image.height <= 0)
+    {
+        return Output;
+    }
+
+    auto       Width    = static_cast<std::uint32_t>(Image.width);
+    auto       Height   = static_cast<std::uint32_t>(Image.height);
+    auto const Channels = static_cast<std::uint32_t>(std::size(Image.image) / (static_cast<std::size_t>(Width) * Height));
+
+    Output.Extent = { .width = Width, .height = Height };
+    Output.Levels.push_back(Image.image);
+
+    while (Width > 1U || Height > 1U)
+    {
+        if (std::max(Width, Height) > g_TextureMipTailSize)
+        {
+            ++Output.TailLevel;
+        }
+
+        Output.Levels.push_back(DownsampleLevel(Output.Levels.back(), Width, Height, Channels));
+
+        Width  = std::max(Width / 2U, 1U);
+        Height = std::max(Height / 2U, 1U);
+    }
+
+    return Output;
+}
+
+std::shared_ptr<Texture> RenderCore::ConstructStreamedTexture(TextureConstructionInputParameters const &Parameters, TextureMipChain const &MipChain)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    if (std::empty(MipChain.Levels))
+    {
+        return nullptr;
+    }
+
+    strzilla::string const TextureName = std::format("{}_{:03d}", std::empty(Parameters.Image.name) ? "None" : Parameters.Image.name, Parameters.ID);
+    auto              NewTexture  = std::shared_ptr<Texture>(new Texture { Parameters.ID, Parameters.Image.uri, TextureName }, TextureDeleter {});
+
+    auto const LevelCount = static_cast<std::uint32_t>(std::size(MipChain.Levels));
+
+    std::uint32_t const Index = AllocateStreamedTexture(Parameters.Image.width, Parameters.Image.height, GetTextureFormat(Parameters.Image), LevelCount);
+
+    for (std::uint32_t Level = MipChain.TailLevel; Level < LevelCount; ++Level)
+    {
+        std::vector<unsigned char> const &LevelData = MipChain.Levels.at(Level);
+        QueueImageLevelUpload(Parameters.AllocationCmdBuffer, Index, Level, std::data(LevelData), std::size(LevelData));
+    }
 
-    Output.StagingBuffer     = std::move(Buffer);
-    Output.StagingAllocation = std::move(Allocation);
+    // The view is read only after the upload completed, objects join the scene in its callback
+    SetImageAllocationBaseLevel(Index, MipChain.TailLevel);
 
     NewTexture->SetBufferIndex(Index);
+    NewTexture->SetSampler(Parameters.Sampler);
 
     return NewTexture;
 }
 
-std::shared_ptr<Texture> RenderCore::ConstructTextureFromFile(strzilla::string_view const &Path, VkCommandBuffer& CommandBuffer, TextureConstructionOutputParameters &Output)
+std::shared_ptr<Texture> RenderCore::ConstructTextureFromFile(strzilla::string_view const &Path, VkCommandBuffer& CommandBuffer)
 {
     if (std::empty(Path) || !std::filesystem::exists(std::data(Path)))
     {
@@ -70,5 +178,5 @@ std::shared_ptr<Texture> RenderCore::ConstructTextureFromFile(strzilla::string_v
         .ID = FetchID(),
         .Image = ImageData,
         .AllocationCmdBuffer = CommandBuffer,
-    }, Output);
+    });
 }
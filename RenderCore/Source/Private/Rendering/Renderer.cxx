@@ -8,32 +8,165 @@ module RenderCore.Renderer;
 
 import RenderCore.Runtime.Command;
 import RenderCore.Runtime.Device;
+import RenderCore.Runtime.ImmediateSubmit;
+import RenderCore.Runtime.IndirectDraw;
 import RenderCore.Runtime.Instance;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Model;
 import RenderCore.Runtime.Offscreen;
 import RenderCore.Runtime.Pipeline;
+import RenderCore.Runtime.Query;
+import RenderCore.Runtime.Residency;
 import RenderCore.Runtime.Scene;
 import RenderCore.Runtime.ShaderCompiler;
+import RenderCore.Runtime.Snapshot;
 import RenderCore.Runtime.SwapChain;
 import RenderCore.Runtime.Synchronization;
+import RenderCore.Runtime.Upload;
 import RenderCore.Types.Allocation;
+import RenderCore.Types.SurfaceProperties;
 import RenderCore.Factories.Texture;
+import RenderCore.Utils.FrameStats;
 import RenderCore.Utils.Helpers;
+import RenderCore.Utils.Profiler;
 
 using namespace RenderCore;
 
-void Renderer::DrawFrame(double const DeltaTime)
+// RenderFrame runs the user callbacks while holding the renderer mutex, so the entry points they can reach only lock it when the calling
+// thread doesn't hold it already
+thread_local bool g_HoldsRendererMutex { false };
+
+class ScopedRendererLock
 {
-    std::lock_guard const Lock { g_RendererMutex };
+    std::unique_lock<std::mutex> m_Lock { g_RendererMutex, std::defer_lock };
+
+public:
+    ScopedRendererLock()
+    {
+        if (!g_HoldsRendererMutex)
+        {
+            m_Lock.lock();
+            g_HoldsRendererMutex = true;
+        }
+    }
+
+    ScopedRendererLock(ScopedRendererLock const &)            = delete;
+    ScopedRendererLock &operator=(ScopedRendererLock const &) = delete;
+
+    ~ScopedRendererLock()
+    {
+        if (m_Lock.owns_lock())
+        {
+            g_HoldsRendererMutex = false;
+        }
+    }
+};
 
-    g_FrameTime = static_cast<float>(DeltaTime);
+// Set while the render side applies object requests: objects it destroys request their own unload, which is already being handled
+thread_local bool g_ProcessingObjectsManagement { false };
 
-    DispatchQueue(g_NextTickDispatchQueue);
+void ProcessObjectsManagement()
+{
+    ReleaseRetiredResources(false);
 
-    if (HasAnyFlag(g_ObjectsManagementStateFlags))
+    RendererObjectsManagementStateFlags Flags {};
+    std::vector<strzilla::string>       ModelsToLoad {};
+    std::vector<std::uint32_t>          ModelsToUnload {};
     {
-        AddFlags(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_DESTRUCTION);
+        std::lock_guard Lock { g_ObjectsManagementMutex };
+        Flags          = std::exchange(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::NONE);
+        ModelsToLoad   = std::exchange(g_ModelsToLoad, {});
+        ModelsToUnload = std::exchange(g_ModelsToUnload, {});
+    }
+
+    if (HasAnyFlag(Flags, RendererObjectsManagementStateFlags::PENDING_CLEAR | RendererObjectsManagementStateFlags::PENDING_UNLOAD))
+    {
+        // Uploads still in flight would add their objects after the clear/unload
+        FlushUploads();
+    }
+
+    // The only place upload callbacks run, so they never touch the scene from another thread than the one rendering it
+    ProcessCompletedUploads();
+
+    if (!HasAnyFlag(Flags))
+    {
+        return;
+    }
+
+    g_ProcessingObjectsManagement = true;
+
+    if (HasFlag(Flags, RendererObjectsManagementStateFlags::PENDING_CLEAR))
+    {
+        DestroyObjects();
+    }
+    else if (HasFlag(Flags, RendererObjectsManagementStateFlags::PENDING_UNLOAD))
+    {
+        UnloadObjects(ModelsToUnload);
+    }
+
+    g_ProcessingObjectsManagement = false;
+
+    if (HasFlag(Flags, RendererObjectsManagementStateFlags::PENDING_LOAD))
+    {
+        for (auto const &ModelPath : ModelsToLoad)
+        {
+            LoadScene(ModelPath,
+                      [](std::vector<std::shared_ptr<Object>> const &NewObjects)
+                      {
+                          GetPipelineDescriptorData().UpdateModelsBuffer(NewObjects);
+                      });
+        }
+    }
+}
+
+SurfaceProperties GetRenderSurfaceProperties()
+{
+    if (SurfaceProperties Output = GetSurfaceProperties();
+        !g_Headless || Output.IsValid())
+    {
+        return Output;
+    }
+
+    return SurfaceProperties {
+            .Format = VkSurfaceFormatKHR { .format = VK_FORMAT_R8G8B8A8_UNORM, .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+            .DepthFormat = VK_FORMAT_D32_SFLOAT,
+            .Mode = VK_PRESENT_MODE_FIFO_KHR,
+            .Extent = g_HeadlessExtent
+    };
+}
+
+void SimulateFrame(float const DeltaTime)
+{
+    g_FrameTime = DeltaTime;
+
+    // Acquired before the scene lock: it blocks until the render side releases a snapshot, which needs the lock to finish its frame
+    SceneSnapshot &Snapshot = BeginSnapshotWrite();
+    Snapshot.DeltaTime      = DeltaTime;
+
+    {
+        std::lock_guard Lock { GetSceneMutex() };
+
+        auto const TickStartTime = std::chrono::steady_clock::now();
+        {
+            RENDERCORE_PROFILE_SCOPE("Tick");
+            Renderer::Tick();
+        }
+        Snapshot.TickTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - TickStartTime).count();
+
+        RENDERCORE_PROFILE_SCOPE("CaptureSnapshot");
+        CaptureSceneSnapshot(Snapshot);
+    }
+
+    PublishSnapshot();
+}
+
+void ProcessFrame(SceneSnapshot const &Snapshot)
+{
+    {
+        ScopedFrameTimer const Timer { FrameStage::DispatchDrain };
+        RENDERCORE_PROFILE_SCOPE("DispatchDrain");
+        std::lock_guard Lock { GetSceneMutex() };
+        g_NextTickDispatchQueue.Drain();
     }
 
     constexpr RendererStateFlags InvalidStatesToRender = RendererStateFlags::PENDING_DEVICE_PROPERTIES_UPDATE |
@@ -43,58 +176,39 @@ void Renderer::DrawFrame(double const DeltaTime)
 
     if (HasAnyFlag(g_StateFlags, InvalidStatesToRender))
     {
+        ScopedFrameTimer const Timer { FrameStage::ResourceRefresh };
+        RENDERCORE_PROFILE_SCOPE("ResourceRefresh");
+
         if (HasFlag(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_DESTRUCTION))
         {
+            // Cleared before the teardown so a request arriving from another thread meanwhile schedules another one
+            RemoveFlags(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_DESTRUCTION);
+
             CheckVulkanResult(vkDeviceWaitIdle(GetLogicalDevice()));
+            ReleaseRetiredResources(true);
 
-            g_ImageIndex = g_ImageCount;
+            g_ImageIndex = 0U;
+            g_FrameIndex = 0U;
 
-            for (std::uint8_t Iterator = 0U; Iterator < g_ImageCount; ++Iterator)
+            for (std::uint8_t Iterator = 0U; Iterator < g_MaxFramesInFlight; ++Iterator)
             {
                 ResetCommandPool(Iterator);
             }
 
-            ResetFenceStatus();
+            InvalidateCachedSceneCommands();
+            ReleaseRenderGraphs();
+
             DestroySwapChainImages();
             DestroyOffscreenImages();
             ReleasePipelineResources(false);
 
-            if (HasAnyFlag(g_ObjectsManagementStateFlags,
-                           RendererObjectsManagementStateFlags::PENDING_CLEAR | RendererObjectsManagementStateFlags::PENDING_UNLOAD))
-            {
-                if (HasFlag(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_CLEAR))
-                {
-                    DestroyObjects();
-                }
-                else if (HasFlag(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_UNLOAD))
-                {
-                    UnloadObjects(g_ModelsToUnload);
-                }
-
-                g_ModelsToUnload.clear();
-                RemoveFlags(g_ObjectsManagementStateFlags,
-                            RendererObjectsManagementStateFlags::PENDING_CLEAR | RendererObjectsManagementStateFlags::PENDING_UNLOAD);
-            }
-
-            if (HasFlag(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD))
-            {
-                for (auto const &ModelPath : g_ModelsToLoad)
-                {
-                    LoadScene(ModelPath);
-                }
-
-                g_ModelsToLoad.clear();
-                RemoveFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD);
-            }
-
-            RemoveFlags(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_DESTRUCTION);
             AddFlags(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_CREATION);
         }
 
         if (!HasAnyFlag(g_StateFlags, RendererStateFlags::INVALID_SIZE | RendererStateFlags::PENDING_DEVICE_PROPERTIES_UPDATE) &&
             HasFlag(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_CREATION))
         {
-            auto const SurfaceProperties = GetSurfaceProperties();
+            auto const SurfaceProperties = GetRenderSurfaceProperties();
 
             if (!SurfaceProperties.IsValid())
             {
@@ -102,10 +216,16 @@ void Renderer::DrawFrame(double const DeltaTime)
                 return;
             }
 
-            auto const SurfaceCapabilities = GetSurfaceCapabilities();
+            if (g_Headless)
+            {
+                SetCachedSurfaceProperties(SurfaceProperties);
+            }
+            else
+            {
+                CreateSwapChain(SurfaceProperties, GetSurfaceCapabilities());
+            }
 
-            CreateSwapChain(SurfaceProperties, SurfaceCapabilities);
-            CreateDepthResources(SurfaceProperties);
+            SetDepthFormat(SurfaceProperties.DepthFormat);
 
             if (!HasFlag(g_StateFlags, RendererStateFlags::INITIALIZED))
             {
@@ -120,9 +240,9 @@ void Renderer::DrawFrame(double const DeltaTime)
                 AddFlags(g_StateFlags, RendererStateFlags::INITIALIZED);
             }
 
-            if (g_RenderOffscreen)
+            if (Renderer::GetRenderOffscreen())
             {
-                CreateOffscreenResources(SurfaceProperties);
+                CreateOffscreenResources(SurfaceProperties, RenderCore::GetFramesInFlight());
             }
 
             if (g_OnRefreshCallback)
@@ -140,25 +260,126 @@ void Renderer::DrawFrame(double const DeltaTime)
             PipelineDescriptorData &PipelineDescriptor = GetPipelineDescriptorData();
             PipelineDescriptor.SetupSceneBuffer(GetSceneUniformBuffer());
             PipelineDescriptor.SetupModelsBuffer(GetObjects());
-            SetNumObjectsPerThread(GetNumAllocations());
 
             RemoveFlags(g_StateFlags, RendererStateFlags::PENDING_PIPELINE_REFRESH);
         }
     }
 
-    if (!HasAnyFlag(g_StateFlags, InvalidStatesToRender) && RequestSwapChainImage(g_ImageIndex))
+    if (HasAnyFlag(g_StateFlags, InvalidStatesToRender))
     {
+        return;
+    }
+
+    {
+        RENDERCORE_PROFILE_SCOPE("WaitForFrame");
+        WaitForFrame(g_FrameIndex);
+    }
+
+    {
+        std::lock_guard Lock { GetSceneMutex() };
+        ProcessObjectsManagement();
+        UpdateTextureResidency(Snapshot);
+    }
+
+    if (g_Headless)
+    {
+        g_ImageIndex = g_FrameIndex;
+    }
+
+    if (g_Headless || RequestSwapChainImage(g_FrameIndex, g_ImageIndex))
+    {
+        ResetCommandPool(g_FrameIndex);
+
         if (g_OnDrawCallback)
         {
             g_OnDrawCallback();
         }
 
-        UpdateSceneUniformBuffer();
-        Tick();
+        {
+            ScopedFrameTimer const Timer { FrameStage::UniformUpdate };
+            RENDERCORE_PROFILE_SCOPE("UniformUpdate");
+            UpdateSceneUniformBuffer(g_FrameIndex, Snapshot);
+            UpdateObjectsUniformBuffer(g_FrameIndex, Snapshot);
+            UpdateObjectsTextureDescriptors(g_FrameIndex, Snapshot);
+        }
+
+        {
+            ScopedFrameTimer const Timer { FrameStage::CommandRecording };
+            RENDERCORE_PROFILE_SCOPE("CommandRecording");
+            RecordCommandBuffers(g_FrameIndex, g_ImageIndex, Snapshot);
+        }
 
-        RecordCommandBuffers(g_ImageIndex);
-        SubmitCommandBuffers(g_ImageIndex);
-        PresentFrame(g_ImageIndex);
+        {
+            ScopedFrameTimer const Timer { FrameStage::Submission };
+            RENDERCORE_PROFILE_SCOPE("Submission");
+            SubmitCommandBuffers(g_FrameIndex, g_ImageIndex);
+        }
+
+        if (!g_Headless)
+        {
+            ScopedFrameTimer const Timer { FrameStage::Presentation };
+            RENDERCORE_PROFILE_SCOPE("Presentation");
+            PresentFrame(g_ImageIndex);
+        }
+
+        g_FrameIndex = (g_FrameIndex + 1U) % RenderCore::GetFramesInFlight();
+
+        RENDERCORE_PROFILE_FRAME();
+    }
+}
+
+// Frames skipped while resources are refreshed or no swapchain image is available are still recorded, so the stats cover every tick
+void RenderFrame(SceneSnapshot const &Snapshot)
+{
+    RENDERCORE_PROFILE_FUNCTION();
+
+    auto const FrameStartTime = std::chrono::steady_clock::now();
+
+    BeginFrameRecord();
+    AddFrameStageTime(FrameStage::Tick, Snapshot.TickTime);
+
+    ProcessFrame(Snapshot);
+
+    AddFrameStageTime(FrameStage::Frame, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - FrameStartTime).count());
+    CommitFrameRecord();
+}
+
+void RenderThreadLoop(std::stop_token const &StopToken)
+{
+    RENDERCORE_PROFILE_THREAD("Render Thread");
+
+    while (!StopToken.stop_requested())
+    {
+        if (SceneSnapshot const *Snapshot = AcquireSnapshot(std::chrono::milliseconds { 100 });
+            Snapshot)
+        {
+            {
+                ScopedRendererLock const Lock {};
+                RenderFrame(*Snapshot);
+            }
+
+            ReleaseSnapshot();
+        }
+    }
+}
+
+void Renderer::DrawFrame(double const DeltaTime)
+{
+    if (GetUseRenderThread())
+    {
+        SimulateFrame(static_cast<float>(DeltaTime));
+        return;
+    }
+
+    ScopedRendererLock const Lock {};
+
+    SimulateFrame(static_cast<float>(DeltaTime));
+
+    if (SceneSnapshot const *Snapshot = AcquireSnapshot(std::chrono::milliseconds { 0 });
+        Snapshot)
+    {
+        RenderFrame(*Snapshot);
+        ReleaseSnapshot();
     }
 }
 
@@ -177,17 +398,23 @@ bool Renderer::Initialize()
 
     CheckVulkanResult(volkInitialize());
     [[maybe_unused]] bool const _ = CreateVulkanInstance();
-    CreateVulkanSurface();
+    if (!g_Headless)
+    {
+        CreateVulkanSurface();
+    }
+
     InitializeDevice(GetSurface());
     volkLoadDevice(GetLogicalDevice());
 
     InitializeCommandsResources(GetGraphicsQueue().first);
     CreateSynchronizationObjects();
+    CreateQueryResources();
     CreateMemoryAllocator();
+    CreateUploadResources();
     CreateSceneUniformBuffer();
     CreateImageSampler();
     CompileDefaultShaders();
-    auto const SurfaceProperties = GetSurfaceProperties();
+    auto const SurfaceProperties = GetRenderSurfaceProperties();
     AllocateEmptyTexture(SurfaceProperties.Format.format);
 
     AddFlags(g_StateFlags, RendererStateFlags::PENDING_RESOURCES_CREATION);
@@ -202,22 +429,30 @@ void Renderer::Shutdown()
         return;
     }
 
-    std::lock_guard const Lock { g_RendererMutex };
+    SetUseRenderThread(false);
+
+    ScopedRendererLock const Lock {};
 
+    ReleaseUploadResources();
+    ReleaseTextureResidency();
     ReleaseSynchronizationObjects();
     ReleaseCommandsResources();
+    ReleaseQueryResources();
 
     if (g_OnShutdownCallback)
     {
         g_OnShutdownCallback();
     }
 
+    ReleaseTransientCommandPools();
     DestroyOffscreenImages();
 
     ReleaseSwapChainResources();
     ReleaseShaderResources();
     ReleaseSceneResources();
     ReleasePipelineResources(true);
+    ReleaseIndirectDrawResources();
+    ReleaseRetiredResources(true);
     ReleaseMemoryResources();
     ReleaseDeviceResources();
     DestroyVulkanInstance();
@@ -261,6 +496,161 @@ void Renderer::SetUseDefaultSync(bool const Value)
     RequestUpdateResources();
 }
 
+void Renderer::SetFramesInFlight(std::uint8_t const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        if (RenderCore::GetFramesInFlight() != Value)
+        {
+            RenderCore::SetFramesInFlight(Value);
+        }
+    });
+
+    RequestUpdateResources();
+}
+
+void Renderer::SetHeadless(bool const Value)
+{
+    if (IsInitialized())
+    {
+        BOOST_LOG_TRIVIAL(warning) << "[" << __func__ << "]: Headless mode can only be changed before the renderer is initialized";
+        return;
+    }
+
+    g_Headless = Value;
+}
+
+void Renderer::SetHeadlessExtent(VkExtent2D const &Value)
+{
+    DispatchToNextTick([Value]
+    {
+        g_HeadlessExtent = Value;
+    });
+
+    RequestUpdateResources();
+}
+
+void Renderer::SetUseRenderThread(bool const Value)
+{
+    if (Value == GetUseRenderThread())
+    {
+        return;
+    }
+
+    if (Value)
+    {
+        g_RenderThread = std::jthread(RenderThreadLoop);
+        return;
+    }
+
+    g_RenderThread.request_stop();
+    g_RenderThread.join();
+    g_RenderThread = {};
+
+    while (AcquireSnapshot(std::chrono::milliseconds { 0 }) != nullptr)
+    {
+        ReleaseSnapshot();
+    }
+}
+
+void Renderer::SetCollectPipelineStatistics(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetCollectPipelineStatistics(Value);
+    });
+}
+
+void Renderer::SetCacheSceneCommands(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetCacheSceneCommands(Value);
+    });
+}
+
+void Renderer::SetUseIndirectDraws(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetUseIndirectDraws(Value);
+    });
+}
+
+void Renderer::SetUseGPUCulling(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetUseGPUCulling(Value);
+    });
+}
+
+void Renderer::SetUseAsyncCulling(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetUseAsyncCulling(Value);
+    });
+}
+
+void Renderer::SetGeometryPlacement(GeometryPlacement const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        if (RenderCore::GetGeometryPlacement() != Value)
+        {
+            RenderCore::SetGeometryPlacement(Value);
+
+            if (HasGeometryHeap())
+            {
+                RebuildGeometryHeap(0U);
+            }
+        }
+    });
+}
+
+void Renderer::SetResidencyBudget(VkDeviceSize const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetResidencyBudget(Value);
+    });
+}
+
+void Renderer::SetUseTextureStreaming(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetUseTextureStreaming(Value);
+    });
+}
+
+void Renderer::SetStreamingBandwidth(VkDeviceSize const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetStreamingBandwidth(Value);
+    });
+}
+
+void Renderer::SetGenerateTextureMipmaps(bool const Value)
+{
+    DispatchToNextTick([Value]
+    {
+        RenderCore::SetGenerateTextureMipmaps(Value);
+    });
+}
+
+std::uint8_t Renderer::GetFramesInFlight()
+{
+    return RenderCore::GetFramesInFlight();
+}
+
+GPUFrameTimings Renderer::GetGPUFrameTimings()
+{
+    return GetLatestGPUFrameTimings();
+}
+
 std::shared_ptr<Object> Renderer::GetObjectByID(std::uint32_t const ObjectID)
 {
     return *std::ranges::find_if(GetObjects(),
@@ -286,7 +676,13 @@ std::vector<VkImageView> Renderer::GetOffscreenImages()
 
 void Renderer::SaveOffscreenFrameToImage(strzilla::string_view const Path)
 {
-    ImageAllocation const &OffscreenImage = RenderCore::GetOffscreenImages().at(g_ImageIndex);
+    ScopedRendererLock const Lock {};
+
+    std::uint8_t const  FramesInFlight = RenderCore::GetFramesInFlight();
+    std::uint32_t const LastFrame      = (g_FrameIndex + FramesInFlight - 1U) % FramesInFlight;
+    WaitForFrame(LastFrame);
+
+    ImageAllocation const &OffscreenImage = RenderCore::GetOffscreenImages().at(LastFrame);
     SaveImageToFile(OffscreenImage.Image, Path, OffscreenImage.Extent);
 }
 
@@ -297,40 +693,58 @@ std::vector<std::shared_ptr<Texture>> Renderer::LoadImages(std::vector<strzilla:
         return {};
     }
 
+    // The flush submits to the graphics queue the render thread also submits to
+    ScopedRendererLock const Lock {};
+
     std::vector<std::shared_ptr<Texture>> OutputImages;
     OutputImages.reserve(std::size(Paths));
 
-    VkCommandPool                CommandPool { VK_NULL_HANDLE };
-    std::vector<VkCommandBuffer> CommandBuffers { VK_NULL_HANDLE };
-
-    auto const &                                [QueueIndex, Queue] = GetGraphicsQueue();
-    std::unordered_map<VkBuffer, VmaAllocation> BufferAllocations {};
-
-    InitializeSingleCommandQueue(CommandPool, CommandBuffers, QueueIndex);
+    VkCommandBuffer CommandBuffer = BeginUpload();
     {
-        VkCommandBuffer &CommandBuffer = CommandBuffers.at(0U);
-
         for (strzilla::string_view const &PathIt : Paths)
         {
-            TextureConstructionOutputParameters Output {};
-
-            if (std::shared_ptr<Texture> NewTexture = ConstructTextureFromFile(PathIt, CommandBuffer, Output);
+            if (std::shared_ptr<Texture> NewTexture = ConstructTextureFromFile(PathIt, CommandBuffer);
                 NewTexture)
             {
                 NewTexture->SetupTexture();
 
                 OutputImages.push_back(std::move(NewTexture));
-                BufferAllocations.emplace(std::move(Output.StagingBuffer), std::move(Output.StagingAllocation));
             }
         }
     }
-    FinishSingleCommandQueue(Queue, CommandPool, CommandBuffers);
+    SubmitUpload(CommandBuffer, {});
+
+    // Callers use the images right away
+    FlushUploads();
+
+    return OutputImages;
+}
+
+void Renderer::RequestLoadObject(strzilla::string_view const ObjectPath)
+{
+    std::lock_guard Lock { g_ObjectsManagementMutex };
+
+    g_ModelsToLoad.emplace_back(ObjectPath);
+    AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD);
+}
 
-    VmaAllocator const &Allocator = GetAllocator();
-    for (auto &[Buffer, Allocation] : BufferAllocations)
+void Renderer::RequestUnloadObjects(std::vector<std::uint32_t> const &ObjectIDs)
+{
+    // Objects destroyed by the unload or clear being applied; their IDs may be reused by the loads that follow
+    if (g_ProcessingObjectsManagement)
     {
-        vmaDestroyBuffer(Allocator, Buffer, Allocation);
+        return;
     }
 
-    return OutputImages;
+    std::lock_guard Lock { g_ObjectsManagementMutex };
+
+    g_ModelsToUnload.insert(std::end(g_ModelsToUnload), std::begin(ObjectIDs), std::end(ObjectIDs));
+    AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_UNLOAD);
+}
+
+void Renderer::RequestClearScene()
+{
+    std::lock_guard Lock { g_ObjectsManagementMutex };
+
+    AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_CLEAR);
 }
@@ -84,17 +84,24 @@ void DescriptorData::DestroyResources(VmaAllocator const &Allocator, bool const
         BufferDeviceAddress.deviceAddress = 0U;
         LayoutOffset                      = 0U;
         LayoutSize                        = 0U;
+        BindingOffsets.clear();
     }
 
     Buffer.DestroyResources(Allocator);
 }
 
-void DescriptorData::SetDescriptorLayoutSize(VkDeviceSize const &MinAlignment)
+void DescriptorData::SetDescriptorLayoutSize(VkDeviceSize const &MinAlignment, std::uint32_t const NumBindings)
 {
     VkDevice const &LogicalDevice = GetLogicalDevice();
 
     vkGetDescriptorSetLayoutSizeEXT(LogicalDevice, SetLayout, &LayoutSize);
     LayoutSize = LayoutSize + MinAlignment - 1 & ~(MinAlignment - 1);
 
-    vkGetDescriptorSetLayoutBindingOffsetEXT(LogicalDevice, SetLayout, 0U, &LayoutOffset);
+    BindingOffsets.resize(NumBindings);
+    for (std::uint32_t Binding = 0U; Binding < NumBindings; ++Binding)
+    {
+        vkGetDescriptorSetLayoutBindingOffsetEXT(LogicalDevice, SetLayout, Binding, &BindingOffsets.at(Binding));
+    }
+
+    LayoutOffset = BindingOffsets.at(0U);
 }
@@ -38,10 +38,11 @@ glm::mat4 Camera::GetViewMatrix() const
 glm::mat4 Camera::GetProjectionMatrix() const
 {
     VkExtent2D const &SwapChainExtent = GetSwapChainExtent();
-    glm::mat4         Projection      = glm::perspective(glm::radians(m_FieldOfView),
-                                                         static_cast<float>(SwapChainExtent.width) / static_cast<float>(SwapChainExtent.height),
-                                                         m_NearPlane,
-                                                         m_FarPlane);
+    float const       AspectRatio     = SwapChainExtent.height > 0U
+                                            ? static_cast<float>(SwapChainExtent.width) / static_cast<float>(SwapChainExtent.height)
+                                            : m_CurrentAspectRatio;
+
+    glm::mat4 Projection = glm::perspective(glm::radians(m_FieldOfView), AspectRatio, m_NearPlane, m_FarPlane);
     Projection[1][1] *= -1;
 
     return Projection;
@@ -0,0 +1,110 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Types.CommandState;
+
+using namespace RenderCore;
+
+void CommandStateTracker::BindPipeline(VkPipeline const &Pipeline)
+{
+    if (m_Pipeline == Pipeline)
+    {
+        ++m_NumSkippedBinds;
+        return;
+    }
+
+    vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline);
+    m_Pipeline = Pipeline;
+    ++m_NumBinds;
+}
+
+void CommandStateTracker::BindDescriptorBuffers(std::array<VkDescriptorBufferBindingInfoEXT, g_NumSceneDescriptorBuffers> const &BindingInfos)
+{
+    bool IsBound = m_HasDescriptorBuffers;
+    for (std::uint32_t Index = 0U; IsBound && Index < g_NumSceneDescriptorBuffers; ++Index)
+    {
+        IsBound = m_DescriptorAddresses.at(Index) == BindingInfos.at(Index).address;
+    }
+
+    if (IsBound)
+    {
+        ++m_NumSkippedBinds;
+        return;
+    }
+
+    vkCmdBindDescriptorBuffersEXT(m_CommandBuffer, g_NumSceneDescriptorBuffers, std::data(BindingInfos));
+
+    for (std::uint32_t Index = 0U; Index < g_NumSceneDescriptorBuffers; ++Index)
+    {
+        m_DescriptorAddresses.at(Index) = BindingInfos.at(Index).address;
+    }
+
+    // Offsets refer to the buffer indices just replaced, they have to be set again
+    m_HasDescriptorBuffers = true;
+    m_HasDescriptorOffsets = false;
+    ++m_NumBinds;
+}
+
+void CommandStateTracker::SetDescriptorBufferOffsets(VkPipelineLayout const &                                     PipelineLayout,
+                                                     std::array<VkDeviceSize, g_NumSceneDescriptorBuffers> const &Offsets)
+{
+    constexpr std::array<std::uint32_t, g_NumSceneDescriptorBuffers> BufferIndices { 0U, 1U, 2U };
+
+    std::uint32_t FirstSet = 0U;
+    std::uint32_t LastSet  = g_NumSceneDescriptorBuffers;
+
+    // Only the contiguous range of sets whose offsets changed is set again, usually the model and texture sets
+    if (m_HasDescriptorOffsets && m_PipelineLayout == PipelineLayout)
+    {
+        while (FirstSet < LastSet && m_DescriptorOffsets.at(FirstSet) == Offsets.at(FirstSet))
+        {
+            ++FirstSet;
+        }
+
+        while (LastSet > FirstSet && m_DescriptorOffsets.at(LastSet - 1U) == Offsets.at(LastSet - 1U))
+        {
+            --LastSet;
+        }
+    }
+
+    std::uint32_t const NumSets = LastSet - FirstSet;
+    m_NumSkippedBinds += g_NumSceneDescriptorBuffers - NumSets;
+
+    if (NumSets == 0U)
+    {
+        return;
+    }
+
+    vkCmdSetDescriptorBufferOffsetsEXT(m_CommandBuffer,
+                                       VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                       PipelineLayout,
+                                       FirstSet,
+                                       NumSets,
+                                       std::data(BufferIndices) + FirstSet,
+                                       std::data(Offsets) + FirstSet);
+
+    m_DescriptorOffsets    = Offsets;
+    m_PipelineLayout       = PipelineLayout;
+    m_HasDescriptorOffsets = true;
+    m_NumBinds += NumSets;
+}
+
+void CommandStateTracker::BindGeometryBuffer(VkBuffer const &GeometryBuffer)
+{
+    if (m_GeometryBuffer == GeometryBuffer)
+    {
+        m_NumSkippedBinds += 2U;
+        return;
+    }
+
+    constexpr VkDeviceSize GeometryOffset = 0U;
+
+    vkCmdBindVertexBuffers(m_CommandBuffer, 0U, 1U, &GeometryBuffer, &GeometryOffset);
+    vkCmdBindIndexBuffer(m_CommandBuffer, GeometryBuffer, 0U, VK_INDEX_TYPE_UINT32);
+
+    m_GeometryBuffer = GeometryBuffer;
+    m_NumBinds += 2U;
+}
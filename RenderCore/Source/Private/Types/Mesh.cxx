@@ -9,6 +9,7 @@ module;
 module RenderCore.Types.Mesh;
 
 import RenderCore.Runtime.Memory;
+import RenderCore.Utils.Profiler;
 
 using namespace RenderCore;
 
@@ -24,6 +25,8 @@ Mesh::Mesh(std::uint32_t const ID, strzilla::string_view const Path, strzilla::s
 
 void Mesh::Optimize()
 {
+    RENDERCORE_PROFILE_FUNCTION();
+
     std::size_t const IndexCount  = m_NumTriangles * 3;
     std::size_t const VertexCount = std::size(m_Vertices);
 
@@ -79,11 +82,14 @@ void Mesh::SetupBounds()
     }
 }
 
-void Mesh::BindBuffers(VkCommandBuffer const &CommandBuffer, std::uint32_t const NumInstances) const
+void Mesh::DrawIndexed(CommandStateTracker &StateTracker, std::uint32_t const NumInstances) const
 {
-    VkBuffer const &AllocationBuffer = GetAllocationBuffer();
-
-    vkCmdBindVertexBuffers(CommandBuffer, 0U, 1U, &AllocationBuffer, &m_VertexOffset);
-    vkCmdBindIndexBuffer(CommandBuffer, AllocationBuffer, m_IndexOffset, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(CommandBuffer, static_cast<std::uint32_t>(std::size(m_Indices)), NumInstances, 0U, 0U, 0U);
+    StateTracker.BindGeometryBuffer(GetAllocationBuffer());
+
+    vkCmdDrawIndexed(StateTracker.GetCommandBuffer(),
+                     static_cast<std::uint32_t>(std::size(m_Indices)),
+                     NumInstances,
+                     static_cast<std::uint32_t>(m_IndexOffset / sizeof(std::uint32_t)),
+                     static_cast<std::int32_t>(m_VertexOffset / sizeof(Vertex)),
+                     0U);
 }
@@ -9,10 +9,19 @@ module RenderCore.Types.Object;
 import RenderCore.Renderer;
 import RenderCore.Runtime.Memory;
 import RenderCore.Runtime.Pipeline;
+import RenderCore.Types.Allocation;
+import RenderCore.Types.Material;
+import RenderCore.Types.Mesh;
 import RenderCore.Types.UniformBufferObject;
+import RenderCore.Utils.Constants;
 
 using namespace RenderCore;
 
+std::uint8_t GetFramesInFlightMask()
+{
+    return static_cast<std::uint8_t>((1U << Renderer::GetFramesInFlight()) - 1U);
+}
+
 Object::Object(std::uint32_t const ID, strzilla::string_view const Path)
     : Resource(ID, Path)
 {
@@ -25,6 +34,11 @@ Object::Object(std::uint32_t const ID, strzilla::string_view const Path, strzill
 
 void Object::Destroy()
 {
+    if (IsPendingDestroy())
+    {
+        return;
+    }
+
     Resource::Destroy();
     Renderer::RequestUnloadObjects({ GetID() });
 }
@@ -32,85 +46,76 @@ void Object::Destroy()
 void Object::SetupUniformDescriptor()
 {
     m_UniformBufferInfo = GetAllocationBufferDescriptor(m_UniformOffset, sizeof(ModelUniformData));
-    m_MappedData        = GetAllocationMappedData();
+    m_MappedData        = GetUniformAllocationMappedData();
+}
+
+ModelUniformData Object::GetUniformData() const
+{
+    if (!m_Mesh)
+    {
+        return {};
+    }
+
+    MaterialData const &Material = m_Mesh->GetMaterialData();
+
+    return ModelUniformData {
+            .Model = m_Transform.GetMatrix() * m_Mesh->GetTransform().GetMatrix(),
+            .BaseColorFactor = Material.BaseColorFactor,
+            .EmissiveFactor = Material.EmissiveFactor,
+            .MetallicFactor = static_cast<double>(Material.MetallicFactor),
+            .RoughnessFactor = static_cast<double>(Material.RoughnessFactor),
+            .AlphaCutoff = static_cast<double>(Material.AlphaCutoff),
+            .NormalScale = static_cast<double>(Material.NormalScale),
+            .OcclusionStrength = static_cast<double>(Material.OcclusionStrength),
+            .AlphaMode = static_cast<std::int32_t>(Material.AlphaMode),
+            .DoubleSided = static_cast<std::int32_t>(Material.DoubleSided)
+    };
 }
 
-void Object::UpdateUniformBuffers() const
+void Object::InvalidateUniformFrames() const
+{
+    m_DirtyFrames = GetFramesInFlightMask();
+}
+
+void Object::InvalidateTextureFrames() const
+{
+    m_DirtyTextureFrames = GetFramesInFlightMask();
+}
+
+void Object::UpdateUniformBuffers(std::uint32_t const FrameIndex, ModelUniformData const &UniformData, bool const IsDirty) const
 {
     if (!m_MappedData)
     {
         return;
     }
 
-    if (m_IsRenderDirty)
+    if (IsDirty)
+    {
+        InvalidateUniformFrames();
+    }
+
+    if (auto const FrameMask = static_cast<std::uint8_t>(1U << FrameIndex);
+        m_DirtyFrames & FrameMask)
     {
-        constexpr auto ModelUBOSize = sizeof(ModelUniformData);
-
-        ModelUniformData const UpdatedModelUBO {
-                .Model = m_Transform.GetMatrix() * m_Mesh->GetTransform().GetMatrix(),
-                .BaseColorFactor = m_Mesh->GetMaterialData().BaseColorFactor,
-                .EmissiveFactor = m_Mesh->GetMaterialData().EmissiveFactor,
-                .MetallicFactor = static_cast<double>(m_Mesh->GetMaterialData().MetallicFactor),
-                .RoughnessFactor = static_cast<double>(m_Mesh->GetMaterialData().RoughnessFactor),
-                .AlphaCutoff = static_cast<double>(m_Mesh->GetMaterialData().AlphaCutoff),
-                .NormalScale = static_cast<double>(m_Mesh->GetMaterialData().NormalScale),
-                .OcclusionStrength = static_cast<double>(m_Mesh->GetMaterialData().OcclusionStrength),
-                .AlphaMode = static_cast<std::int32_t>(m_Mesh->GetMaterialData().AlphaMode),
-                .DoubleSided = static_cast<std::int32_t>(m_Mesh->GetMaterialData().DoubleSided)
-        };
-
-        std::memcpy(static_cast<char *>(m_MappedData) + GetUniformOffset(), &UpdatedModelUBO, ModelUBOSize);
-        m_IsRenderDirty = false;
+        std::memcpy(static_cast<char *>(m_MappedData) + GetUniformOffset() + FrameIndex * GetModelUniformStride(), &UniformData, sizeof(ModelUniformData));
+        // Slots dropped by a lower frames-in-flight count are never written again, clear them along the way
+        m_DirtyFrames &= static_cast<std::uint8_t>(~FrameMask) & GetFramesInFlightMask();
     }
 }
 
-void Object::DrawObject(VkCommandBuffer const &CommandBuffer, VkPipelineLayout const &PipelineLayout, std::uint32_t const ObjectIndex) const
+void Object::DrawObject(CommandStateTracker &    StateTracker,
+                        VkPipelineLayout const &PipelineLayout,
+                        std::uint32_t const     FrameIndex,
+                        std::uint32_t const     NumInstances) const
 {
     if (!m_Mesh)
     {
         return;
     }
 
-    auto const &[SceneData, ModelData, TextureData] = GetPipelineDescriptorData();
-
-    std::array const BufferBindingInfos {
-            VkDescriptorBufferBindingInfoEXT
-            {
-                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
-                    .address = SceneData.BufferDeviceAddress.deviceAddress,
-                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
-            },
-            VkDescriptorBufferBindingInfoEXT {
-                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
-                    .address = ModelData.BufferDeviceAddress.deviceAddress,
-                    .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
-            },
-            VkDescriptorBufferBindingInfoEXT {
-                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
-                    .address = TextureData.BufferDeviceAddress.deviceAddress,
-                    .usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
-            }
-    };
-
-    vkCmdBindDescriptorBuffersEXT(CommandBuffer, static_cast<std::uint32_t>(std::size(BufferBindingInfos)), std::data(BufferBindingInfos));
-
-    constexpr std::array BufferIndices { 0U, 1U, 2U };
-
-    constexpr auto NumTextures = static_cast<std::uint8_t>(TextureType::Count);
-
-    std::array const BufferOffsets {
-            SceneData.LayoutOffset,
-            ObjectIndex * ModelData.LayoutSize + ModelData.LayoutOffset,
-            ObjectIndex * NumTextures * TextureData.LayoutSize + TextureData.LayoutOffset
-    };
-
-    vkCmdSetDescriptorBufferOffsetsEXT(CommandBuffer,
-                                       VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                       PipelineLayout,
-                                       0U,
-                                       static_cast<std::uint32_t>(std::size(BufferBindingInfos)),
-                                       std::data(BufferIndices),
-                                       std::data(BufferOffsets));
+    PipelineDescriptorData const &PipelineDescriptors = GetPipelineDescriptorData();
+    PipelineDescriptors.BindSceneDescriptorBuffers(StateTracker);
+    PipelineDescriptors.SetObjectDescriptorOffsets(StateTracker, PipelineLayout, FrameIndex, GetBufferIndex());
 
-    m_Mesh->BindBuffers(CommandBuffer, std::empty(m_InstanceTransform) ? 1U : GetNumInstances());
+    m_Mesh->DrawIndexed(StateTracker, std::max(NumInstances, 1U));
 }
\ No newline at end of file
@@ -35,7 +35,12 @@ void Texture::AppendType(TextureType const Type)
     m_Types.push_back(Type);
 }
 
+void Texture::SetSampler(VkSampler const Sampler)
+{
+    m_Sampler = Sampler;
+}
+
 void Texture::SetupTexture()
 {
-    m_ImageDescriptor = GetAllocationImageDescriptor(GetID() == UINT32_MAX ? 0U : GetBufferIndex());
+    m_ImageDescriptor = GetAllocationImageDescriptor(GetID() == UINT32_MAX ? 0U : GetBufferIndex(), m_Sampler);
 }
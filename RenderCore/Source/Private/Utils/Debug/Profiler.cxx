@@ -0,0 +1,174 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.Profiler;
+
+using namespace RenderCore;
+
+struct ProfilerEvent
+{
+    char const * Name { nullptr };
+    std::int64_t Start { 0 };
+    std::int64_t Duration { 0 };
+    bool         IsInstant { false };
+};
+
+struct ProfilerThreadBuffer
+{
+    std::mutex                 Mutex {};
+    std::uint32_t              ThreadId { 0U };
+    strzilla::string           ThreadName {};
+    std::vector<ProfilerEvent> Events {};
+};
+
+std::mutex                                         g_ProfilerBuffersMutex {};
+std::vector<std::shared_ptr<ProfilerThreadBuffer>> g_ProfilerBuffers {};
+std::chrono::steady_clock::time_point              g_ProfilerEpoch { std::chrono::steady_clock::now() };
+
+ProfilerThreadBuffer &GetThreadBuffer()
+{
+    thread_local std::shared_ptr<ProfilerThreadBuffer> const Buffer = []
+    {
+        auto NewBuffer = std::make_shared<ProfilerThreadBuffer>();
+
+        std::lock_guard const Lock(g_ProfilerBuffersMutex);
+        NewBuffer->ThreadId = static_cast<std::uint32_t>(std::size(g_ProfilerBuffers));
+        g_ProfilerBuffers.push_back(NewBuffer);
+
+        return NewBuffer;
+    }();
+
+    return *Buffer;
+}
+
+std::int64_t ToTraceTime(std::chrono::steady_clock::time_point const TimePoint)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(TimePoint - g_ProfilerEpoch).count();
+}
+
+void WriteEscaped(std::ofstream &Stream, strzilla::string_view const Value)
+{
+    for (char const Character : Value)
+    {
+        if (Character == '"' || Character == '\\')
+        {
+            Stream << '\\';
+        }
+
+        Stream << (static_cast<unsigned char>(Character) < 0x20U ? ' ' : Character);
+    }
+}
+
+void RenderCore::RecordProfilerZone(char const *const                           Name,
+                                    std::chrono::steady_clock::time_point const Start,
+                                    std::chrono::steady_clock::time_point const End)
+{
+    ProfilerThreadBuffer &Buffer = GetThreadBuffer();
+
+    std::lock_guard const Lock(Buffer.Mutex);
+    Buffer.Events.push_back(ProfilerEvent {
+            .Name = Name,
+            .Start = ToTraceTime(Start),
+            .Duration = std::chrono::duration_cast<std::chrono::microseconds>(End - Start).count()
+    });
+}
+
+void RenderCore::SetProfilerThreadName(char const *const Name)
+{
+    ProfilerThreadBuffer &Buffer = GetThreadBuffer();
+
+    std::lock_guard const Lock(Buffer.Mutex);
+    Buffer.ThreadName = Name;
+}
+
+void RenderCore::MarkProfilerFrame()
+{
+    if (!IsProfilerCapturing())
+    {
+        return;
+    }
+
+    ProfilerThreadBuffer &Buffer = GetThreadBuffer();
+
+    std::lock_guard const Lock(Buffer.Mutex);
+    Buffer.Events.push_back(ProfilerEvent { .Name = "Frame", .Start = ToTraceTime(std::chrono::steady_clock::now()), .IsInstant = true });
+}
+
+void RenderCore::StartProfilerCapture()
+{
+    {
+        std::lock_guard const Lock(g_ProfilerBuffersMutex);
+        for (auto const &BufferIter : g_ProfilerBuffers)
+        {
+            std::lock_guard const BufferLock(BufferIter->Mutex);
+            BufferIter->Events.clear();
+        }
+    }
+
+    g_IsProfilerCapturing.store(true, std::memory_order_relaxed);
+}
+
+bool RenderCore::StopProfilerCapture(strzilla::string_view const Path)
+{
+    g_IsProfilerCapturing.store(false, std::memory_order_relaxed);
+
+    std::ofstream Stream(std::filesystem::path { std::data(Path), std::data(Path) + std::size(Path) }, std::ios::out | std::ios::trunc);
+    if (!Stream.is_open())
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to open trace file: " << Path;
+        return false;
+    }
+
+    Stream << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+    bool          IsFirstEvent = true;
+    std::uint64_t NumEvents    = 0U;
+
+    auto const BeginEvent = [&Stream, &IsFirstEvent]
+    {
+        Stream << (IsFirstEvent ? "\n" : ",\n");
+        IsFirstEvent = false;
+    };
+
+    std::lock_guard const Lock(g_ProfilerBuffersMutex);
+    for (auto const &BufferIter : g_ProfilerBuffers)
+    {
+        std::lock_guard const BufferLock(BufferIter->Mutex);
+
+        if (!std::empty(BufferIter->ThreadName))
+        {
+            BeginEvent();
+            Stream << R"({"ph":"M","name":"thread_name","pid":0,"tid":)" << BufferIter->ThreadId << R"(,"args":{"name":")";
+            WriteEscaped(Stream, BufferIter->ThreadName);
+            Stream << R"("}})";
+        }
+
+        for (ProfilerEvent const &EventIter : BufferIter->Events)
+        {
+            BeginEvent();
+            Stream << R"({"name":")";
+            WriteEscaped(Stream, EventIter.Name);
+
+            if (EventIter.IsInstant)
+            {
+                Stream << R"(","ph":"i","s":"g","pid":0,"tid":)" << BufferIter->ThreadId << R"(,"ts":)" << EventIter.Start << "}";
+            }
+            else
+            {
+                Stream << R"(","ph":"X","pid":0,"tid":)" << BufferIter->ThreadId << R"(,"ts":)" << EventIter.Start;
+                Stream << R"(,"dur":)" << EventIter.Duration << "}";
+            }
+        }
+
+        NumEvents += std::size(BufferIter->Events);
+        BufferIter->Events.clear();
+    }
+
+    Stream << "\n]}\n";
+
+    BOOST_LOG_TRIVIAL(info) << "[" << __func__ << "]: Wrote " << NumEvents << " profiler events to " << Path;
+    return true;
+}
@@ -0,0 +1,228 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+module RenderCore.Utils.FrameStats;
+
+import RenderCore.Utils.Constants;
+
+using namespace RenderCore;
+
+static_assert(std::is_trivially_copyable_v<FrameRecord>);
+
+// The record is stored as relaxed atomic words so a reader racing the writer sees torn values (and discards them) instead of a data race
+constexpr std::size_t g_FrameRecordWords = (sizeof(FrameRecord) + sizeof(std::uint64_t) - 1U) / sizeof(std::uint64_t);
+
+using FrameRecordWords = std::array<std::uint64_t, g_FrameRecordWords>;
+
+struct FrameRecordSlot
+{
+    std::atomic<std::uint64_t>                                 Sequence { 0U };
+    std::array<std::atomic<std::uint64_t>, g_FrameRecordWords> Words {};
+};
+
+FrameRecord                                       g_CurrentFrameRecord {};
+std::array<FrameRecordSlot, g_FrameStatsCapacity> g_FrameRecordSlots {};
+std::atomic<std::uint64_t>                        g_NumCommittedFrames { 0U };
+std::atomic<std::uint64_t>                        g_FirstValidFrame { 0U };
+
+FrameTimeSummary RenderCore::SummarizeFrameTimes(std::vector<double> &Times)
+{
+    if (std::empty(Times))
+    {
+        return {};
+    }
+
+    std::ranges::sort(Times);
+
+    auto const Percentile = [&Times](double const Value)
+    {
+        auto const Index = static_cast<std::size_t>(std::ceil(Value * static_cast<double>(std::size(Times))));
+        return Times.at(std::clamp<std::size_t>(Index, 1U, std::size(Times)) - 1U);
+    };
+
+    return FrameTimeSummary {
+            .Min = Times.front(),
+            .Average = std::accumulate(std::cbegin(Times), std::cend(Times), 0.0) / static_cast<double>(std::size(Times)),
+            .P50 = Percentile(0.50),
+            .P95 = Percentile(0.95),
+            .P99 = Percentile(0.99),
+            .Max = Times.back()
+    };
+}
+
+void RenderCore::BeginFrameRecord()
+{
+    g_CurrentFrameRecord = FrameRecord { .FrameNumber = g_NumCommittedFrames.load(std::memory_order_relaxed) };
+}
+
+void RenderCore::AddFrameStageTime(FrameStage const Stage, double const Milliseconds)
+{
+    g_CurrentFrameRecord.StageTimes.at(static_cast<std::size_t>(Stage)) += Milliseconds;
+}
+
+void RenderCore::SetThreadRecordingTime(std::uint32_t const ThreadIndex, double const Milliseconds)
+{
+    if (ThreadIndex >= g_MaxTimedRecordingThreads)
+    {
+        return;
+    }
+
+    g_CurrentFrameRecord.ThreadRecordingTimes.at(ThreadIndex) = Milliseconds;
+}
+
+void RenderCore::SetThreadDrawCount(std::uint32_t const ThreadIndex, std::uint32_t const NumDraws)
+{
+    if (ThreadIndex >= g_MaxTimedRecordingThreads)
+    {
+        return;
+    }
+
+    g_CurrentFrameRecord.ThreadDrawCounts.at(ThreadIndex) = NumDraws;
+}
+
+void RenderCore::SetThreadSkippedBinds(std::uint32_t const ThreadIndex, std::uint32_t const NumSkippedBinds)
+{
+    if (ThreadIndex >= g_MaxTimedRecordingThreads)
+    {
+        return;
+    }
+
+    g_CurrentFrameRecord.ThreadSkippedBinds.at(ThreadIndex) = NumSkippedBinds;
+}
+
+void RenderCore::CommitFrameRecord()
+{
+    std::uint32_t NumThreads = g_MaxTimedRecordingThreads;
+    while (NumThreads > 0U && g_CurrentFrameRecord.ThreadRecordingTimes.at(NumThreads - 1U) <= 0.0)
+    {
+        --NumThreads;
+    }
+
+    g_CurrentFrameRecord.NumRecordingThreads = NumThreads;
+    g_CurrentFrameRecord.NumDraws            = std::accumulate(std::cbegin(g_CurrentFrameRecord.ThreadDrawCounts),
+                                                               std::cend(g_CurrentFrameRecord.ThreadDrawCounts),
+                                                               0U);
+    g_CurrentFrameRecord.NumSkippedBinds     = std::accumulate(std::cbegin(g_CurrentFrameRecord.ThreadSkippedBinds),
+                                                               std::cend(g_CurrentFrameRecord.ThreadSkippedBinds),
+                                                               0U);
+
+    std::uint64_t const FrameNumber = g_NumCommittedFrames.load(std::memory_order_relaxed);
+    FrameRecordSlot &   Slot        = g_FrameRecordSlots.at(FrameNumber % g_FrameStatsCapacity);
+
+    std::uint64_t const Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+    Slot.Sequence.store(Sequence + 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    FrameRecordWords Words {};
+    std::memcpy(std::data(Words), &g_CurrentFrameRecord, sizeof(FrameRecord));
+
+    for (std::size_t WordIndex = 0U; WordIndex < g_FrameRecordWords; ++WordIndex)
+    {
+        Slot.Words.at(WordIndex).store(Words.at(WordIndex), std::memory_order_relaxed);
+    }
+
+    Slot.Sequence.store(Sequence + 2U, std::memory_order_release);
+    g_NumCommittedFrames.store(FrameNumber + 1U, std::memory_order_release);
+}
+
+void RenderCore::ResetFrameStats()
+{
+    g_FirstValidFrame.store(g_NumCommittedFrames.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+std::vector<FrameRecord> RenderCore::GetFrameRecords()
+{
+    std::uint64_t const NumCommitted = g_NumCommittedFrames.load(std::memory_order_acquire);
+    std::uint64_t const FirstFrame   = std::max(g_FirstValidFrame.load(std::memory_order_acquire),
+                                                NumCommitted > g_FrameStatsCapacity ? NumCommitted - g_FrameStatsCapacity : 0U);
+
+    std::vector<FrameRecord> Output;
+    Output.reserve(NumCommitted - std::min(FirstFrame, NumCommitted));
+
+    for (std::uint64_t FrameNumber = FirstFrame; FrameNumber < NumCommitted; ++FrameNumber)
+    {
+        FrameRecordSlot const &Slot = g_FrameRecordSlots.at(FrameNumber % g_FrameStatsCapacity);
+
+        std::uint64_t const SequenceBefore = Slot.Sequence.load(std::memory_order_acquire);
+        if (SequenceBefore % 2U != 0U)
+        {
+            continue;
+        }
+
+        FrameRecordWords Words {};
+        for (std::size_t WordIndex = 0U; WordIndex < g_FrameRecordWords; ++WordIndex)
+        {
+            Words.at(WordIndex) = Slot.Words.at(WordIndex).load(std::memory_order_relaxed);
+        }
+
+        FrameRecord Record {};
+        std::memcpy(&Record, std::data(Words), sizeof(FrameRecord));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (Slot.Sequence.load(std::memory_order_relaxed) != SequenceBefore || Record.FrameNumber != FrameNumber)
+        {
+            continue;
+        }
+
+        Output.push_back(Record);
+    }
+
+    return Output;
+}
+
+FrameStats RenderCore::ComputeFrameStats()
+{
+    std::vector<FrameRecord> const Records = GetFrameRecords();
+
+    FrameStats Output { .NumSamples = static_cast<std::uint32_t>(std::size(Records)) };
+
+    if (std::empty(Records))
+    {
+        return Output;
+    }
+
+    std::vector<double> Times;
+    Times.reserve(std::size(Records));
+
+    for (std::size_t StageIndex = 0U; StageIndex < g_NumFrameStages; ++StageIndex)
+    {
+        Times.clear();
+
+        for (FrameRecord const &RecordIter : Records)
+        {
+            Times.push_back(RecordIter.StageTimes.at(StageIndex));
+        }
+
+        Output.Stages.at(StageIndex) = SummarizeFrameTimes(Times);
+    }
+
+    auto const DrawCounts = Records | std::views::transform(&FrameRecord::NumDraws);
+    Output.AverageDraws   = std::accumulate(std::cbegin(DrawCounts), std::cend(DrawCounts), 0.0) / static_cast<double>(std::size(Records));
+    Output.MaxDraws       = std::ranges::max(DrawCounts);
+
+    auto const SkippedBinds    = Records | std::views::transform(&FrameRecord::NumSkippedBinds);
+    Output.AverageSkippedBinds = std::accumulate(std::cbegin(SkippedBinds), std::cend(SkippedBinds), 0.0) / static_cast<double>(std::size(Records));
+
+    std::uint32_t const NumThreads = std::ranges::max(Records | std::views::transform(&FrameRecord::NumRecordingThreads));
+    Output.RecordingThreads.reserve(NumThreads);
+
+    for (std::uint32_t ThreadIndex = 0U; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        Times.clear();
+
+        for (FrameRecord const &RecordIter : Records)
+        {
+            if (ThreadIndex < RecordIter.NumRecordingThreads)
+            {
+                Times.push_back(RecordIter.ThreadRecordingTimes.at(ThreadIndex));
+            }
+        }
+
+        Output.RecordingThreads.push_back(SummarizeFrameTimes(Times));
+    }
+
+    return Output;
+}
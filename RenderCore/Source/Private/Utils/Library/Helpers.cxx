@@ -147,13 +147,3 @@ std::vector<strzilla::string> RenderCore::GetAvailableInstanceLayerExtensionsNam
 
     return Output;
 }
-
-void RenderCore::DispatchQueue(std::queue<std::function<void()>> &Queue)
-{
-    while (!std::empty(Queue))
-    {
-        auto &Dispatch = Queue.front();
-        Dispatch();
-        Queue.pop();
-    }
-}
\ No newline at end of file
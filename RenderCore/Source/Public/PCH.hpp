@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <charconv>
 #include <chrono>
 #include <cstdint>
@@ -22,6 +23,7 @@
 #include <future>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <ranges>
@@ -52,4 +54,6 @@
 #include <stringzilla/stringzilla.hpp>
 namespace strzilla = ashvardanian::stringzilla;
 
+#include "Profiler.hpp"
+
 #endif // PCH_HPP
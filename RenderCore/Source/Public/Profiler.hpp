@@ -0,0 +1,41 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#pragma once
+
+#define RENDERCORE_PROFILER_NONE 0
+#define RENDERCORE_PROFILER_CHROME 1
+#define RENDERCORE_PROFILER_TRACY 2
+
+#ifndef RENDERCORE_PROFILER
+#define RENDERCORE_PROFILER RENDERCORE_PROFILER_NONE
+#endif
+
+#define RENDERCORE_PROFILE_CONCAT_INNER(Lhs, Rhs) Lhs##Rhs
+#define RENDERCORE_PROFILE_CONCAT(Lhs, Rhs) RENDERCORE_PROFILE_CONCAT_INNER(Lhs, Rhs)
+
+// Names must have static storage duration (string literals or __func__)
+#if RENDERCORE_PROFILER == RENDERCORE_PROFILER_TRACY
+#include <tracy/Tracy.hpp>
+
+#define RENDERCORE_PROFILE_SCOPE(Name) ZoneScopedN(Name)
+#define RENDERCORE_PROFILE_FUNCTION() ZoneScoped
+#define RENDERCORE_PROFILE_THREAD(Name) tracy::SetThreadName(Name)
+#define RENDERCORE_PROFILE_FRAME() FrameMark
+#elif RENDERCORE_PROFILER == RENDERCORE_PROFILER_CHROME
+#define RENDERCORE_PROFILE_SCOPE(Name) RenderCore::ProfilerZone const RENDERCORE_PROFILE_CONCAT(ProfilerZone_, __LINE__) { Name }
+#define RENDERCORE_PROFILE_FUNCTION() RENDERCORE_PROFILE_SCOPE(__func__)
+#define RENDERCORE_PROFILE_THREAD(Name) RenderCore::SetProfilerThreadName(Name)
+#define RENDERCORE_PROFILE_FRAME() RenderCore::MarkProfilerFrame()
+#else
+#define RENDERCORE_PROFILE_SCOPE(Name)
+#define RENDERCORE_PROFILE_FUNCTION()
+#define RENDERCORE_PROFILE_THREAD(Name)
+#define RENDERCORE_PROFILE_FRAME()
+#endif
+
+#endif // PROFILER_HPP
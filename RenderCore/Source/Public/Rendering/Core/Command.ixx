@@ -8,6 +8,8 @@ export module RenderCore.Runtime.Command;
 
 import ThreadPool;
 import RenderCore.Types.Allocation;
+import RenderCore.Runtime.RenderGraph;
+import RenderCore.Runtime.Snapshot;
 
 namespace RenderCore
 {
@@ -15,35 +17,48 @@ namespace RenderCore
 
     std::function<void(std::uint8_t)>                                     g_OnCommandPoolResetCallback {};
     std::function<void(VkCommandBuffer const &, ImageAllocation const &)> g_OnCommandBufferRecordCallback {};
+    bool                                                                  g_CacheSceneCommands { false };
 
     export struct RENDERCOREMODULE_API ThreadResources
     {
         VkCommandPool   CommandPool { VK_NULL_HANDLE };
         VkCommandBuffer CommandBuffer { VK_NULL_HANDLE };
 
-        void Allocate(VkDevice const &, std::uint8_t);
+        void Allocate(VkDevice const &, std::uint8_t, VkCommandPoolCreateFlags);
         void Free(VkDevice const &);
         void Destroy(VkDevice const &);
         void Reset(VkDevice const &);
     };
 
     [[nodiscard]] VkCommandPool CreateCommandPool(std::uint8_t, VkCommandPoolCreateFlags);
-    export void                 SetNumObjectsPerThread(std::uint32_t);
     export void                 ResetCommandPool(std::uint32_t);
     export void                 FreeCommandBuffers();
     export void                 InitializeCommandsResources(std::uint32_t);
     export void                 ReleaseCommandsResources();
-    export void                 RecordCommandBuffers(std::uint32_t);
-    export void                 SubmitCommandBuffers(std::uint32_t);
+    export void                 RecordCommandBuffers(std::uint32_t, std::uint32_t, SceneSnapshot const &);
+    export void                 SubmitCommandBuffers(std::uint32_t, std::uint32_t);
+    export void                 ReleaseRenderGraphs();
+    export void                 InvalidateCachedSceneCommands();
 
-    export RENDERCOREMODULE_API void InitializeSingleCommandQueue(VkCommandPool &, std::vector<VkCommandBuffer> &, std::uint8_t);
-    export RENDERCOREMODULE_API void FinishSingleCommandQueue(VkQueue const &, VkCommandPool const &, std::vector<VkCommandBuffer> const &);
+    export RENDERCOREMODULE_API [[nodiscard]] RenderGraphStats const &GetRenderGraphStats(std::uint32_t);
 
     export RENDERCOREMODULE_API [[nodiscard]] inline ThreadPool::Pool &GetThreadPool()
     {
         return g_ThreadPool;
     }
 
+    // Keeps the scene secondaries of each frame slot between frames and re-records a chunk only when its visible draws, geometry or
+    // descriptor bindings change; transform changes only reach the GPU through the uniform buffers.
+    export RENDERCOREMODULE_API inline void SetCacheSceneCommands(bool const Value)
+    {
+        g_CacheSceneCommands = Value;
+    }
+
+    export RENDERCOREMODULE_API [[nodiscard]] inline bool GetCacheSceneCommands()
+    {
+        return g_CacheSceneCommands;
+    }
+
     export RENDERCOREMODULE_API inline void SetOnCommandPoolResetCallbackCallback(std::function<void(std::uint8_t)> &&Callback)
     {
         g_OnCommandPoolResetCallback = std::move(Callback);
@@ -14,6 +14,8 @@ namespace RenderCore
     RENDERCOREMODULE_API VkPhysicalDeviceProperties g_PhysicalDeviceProperties{};
     RENDERCOREMODULE_API VkDevice                   g_Device{VK_NULL_HANDLE};
     RENDERCOREMODULE_API std::pair<std::uint8_t, VkQueue> g_GraphicsQueue{};
+    RENDERCOREMODULE_API std::pair<std::uint8_t, VkQueue> g_ComputeQueue{};
+    RENDERCOREMODULE_API std::pair<std::uint8_t, VkQueue> g_TransferQueue{};
     RENDERCOREMODULE_API std::vector<std::uint8_t> g_UniqueQueueFamilyIndices{};
     RENDERCOREMODULE_API std::function<SurfaceProperties()> g_OnGetSurfaceProperties{};
 
@@ -57,6 +59,28 @@ namespace RenderCore
         return g_GraphicsQueue;
     }
 
+    // Falls back to the graphics queue when the device exposes no separate compute family
+    export RENDERCOREMODULE_API [[nodiscard]] inline std::pair<std::uint8_t, VkQueue> &GetComputeQueue()
+    {
+        return g_ComputeQueue;
+    }
+
+    export RENDERCOREMODULE_API [[nodiscard]] inline bool HasAsyncComputeQueue()
+    {
+        return g_ComputeQueue.first != g_GraphicsQueue.first;
+    }
+
+    // Falls back to the graphics queue when the device exposes no transfer-only family
+    export RENDERCOREMODULE_API [[nodiscard]] inline std::pair<std::uint8_t, VkQueue> &GetTransferQueue()
+    {
+        return g_TransferQueue;
+    }
+
+    export RENDERCOREMODULE_API [[nodiscard]] inline bool HasDedicatedTransferQueue()
+    {
+        return g_TransferQueue.first != g_GraphicsQueue.first;
+    }
+
     export RENDERCOREMODULE_API [[nodiscard]] inline VkPhysicalDeviceProperties const &GetPhysicalDeviceProperties()
     {
         return g_PhysicalDeviceProperties;
@@ -0,0 +1,50 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.DrawPacket;
+
+import RenderCore.Runtime.Snapshot;
+import RenderCore.Types.Camera;
+import RenderCore.Types.CommandState;
+
+namespace RenderCore
+{
+    // Sort key layout, most significant first: 8 bits of pipeline state (alpha mode, culling) and 24 bits of quantized view depth.
+    export constexpr std::uint32_t g_DrawPacketDepthBits = 24U;
+
+    export constexpr std::uint32_t g_DrawPacketDepthMask = (1U << g_DrawPacketDepthBits) - 1U;
+
+    // Everything the scene secondaries need to record a draw, flattened out of Object and Mesh once per frame.
+    export struct RENDERCOREMODULE_API DrawPacket
+    {
+        std::uint32_t SortKey { 0U };
+        std::uint32_t ObjectIndex { 0U };
+        std::uint32_t BufferIndex { 0U };
+        std::uint32_t FirstIndex { 0U };
+        std::int32_t  VertexOffset { 0 };
+        std::uint32_t NumIndices { 0U };
+        std::uint32_t NumInstances { 0U };
+        std::uint32_t Padding { 0U };
+    };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    // Culls the objects in [Begin, End) and appends a packet for each visible one, keyed by state and front-to-back view depth
+    // (back-to-front for blended materials).
+    RENDERCOREMODULE_API void BuildDrawPackets(std::vector<ObjectSnapshot> const &,
+                                               Camera const &,
+                                               std::uint32_t Begin,
+                                               std::uint32_t End,
+                                               std::vector<DrawPacket> &);
+
+    // Stable LSD radix sort on the packet keys, one byte per pass; passes where every key shares the byte are skipped. The scratch
+    // vector is resized to match and keeps its capacity between frames.
+    RENDERCOREMODULE_API void SortDrawPackets(std::vector<DrawPacket> &, std::vector<DrawPacket> &Scratch);
+
+    // Records a contiguous range of sorted packets with the main pipeline layout. The pipeline must already be bound.
+    void RecordDrawPackets(CommandStateTracker &, VkPipelineLayout const &, std::uint32_t, std::span<DrawPacket const>);
+} // namespace RenderCore
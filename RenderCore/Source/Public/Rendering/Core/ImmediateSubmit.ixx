@@ -0,0 +1,53 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.ImmediateSubmit;
+
+namespace RenderCore
+{
+    // One transient pool with its command buffer and the fence of its last submission. Entries are cached per thread and queue family and
+    // only handed out again once their fence signaled, so the pool can be reset instead of destroyed.
+    export struct RENDERCOREMODULE_API TransientCommands
+    {
+        VkCommandPool   CommandPool { VK_NULL_HANDLE };
+        VkCommandBuffer CommandBuffer { VK_NULL_HANDLE };
+        VkFence         Fence { VK_NULL_HANDLE };
+        std::uint8_t    QueueFamilyIndex { 0U };
+        std::thread::id OwnerThread {};
+        bool            InUse { false };
+    };
+
+    // Returns a begun command buffer, either submit it or hand it back unsubmitted with RecycleTransientCommands.
+    export RENDERCOREMODULE_API [[nodiscard]] TransientCommands &AcquireTransientCommands(std::uint8_t);
+    export RENDERCOREMODULE_API void                             RecycleTransientCommands(TransientCommands &);
+
+    // Ends, submits and hands the entry back; waits on the fence when asked to, otherwise the next acquire checks it.
+    export RENDERCOREMODULE_API void SubmitTransientCommands(TransientCommands &, VkQueue const &, std::span<VkSemaphoreSubmitInfo const>, bool);
+
+    export void ReleaseTransientCommandPools();
+
+    // Records into a cached command buffer until Submit, which blocks until the GPU is done unless called with false. A scope left without
+    // submitting discards the recorded commands.
+    export class RENDERCOREMODULE_API ImmediateSubmit
+    {
+        TransientCommands *m_Commands { nullptr };
+        VkQueue            m_Queue { VK_NULL_HANDLE };
+
+    public:
+        ImmediateSubmit(std::uint8_t, VkQueue const &);
+        ~ImmediateSubmit();
+
+        ImmediateSubmit(ImmediateSubmit const &)            = delete;
+        ImmediateSubmit &operator=(ImmediateSubmit const &) = delete;
+
+        void Submit(bool Wait = true);
+
+        [[nodiscard]] inline VkCommandBuffer const &GetCommandBuffer() const
+        {
+            return m_Commands->CommandBuffer;
+        }
+    };
+} // namespace RenderCore
@@ -0,0 +1,121 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.IndirectDraw;
+
+import RenderCore.Runtime.Snapshot;
+import RenderCore.Types.Allocation;
+import RenderCore.Utils.Constants;
+
+namespace RenderCore
+{
+    // Matches DrawData in INDIRECT_SHADER.vert (std430), indexed by gl_DrawIDARB
+    struct IndirectDrawData
+    {
+        VkDeviceAddress ModelAddress { 0U };
+        std::uint32_t   TextureIndex { 0U };
+        std::uint32_t   Padding { 0U };
+    };
+
+    // Matches Candidate in CULLING_SHADER.comp (std430): the mesh bounds plus the draw it turns into when visible
+    struct IndirectCullingCandidate
+    {
+        glm::vec4                    BoundsMin {};
+        glm::vec4                    BoundsMax {};
+        VkDrawIndexedIndirectCommand Command {};
+        std::uint32_t                TextureIndex { 0U };
+        VkDeviceAddress              ModelAddress { 0U };
+    };
+
+    // Matches PushConstants in CULLING_SHADER.comp
+    export struct IndirectCullingConstants
+    {
+        VkDeviceAddress       SceneAddress { 0U };
+        VkDeviceAddress       CandidatesAddress { 0U };
+        VkDeviceAddress       CommandsAddress { 0U };
+        VkDeviceAddress       DrawDataAddress { 0U };
+        VkDeviceAddress       CountAddress { 0U };
+        alignas(16) glm::vec4 CameraPositionAndDistance {};
+        std::uint32_t         NumCandidates { 0U };
+    };
+
+    struct IndirectDrawResources
+    {
+        BufferAllocation         Commands {};
+        BufferAllocation         DrawData {};
+        BufferAllocation         Count {};
+        BufferAllocation         Candidates {};
+        IndirectCullingConstants CullingConstants {};
+        std::uint32_t            Capacity { 0U };
+        std::uint32_t            NumDraws { 0U };
+        bool                     IsCulledOnGPU { false };
+
+        void DestroyResources(VmaAllocator const &);
+    };
+
+    std::array<IndirectDrawResources, g_MaxFramesInFlight> g_IndirectDrawResources {};
+    bool                                                   g_UseIndirectDraws { false };
+    bool                                                   g_UseGPUCulling { false };
+    bool                                                   g_UseAsyncCulling { false };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    // True when the toggle is on and every allocated uniform slot fits in the bindless texture array.
+    [[nodiscard]] bool CanUseIndirectDraws();
+
+    [[nodiscard]] bool CanUseGPUCulling();
+
+    // True when culling is done on the GPU and the device exposes a compute family apart from the graphics one.
+    [[nodiscard]] bool CanUseAsyncCulling();
+
+    // Writes the frame slot command, per-draw data and count buffers. With GPU culling only the candidates are written and the
+    // returned value is an upper bound of the draws; the compute pass fills the rest.
+    [[nodiscard]] std::uint32_t BuildIndirectDraws(std::uint32_t, SceneSnapshot const &);
+
+    // Resets the count and dispatches the culling shader over the candidates of the frame slot. When the bool is set the written
+    // buffers are released to the graphics family, which must then call AcquireIndirectDraws. Returns false if nothing was recorded.
+    [[nodiscard]] bool RecordIndirectCulling(VkCommandBuffer const &, std::uint32_t, bool);
+    void               AcquireIndirectDraws(VkCommandBuffer const &, std::uint32_t);
+
+    // Draws everything written by BuildIndirectDraws with one vkCmdDrawIndexedIndirectCount over the unified geometry buffer.
+    void RecordIndirectDraws(VkCommandBuffer const &, std::uint32_t);
+
+    void ReleaseIndirectDrawResources();
+
+    // Replaces the per-object secondaries of the scene pass with a single indirect multi-draw recorded inline.
+    RENDERCOREMODULE_API inline void SetUseIndirectDraws(bool const Value)
+    {
+        g_UseIndirectDraws = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool GetUseIndirectDraws()
+    {
+        return g_UseIndirectDraws;
+    }
+
+    // Moves the frustum and distance tests of the indirect path to a compute pass that compacts the visible draws on the GPU.
+    RENDERCOREMODULE_API inline void SetUseGPUCulling(bool const Value)
+    {
+        g_UseGPUCulling = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool GetUseGPUCulling()
+    {
+        return g_UseGPUCulling;
+    }
+
+    // Submits the culling pass to the dedicated compute queue so it overlaps with graphics work still in flight.
+    RENDERCOREMODULE_API inline void SetUseAsyncCulling(bool const Value)
+    {
+        g_UseAsyncCulling = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool GetUseAsyncCulling()
+    {
+        return g_UseAsyncCulling;
+    }
+} // namespace RenderCore
@@ -14,14 +14,38 @@ import RenderCore.Utils.Constants;
 import RenderCore.Utils.EnumHelpers;
 import RenderCore.Utils.Helpers;
 
+export namespace RenderCore
+{
+    // Where the geometry heap lives: MAPPED writes meshes straight into host-visible memory, STAGED copies them into device-only memory
+    // through the upload path.
+    enum class GeometryPlacement : std::uint8_t
+    {
+        MAPPED,
+        STAGED
+    };
+} // namespace RenderCore
+
 namespace RenderCore
 {
     VmaPool                                            g_StagingBufferPool{VK_NULL_HANDLE};
     VmaPool                                            g_DescriptorBufferPool{VK_NULL_HANDLE};
     VmaPool                                            g_BufferPool{VK_NULL_HANDLE};
+    VmaPool                                            g_DeviceBufferPool{VK_NULL_HANDLE};
     VmaPool                                            g_ImagePool{VK_NULL_HANDLE};
     VmaAllocator                                       g_Allocator{VK_NULL_HANDLE};
     BufferAllocation                                   g_BufferAllocation{};
+    VmaVirtualBlock                                    g_GeometryBlock{VK_NULL_HANDLE};
+    std::uint32_t                                      g_GeometryHeapGeneration{0U};
+    GeometryPlacement                                  g_GeometryPlacement{GeometryPlacement::STAGED};
+    bool                                               g_GenerateTextureMipmaps{true};
+    std::vector<std::shared_ptr<Object>>               g_GeometryObjects{};
+    BufferAllocation                                   g_UniformAllocation{};
+    VkDeviceSize                                       g_ModelUniformStride{0U};
+    std::uint32_t                                      g_UniformSlotCapacity{0U};
+    std::uint32_t                                      g_NextUniformSlot{0U};
+    std::vector<std::uint32_t>                         g_FreeUniformSlots{};
+    std::uint32_t                                      g_ModelsBufferGeneration{0U};
+    std::uint32_t                                      g_UniformSlotEpoch{0U};
     std::atomic<std::uint64_t>                         g_ImageAllocationIDCounter{0U};
     std::unordered_map<std::uint32_t, ImageAllocation> g_AllocatedImages{};
     std::unordered_map<std::uint32_t, std::uint32_t>   g_ImageAllocationCounter{};
@@ -36,17 +60,57 @@ export namespace RenderCore
     void              CopyBuffer(VkCommandBuffer const &, VkBuffer const &, VkBuffer const &, VkDeviceSize const &);
     void              CreateUniformBuffers(BufferAllocation &, VkDeviceSize, strzilla::string_view);
 
-    void CreateImage(
-            VkFormat const &, VkExtent2D const &, VkImageTiling const &, VkImageUsageFlags, VmaMemoryUsage, strzilla::string_view, VkImage &, VmaAllocation &);
-    void CreateImageView(VkImage const &, VkFormat const &, VkImageAspectFlags const &, VkImageView &);
+    void CreateImage(VkFormat const &,
+                     VkExtent2D const &,
+                     VkImageTiling const &,
+                     VkImageUsageFlags,
+                     VmaMemoryUsage,
+                     strzilla::string_view,
+                     VkImage &,
+                     VmaAllocation &,
+                     std::uint32_t MipLevels = 1U);
+    void CreateImageView(VkImage const &, VkFormat const &, VkImageAspectFlags const &, VkImageView &, std::uint32_t BaseMipLevel = 0U, std::uint32_t LevelCount = 1U);
     void CreateTextureImageView(ImageAllocation &, VkFormat);
     void CopyBufferToImage(VkCommandBuffer const &, VkBuffer const &, VkImage const &, VkExtent2D const &);
 
-    [[nodiscard]] std::tuple<std::uint32_t, VkBuffer, VmaAllocation>
-    AllocateTexture(VkCommandBuffer const &, unsigned char const *, std::uint32_t, std::uint32_t, VkFormat, VkDeviceSize);
+    [[nodiscard]] std::uint32_t AllocateTexture(VkCommandBuffer const &, unsigned char const *, std::uint32_t, std::uint32_t, VkFormat, VkDeviceSize);
+
+    // Creates the image with room for every mip level but neither uploads nor views any of them; upload the levels with
+    // QueueImageLevelUpload and expose them with SetImageAllocationBaseLevel.
+    [[nodiscard]] std::uint32_t AllocateStreamedTexture(std::uint32_t, std::uint32_t, VkFormat, std::uint32_t);
+    void                        QueueImageLevelUpload(VkCommandBuffer const &, std::uint32_t, std::uint32_t, void const *, VkDeviceSize);
 
+    // Blits the levels after SourceLevel from it once the upload completed; does nothing when there are none.
+    void QueueImageMipGeneration(VkCommandBuffer const &, std::uint32_t, std::uint32_t);
+
+    // Replaces the view by one over [Level, MipLevels), the old view is retired with the frames that may still sample it.
+    void SetImageAllocationBaseLevel(std::uint32_t, std::uint32_t);
+
+    // An evicted entry keeps its extent, format and level count but no image; descriptors built from it point to the empty texture until
+    // it is recreated and a base level is set again.
+    [[nodiscard]] VkDeviceSize GetImageAllocationSize(std::uint32_t);
+    void                       EvictImageAllocation(std::uint32_t);
+    void                       RecreateImageAllocation(std::uint32_t);
+
+    // Sub-allocates each mesh its own range of the geometry heap. Mapped heaps are written right away, staged ones get their copies queued
+    // into the upload command buffer. The heap only grows, re-packing the live meshes, when a new range doesn't fit.
+    void AllocateModelsGeometry(std::vector<std::shared_ptr<Object>> const &, VkCommandBuffer const &);
+
+    // Blocks until pending uploads completed, then moves the live meshes into a new heap with the current placement and room for AdditionalSize.
+    void RebuildGeometryHeap(VkDeviceSize);
+
+    // Assigns each object its uniform slot, growing the uniform buffer when needed.
     void AllocateModelsBuffers(std::vector<std::shared_ptr<Object>> const &);
 
+    [[nodiscard]] VkDeviceSize GetObjectGeometrySize(std::shared_ptr<Object> const &);
+
+    // Appends the object geometry (vertices, then indices) at Offset and returns the offset past it. Touches no Vulkan state.
+    // Blocks start and end on a multiple of sizeof(Vertex), so indirect draws can address them with vertexOffset/firstIndex.
+    [[nodiscard]] VkDeviceSize WriteObjectGeometry(std::shared_ptr<Object> const &, void *, VkDeviceSize);
+    void ReleaseModelsBuffers(std::shared_ptr<Object> &&);
+    void ResetModelsBuffers();
+    void RetireBufferAllocation(BufferAllocation &);
+
     template <VkImageLayout OldLayout, VkImageLayout NewLayout, VkImageAspectFlags Aspect>
     RENDERCOREMODULE_API constexpr VkImageMemoryBarrier2 MountImageBarrier(VkImage const      &Image,
                                                       VkFormat const     &Format,
@@ -159,6 +223,16 @@ export namespace RenderCore
 
     RENDERCOREMODULE_API [[nodiscard]] strzilla::string GetMemoryAllocatorStats(bool);
 
+    struct RENDERCOREMODULE_API DeviceMemoryUsage
+    {
+        VkDeviceSize AllocatedBytes { 0U };
+        VkDeviceSize UsageBytes { 0U };
+        VkDeviceSize BudgetBytes { 0U };
+    };
+
+    // Sums the device-local heaps. Usage and budget come from VK_EXT_memory_budget when available, otherwise they are VMA estimates.
+    RENDERCOREMODULE_API [[nodiscard]] DeviceMemoryUsage GetDeviceMemoryUsage();
+
     RENDERCOREMODULE_API [[nodiscard]] inline VmaAllocator const &GetAllocator()
     {
         return g_Allocator;
@@ -169,18 +243,90 @@ export namespace RenderCore
         return g_BufferAllocation.Buffer;
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline void *GetAllocationMappedData()
+    RENDERCOREMODULE_API [[nodiscard]] inline bool HasGeometryHeap()
+    {
+        return g_BufferAllocation.IsValid();
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline GeometryPlacement GetGeometryPlacement()
+    {
+        return g_GeometryPlacement;
+    }
+
+    RENDERCOREMODULE_API inline void SetGeometryPlacement(GeometryPlacement const Value)
+    {
+        g_GeometryPlacement = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool GetGenerateTextureMipmaps()
+    {
+        return g_GenerateTextureMipmaps;
+    }
+
+    // Textures allocated afterwards get a full mip chain blitted on the GPU from the uploaded level, when their format supports it.
+    RENDERCOREMODULE_API inline void SetGenerateTextureMipmaps(bool const Value)
+    {
+        g_GenerateTextureMipmaps = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkMemoryPropertyFlags GetGeometryMemoryProperties()
+    {
+        VkMemoryPropertyFlags Output { 0U };
+        if (g_BufferAllocation.IsValid())
+        {
+            vmaGetAllocationMemoryProperties(g_Allocator, g_BufferAllocation.Allocation, &Output);
+        }
+        return Output;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkMemoryPropertyFlags GetUniformMemoryProperties()
+    {
+        VkMemoryPropertyFlags Output { 0U };
+        if (g_UniformAllocation.IsValid())
+        {
+            vmaGetAllocationMemoryProperties(g_Allocator, g_UniformAllocation.Allocation, &Output);
+        }
+        return Output;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkBuffer const &GetUniformAllocationBuffer()
+    {
+        return g_UniformAllocation.Buffer;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline void *GetUniformAllocationMappedData()
+    {
+        return g_UniformAllocation.MappedData;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline std::uint32_t GetUniformSlotCapacity()
+    {
+        return g_UniformSlotCapacity;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline std::uint32_t GetModelsBufferGeneration()
+    {
+        return g_ModelsBufferGeneration;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkDeviceSize GetModelUniformStride()
     {
-        return g_BufferAllocation.MappedData;
+        return g_ModelUniformStride;
     }
 
     RENDERCOREMODULE_API [[nodiscard]] inline VkDescriptorBufferInfo GetAllocationBufferDescriptor(std::uint32_t const Offset, std::uint32_t const Range)
     {
-        return VkDescriptorBufferInfo{.buffer = GetAllocationBuffer(), .offset = Offset, .range = Range};
+        return VkDescriptorBufferInfo{.buffer = GetUniformAllocationBuffer(), .offset = Offset, .range = Range};
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline VkDescriptorImageInfo GetAllocationImageDescriptor(std::uint32_t const Index)
+    // Without a sampler the descriptor uses the scene's default one
+    RENDERCOREMODULE_API [[nodiscard]] inline VkDescriptorImageInfo GetAllocationImageDescriptor(std::uint32_t const Index,
+                                                                                               VkSampler const     Sampler = VK_NULL_HANDLE)
     {
-        return VkDescriptorImageInfo{.sampler = GetSampler(), .imageView = g_AllocatedImages.at(Index).View, .imageLayout = g_ReadLayout};
+        ImageAllocation const &Entry      = g_AllocatedImages.at(Index);
+        ImageAllocation const &Allocation = Entry.IsValid() && Entry.View != VK_NULL_HANDLE ? Entry : g_AllocatedImages.at(0U);
+        return VkDescriptorImageInfo{.sampler     = Sampler != VK_NULL_HANDLE ? Sampler : GetSampler(),
+                                     .imageView   = Allocation.View,
+                                     .imageLayout = g_ReadLayout};
     }
 } // namespace RenderCore
@@ -12,15 +12,15 @@ import RenderCore.Types.SurfaceProperties;
 
 namespace RenderCore
 {
-    RENDERCOREMODULE_API std::array<ImageAllocation, g_ImageCount> g_OffscreenImages {};
+    RENDERCOREMODULE_API std::vector<ImageAllocation> g_OffscreenImages {};
 }
 
 export namespace RenderCore
 {
-    void CreateOffscreenResources(SurfaceProperties const &);
+    void CreateOffscreenResources(SurfaceProperties const &, std::uint32_t);
     void DestroyOffscreenImages();
 
-    RENDERCOREMODULE_API [[nodiscard]] inline std::array<ImageAllocation, g_ImageCount> const &GetOffscreenImages()
+    RENDERCOREMODULE_API [[nodiscard]] inline std::vector<ImageAllocation> const &GetOffscreenImages()
     {
         return g_OffscreenImages;
     }
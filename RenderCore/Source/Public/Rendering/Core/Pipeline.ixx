@@ -7,7 +7,9 @@ module;
 export module RenderCore.Runtime.Pipeline;
 
 import RenderCore.Types.Allocation;
+import RenderCore.Types.CommandState;
 import RenderCore.Types.Object;
+import RenderCore.Types.Texture;
 
 namespace RenderCore
 {
@@ -40,6 +42,10 @@ namespace RenderCore
         DescriptorData SceneData {};
         DescriptorData ModelData {};
         DescriptorData TextureData {};
+        DescriptorData IndirectTextureData {};
+        std::uint32_t  ModelsCapacity { 0U };
+        std::uint32_t  ModelsGeneration { 0U };
+        std::uint32_t  IndirectTextureCapacity { 0U };
 
         [[nodiscard]] inline bool IsValid() const
         {
@@ -51,9 +57,19 @@ namespace RenderCore
         void SetDescriptorLayoutSize();
         void SetupSceneBuffer(BufferAllocation const &);
         void SetupModelsBuffer(std::vector<std::shared_ptr<Object>> const &);
+        void UpdateModelsBuffer(std::vector<std::shared_ptr<Object>> const &);
+        void SetupObjectDescriptors(std::shared_ptr<Object> const &) const;
+        void SetupTextureDescriptors(std::shared_ptr<Object> const &, std::uint32_t) const;
+
+        // Shared by the packet and per-object draw paths: bind the scene, model and texture descriptor buffers once, then offset them to
+        // the current frame of a given object slot
+        void BindSceneDescriptorBuffers(CommandStateTracker &) const;
+        void SetObjectDescriptorOffsets(CommandStateTracker &, VkPipelineLayout const &, std::uint32_t FrameIndex, std::uint32_t Slot) const;
     };
 
     export extern RENDERCOREMODULE_API PipelineData           g_PipelineData { VK_NULL_HANDLE };
+    export extern RENDERCOREMODULE_API PipelineData           g_IndirectPipelineData { VK_NULL_HANDLE };
+    export extern RENDERCOREMODULE_API PipelineData           g_CullingPipelineData { VK_NULL_HANDLE };
     export extern RENDERCOREMODULE_API PipelineDescriptorData g_DescriptorData {};
 }
 
@@ -96,6 +112,32 @@ export namespace RenderCore
         return g_PipelineData.PipelineLayout;
     }
 
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipeline const &GetIndirectPipeline()
+    {
+        return g_IndirectPipelineData.MainPipeline;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipelineLayout const &GetIndirectPipelineLayout()
+    {
+        return g_IndirectPipelineData.PipelineLayout;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipeline const &GetCullingPipeline()
+    {
+        return g_CullingPipelineData.MainPipeline;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkPipelineLayout const &GetCullingPipelineLayout()
+    {
+        return g_CullingPipelineData.PipelineLayout;
+    }
+
+    // The indirect path reads five consecutive texture descriptors per uniform slot from a single bindless array
+    RENDERCOREMODULE_API [[nodiscard]] inline bool CanDrawSlotIndirect(std::uint32_t const Slot)
+    {
+        return (Slot + 1U) * static_cast<std::uint32_t>(TextureType::Count) <= g_DescriptorData.IndirectTextureCapacity;
+    }
+
     RENDERCOREMODULE_API [[nodiscard]] inline PipelineDescriptorData &GetPipelineDescriptorData()
     {
         return g_DescriptorData;
@@ -0,0 +1,102 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Query;
+
+import RenderCore.Utils.Constants;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API GPUPipelineStatistics
+    {
+        std::uint64_t InputAssemblyVertices { 0U };
+        std::uint64_t InputAssemblyPrimitives { 0U };
+        std::uint64_t VertexShaderInvocations { 0U };
+        std::uint64_t ClippingInvocations { 0U };
+        std::uint64_t ClippingPrimitives { 0U };
+        std::uint64_t FragmentShaderInvocations { 0U };
+    };
+
+    export struct RENDERCOREMODULE_API GPUPassTiming
+    {
+        strzilla::string Name {};
+        double           Time { 0.0 };
+    };
+
+    export struct RENDERCOREMODULE_API GPUThreadTiming
+    {
+        std::uint32_t         ThreadIndex { 0U };
+        double                Time { 0.0 };
+        GPUPipelineStatistics Statistics {};
+    };
+
+    export struct RENDERCOREMODULE_API GPUFrameTimings
+    {
+        std::uint64_t                FrameNumber { 0U };
+        double                       FrameTime { 0.0 };
+        std::vector<GPUPassTiming>   Passes {};
+        std::vector<GPUThreadTiming> RecordingThreads {};
+        bool                         HasPipelineStatistics { false };
+    };
+
+    struct FrameQueries
+    {
+        VkQueryPool                                  TimestampPool { VK_NULL_HANDLE };
+        VkQueryPool                                  StatisticsPool { VK_NULL_HANDLE };
+        std::uint64_t                                FrameNumber { 0U };
+        std::vector<strzilla::string>                PassNames {};
+        std::array<bool, g_MaxTimedRecordingThreads> ThreadsWritten {};
+        bool                                         HasStatistics { false };
+        bool                                         HasPendingResults { false };
+    };
+
+    RENDERCOREMODULE_API std::array<FrameQueries, g_MaxFramesInFlight> g_FrameQueries {};
+    RENDERCOREMODULE_API bool                                          g_TimestampsSupported { false };
+    RENDERCOREMODULE_API bool                                          g_CollectPipelineStatistics { false };
+    RENDERCOREMODULE_API double                                        g_TimestampPeriod { 1.0 };
+    RENDERCOREMODULE_API std::uint64_t                                 g_TimestampMask { 0U };
+    RENDERCOREMODULE_API std::uint64_t                                 g_QueryFrameCounter { 0U };
+    RENDERCOREMODULE_API std::mutex                                    g_GPUFrameTimingsMutex {};
+    RENDERCOREMODULE_API GPUFrameTimings                               g_LatestGPUFrameTimings {};
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    void CreateQueryResources();
+    void ReleaseQueryResources();
+
+    // Results of a frame slot are read back when the slot is reused, after its timeline wait, so reading never stalls the GPU.
+    void BeginFrameQueries(VkCommandBuffer const &, std::uint32_t);
+    void EndFrameQueries(VkCommandBuffer const &, std::uint32_t);
+
+    [[nodiscard]] std::uint32_t BeginPassQuery(VkCommandBuffer const &, std::uint32_t, strzilla::string_view);
+    void                        EndPassQuery(VkCommandBuffer const &, std::uint32_t, std::uint32_t);
+
+    // Thread queries are indexed by scene secondary (recording batch or cached chunk); secondaries past g_MaxTimedRecordingThreads are not timed.
+    void BeginThreadQueries(VkCommandBuffer const &, std::uint32_t, std::uint32_t);
+    void EndThreadQueries(VkCommandBuffer const &, std::uint32_t, std::uint32_t);
+
+    // Secondaries replayed without re-recording still write their thread queries; flag them so their results are read back.
+    void               MarkThreadQueriesWritten(std::uint32_t, std::uint32_t);
+    [[nodiscard]] bool HasFrameStatistics(std::uint32_t);
+
+    RENDERCOREMODULE_API [[nodiscard]] GPUFrameTimings GetLatestGPUFrameTimings();
+
+    RENDERCOREMODULE_API inline void SetCollectPipelineStatistics(bool const Value)
+    {
+        g_CollectPipelineStatistics = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool GetCollectPipelineStatistics()
+    {
+        return g_CollectPipelineStatistics;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool AreTimestampsSupported()
+    {
+        return g_TimestampsSupported;
+    }
+} // namespace RenderCore
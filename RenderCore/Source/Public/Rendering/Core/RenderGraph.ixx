@@ -0,0 +1,145 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.RenderGraph;
+
+import RenderCore.Types.Allocation;
+
+namespace RenderCore
+{
+    export using RenderGraphResource = std::uint32_t;
+
+    export enum class RenderGraphAccess : std::uint8_t
+    {
+        ColorAttachmentWrite,
+        DepthAttachmentWrite,
+        ShaderRead,
+        TransferRead,
+        TransferWrite
+    };
+
+    export struct RENDERCOREMODULE_API RenderGraphImageDescription
+    {
+        VkFormat           Format { VK_FORMAT_UNDEFINED };
+        VkExtent2D         Extent {};
+        VkImageUsageFlags  Usage { 0U };
+        VkImageAspectFlags Aspect { 0U };
+    };
+
+    export struct RENDERCOREMODULE_API RenderGraphStats
+    {
+        std::uint32_t NumPasses { 0U };
+        std::uint32_t NumCulledPasses { 0U };
+        std::uint32_t NumBarriers { 0U };
+        std::uint32_t NumBarrierBatches { 0U };
+        std::uint32_t NumTransientImages { 0U };
+        std::uint32_t NumTransientAllocations { 0U };
+        VkDeviceSize  TransientMemoryRequested { 0U };
+        VkDeviceSize  TransientMemoryAllocated { 0U };
+    };
+
+    // Per-frame declarative pass list: passes declare the images they read and write, the graph culls passes that don't contribute
+    // to an output, emits one batched vkCmdPipelineBarrier2 per pass and places transient images with disjoint lifetimes in the
+    // same VMA allocation. Transient memory is kept across frames and only rebuilt when the transient layout changes.
+    export class RENDERCOREMODULE_API RenderGraph
+    {
+    public:
+        using PassCallback = std::function<void(VkCommandBuffer const &, RenderGraph const &)>;
+
+    private:
+        struct ResourceState
+        {
+            VkImageLayout         Layout { VK_IMAGE_LAYOUT_UNDEFINED };
+            VkPipelineStageFlags2 WriteStages { VK_PIPELINE_STAGE_2_NONE };
+            VkAccessFlags2        WriteAccess { VK_ACCESS_2_NONE };
+            VkPipelineStageFlags2 ReadStages { VK_PIPELINE_STAGE_2_NONE };
+        };
+
+        struct ResourceEntry
+        {
+            strzilla::string            Name {};
+            ImageAllocation             Image {};
+            RenderGraphImageDescription Description {};
+            VkImageLayout               FinalLayout { VK_IMAGE_LAYOUT_UNDEFINED };
+            bool                        IsTransient { false };
+            bool                        IsOutput { false };
+            std::uint32_t               TransientIndex { 0U };
+            ResourceState               State {};
+        };
+
+        struct PassEntry
+        {
+            strzilla::string                                               Name {};
+            std::vector<std::pair<RenderGraphResource, RenderGraphAccess>> Accesses {};
+            PassCallback                                                   Callback {};
+            bool                                                           HasSideEffects { false };
+            bool                                                           IsCulled { false };
+        };
+
+        struct TransientImage
+        {
+            RenderGraphImageDescription Description {};
+            RenderGraphResource         Resource { 0U };
+            std::uint32_t               FirstPass { 0U };
+            std::uint32_t               LastPass { 0U };
+            ImageAllocation             Image {};
+            VkMemoryRequirements        Requirements {};
+            std::uint32_t               MemorySlot { 0U };
+        };
+
+        struct MemorySlot
+        {
+            VmaAllocation        Allocation { VK_NULL_HANDLE };
+            VkMemoryRequirements Requirements {};
+            std::uint32_t        LastPass { 0U };
+            ResourceState        LastState {};
+        };
+
+        std::vector<ResourceEntry>  m_Resources {};
+        std::vector<PassEntry>      m_Passes {};
+        std::vector<TransientImage> m_TransientImages {};
+        std::vector<MemorySlot>     m_MemorySlots {};
+        RenderGraphStats            m_Stats {};
+
+    public:
+        RenderGraph() = default;
+
+        RenderGraph(RenderGraph const &)            = delete;
+        RenderGraph &operator=(RenderGraph const &) = delete;
+
+        RenderGraphResource ImportImage(strzilla::string_view, ImageAllocation const &, VkImageAspectFlags, VkImageLayout FinalLayout);
+        RenderGraphResource CreateTransientImage(strzilla::string_view, RenderGraphImageDescription const &);
+        void                MarkOutput(RenderGraphResource);
+
+        void AddPass(strzilla::string_view,
+                     std::vector<std::pair<RenderGraphResource, RenderGraphAccess>> &&,
+                     PassCallback &&,
+                     bool HasSideEffects = false);
+
+        void Execute(VkCommandBuffer const &);
+        void Reset();
+        void Release();
+
+        [[nodiscard]] ImageAllocation const &GetImage(RenderGraphResource) const;
+
+        [[nodiscard]] inline RenderGraphStats const &GetStats() const
+        {
+            return m_Stats;
+        }
+
+    private:
+        void CullPasses();
+        void RealizeTransientImages();
+        void ReleaseTransientImages();
+
+        static void TransitionResource(ResourceEntry &,
+                                       VkImageLayout,
+                                       VkPipelineStageFlags2,
+                                       VkAccessFlags2,
+                                       bool,
+                                       std::vector<VkImageMemoryBarrier2> &);
+    };
+} // namespace RenderCore
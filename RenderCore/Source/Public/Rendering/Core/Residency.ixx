@@ -0,0 +1,80 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Residency;
+
+import RenderCore.Runtime.Snapshot;
+import RenderCore.Factories.Texture;
+import RenderCore.Types.Texture;
+import RenderCore.Utils.Constants;
+
+namespace RenderCore
+{
+    RENDERCOREMODULE_API VkDeviceSize g_ResidencyBudget { 0U };
+    RENDERCOREMODULE_API bool         g_UseTextureStreaming { false };
+    RENDERCOREMODULE_API VkDeviceSize g_StreamingBandwidth { g_DefaultStreamingBandwidth };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    struct RENDERCOREMODULE_API TextureResidencyStats
+    {
+        VkDeviceSize  ResidentBytes { 0U };
+        std::uint32_t NumResident { 0U };
+        std::uint32_t NumEvicted { 0U };
+        std::uint32_t NumPartiallyStreamed { 0U };
+        std::uint64_t NumEvictions { 0U };
+        std::uint64_t NumRestores { 0U };
+        std::uint64_t NumStreamedLevels { 0U };
+        VkDeviceSize  StreamedBytes { 0U };
+    };
+
+    // Takes the mip chain so the texture can be evicted and uploaded again later, and its finer levels streamed in; call once its first
+    // upload completed. Textures without levels left to stream only register while a budget is set, otherwise they always stay resident.
+    void RegisterTextureResidency(std::shared_ptr<Texture> const &, TextureMipChain &&);
+
+    // Render thread, once per frame before recording: marks the textures of the visible objects as used, uploads the evicted ones among them
+    // again, streams the finer levels their screen size asks for and evicts the least recently used textures while the device-local
+    // allocations exceed the budget.
+    void UpdateTextureResidency(SceneSnapshot const &);
+
+    void ReleaseTextureResidency();
+
+    RENDERCOREMODULE_API [[nodiscard]] TextureResidencyStats GetTextureResidencyStats();
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkDeviceSize GetResidencyBudget()
+    {
+        return g_ResidencyBudget;
+    }
+
+    // Bytes of device-local memory the renderer should stay under, also capped by the heap budget the driver reports. Zero disables eviction.
+    RENDERCOREMODULE_API inline void SetResidencyBudget(VkDeviceSize const Value)
+    {
+        g_ResidencyBudget = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline bool GetUseTextureStreaming()
+    {
+        return g_UseTextureStreaming;
+    }
+
+    // Applies to scenes loaded afterwards: their textures get a full mip chain but only upload its tail, finer levels follow on demand.
+    RENDERCOREMODULE_API inline void SetUseTextureStreaming(bool const Value)
+    {
+        g_UseTextureStreaming = Value;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkDeviceSize GetStreamingBandwidth()
+    {
+        return g_StreamingBandwidth;
+    }
+
+    // Bytes of mip levels streamed per frame. A single level larger than this still goes out alone.
+    RENDERCOREMODULE_API inline void SetStreamingBandwidth(VkDeviceSize const Value)
+    {
+        g_StreamingBandwidth = Value;
+    }
+} // namespace RenderCore
@@ -11,7 +11,7 @@ import RenderCore.Types.Camera;
 import RenderCore.Types.Illumination;
 import RenderCore.Types.Allocation;
 import RenderCore.Types.Object;
-import RenderCore.Types.SurfaceProperties;
+import RenderCore.Runtime.Snapshot;
 
 namespace RenderCore
 {
@@ -19,33 +19,60 @@ namespace RenderCore
     RENDERCOREMODULE_API Illumination                                        g_Illumination {};
     RENDERCOREMODULE_API std::pair<BufferAllocation, VkDescriptorBufferInfo> m_UniformBufferAllocation {};
     RENDERCOREMODULE_API VkSampler                            g_Sampler { VK_NULL_HANDLE };
-    RENDERCOREMODULE_API ImageAllocation                      g_DepthImage {};
+    RENDERCOREMODULE_API VkFormat                             g_DepthFormat { VK_FORMAT_UNDEFINED };
+    RENDERCOREMODULE_API VkDeviceSize                         g_SceneUniformStride { 0U };
     RENDERCOREMODULE_API std::atomic<std::uint64_t>           g_ObjectAllocationIDCounter { 0U };
     RENDERCOREMODULE_API std::vector<std::shared_ptr<Object>> g_Objects {};
+    RENDERCOREMODULE_API std::mutex                           g_SceneMutex {};
 }
 
 export namespace RenderCore
 {
+    // Samplers are shared between every texture with the same description
+    struct RENDERCOREMODULE_API SamplerDescription
+    {
+        VkFilter             MagFilter { VK_FILTER_LINEAR };
+        VkFilter             MinFilter { VK_FILTER_LINEAR };
+        VkSamplerMipmapMode  MipmapMode { VK_SAMPLER_MIPMAP_MODE_LINEAR };
+        VkSamplerAddressMode AddressModeU { VK_SAMPLER_ADDRESS_MODE_REPEAT };
+        VkSamplerAddressMode AddressModeV { VK_SAMPLER_ADDRESS_MODE_REPEAT };
+        float                MaxLod { VK_LOD_CLAMP_NONE };
+
+        bool operator==(SamplerDescription const &) const = default;
+    };
+
     void CreateSceneUniformBuffer();
     void CreateImageSampler();
-    void CreateDepthResources(SurfaceProperties const &);
+
+    // Returns the cached sampler matching the description, creating it on first use. Trilinear samplers also filter anisotropically.
+    [[nodiscard]] VkSampler AcquireSampler(SamplerDescription const &);
+
     void AllocateEmptyTexture(VkFormat);
-    void LoadScene(strzilla::string_view);
+    // Parses the model and submits its texture uploads without waiting; the objects are added to the scene and passed to the callback
+    // on the render thread once the uploads completed.
+    void LoadScene(strzilla::string_view, std::function<void(std::vector<std::shared_ptr<Object>> const &)> &&);
     void UnloadObjects(std::vector<std::uint32_t> const &);
     void ReleaseSceneResources();
     void DestroyObjects();
     void TickObjects(float);
-    void UpdateSceneUniformBuffer();
-    void UpdateObjectsUniformBuffer();
+    void CaptureSceneSnapshot(SceneSnapshot &);
+    void UpdateSceneUniformBuffer(std::uint32_t, SceneSnapshot const &);
+    void UpdateObjectsUniformBuffer(std::uint32_t, SceneSnapshot const &);
+    void UpdateObjectsTextureDescriptors(std::uint32_t, SceneSnapshot const &);
 
     RENDERCOREMODULE_API [[nodiscard]] inline std::uint32_t FetchID()
     {
         return g_ObjectAllocationIDCounter.fetch_add(1U);
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline ImageAllocation const &GetDepthImage()
+    RENDERCOREMODULE_API inline void SetDepthFormat(VkFormat const Format)
+    {
+        g_DepthFormat = Format;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkFormat GetDepthFormat()
     {
-        return g_DepthImage;
+        return g_DepthFormat;
     }
 
     RENDERCOREMODULE_API [[nodiscard]] inline VkSampler const &GetSampler()
@@ -53,11 +80,20 @@ export namespace RenderCore
         return g_Sampler;
     }
 
+    RENDERCOREMODULE_API [[nodiscard]] std::uint32_t GetNumSamplers();
+
     RENDERCOREMODULE_API [[nodiscard]] inline std::vector<std::shared_ptr<Object>> &GetObjects()
     {
         return g_Objects;
     }
 
+    // Serializes the simulation side (tick and snapshot capture) with the render side changes to the scene (dispatched tasks, object
+    // management); taken before the objects mutex when both are needed.
+    RENDERCOREMODULE_API [[nodiscard]] inline std::mutex &GetSceneMutex()
+    {
+        return g_SceneMutex;
+    }
+
     RENDERCOREMODULE_API [[nodiscard]] inline std::uint32_t GetNumAllocations()
     {
         return static_cast<std::uint32_t>(std::size(g_Objects));
@@ -68,9 +104,14 @@ export namespace RenderCore
         return m_UniformBufferAllocation.first;
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline void *GetSceneUniformData()
+    RENDERCOREMODULE_API [[nodiscard]] inline void *GetSceneUniformData(std::uint32_t const FrameIndex)
+    {
+        return static_cast<char *>(m_UniformBufferAllocation.first.MappedData) + FrameIndex * g_SceneUniformStride;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkDeviceSize GetSceneUniformStride()
     {
-        return m_UniformBufferAllocation.first.MappedData;
+        return g_SceneUniformStride;
     }
 
     RENDERCOREMODULE_API [[nodiscard]] inline VkDescriptorBufferInfo const &GetSceneUniformDescriptor()
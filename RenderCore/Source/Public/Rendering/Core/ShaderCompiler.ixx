@@ -17,6 +17,8 @@ namespace RenderCore
     };
 
     RENDERCOREMODULE_API std::vector<ShaderStageData> g_StageInfos;
+    RENDERCOREMODULE_API std::vector<ShaderStageData> g_IndirectStageInfos;
+    RENDERCOREMODULE_API std::vector<ShaderStageData> g_CullingStageInfos;
 }
 
 export namespace RenderCore
@@ -42,9 +44,21 @@ export namespace RenderCore
         return g_StageInfos;
     }
 
+    RENDERCOREMODULE_API [[nodiscard]] inline std::vector<ShaderStageData> const &GetIndirectStageData()
+    {
+        return g_IndirectStageInfos;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline std::vector<ShaderStageData> const &GetCullingStageData()
+    {
+        return g_CullingStageInfos;
+    }
+
     inline void ReleaseShaderResources()
     {
         g_StageInfos.clear();
+        g_IndirectStageInfos.clear();
+        g_CullingStageInfos.clear();
     }
 
     void CompileDefaultShaders();
@@ -0,0 +1,52 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Snapshot;
+
+import RenderCore.Types.Camera;
+import RenderCore.Types.Object;
+import RenderCore.Types.UniformBufferObject;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API ObjectSnapshot
+    {
+        std::shared_ptr<Object> Object { nullptr };
+        ModelUniformData        UniformData {};
+        std::uint32_t           NumInstances { 0U };
+        bool                    IsRenderDirty { false };
+    };
+
+    export struct RENDERCOREMODULE_API SceneSnapshot
+    {
+        std::uint64_t               TickIndex { 0U };
+        float                       DeltaTime { 0.F };
+        double                      TickTime { 0.0 };
+        Camera                      Camera {};
+        SceneUniformData            SceneData {};
+        std::vector<ObjectSnapshot> Objects {};
+    };
+
+    constexpr std::uint8_t g_NumSnapshots = 2U;
+
+    RENDERCOREMODULE_API std::array<SceneSnapshot, g_NumSnapshots> g_Snapshots {};
+    RENDERCOREMODULE_API std::counting_semaphore<g_NumSnapshots>   g_SnapshotsFree { g_NumSnapshots };
+    RENDERCOREMODULE_API std::counting_semaphore<g_NumSnapshots>   g_SnapshotsReady { 0 };
+    RENDERCOREMODULE_API std::uint8_t                              g_SnapshotWriteIndex { 0U };
+    RENDERCOREMODULE_API std::uint8_t                              g_SnapshotReadIndex { 0U };
+    RENDERCOREMODULE_API std::uint64_t                             g_SnapshotTickCounter { 0U };
+} // namespace RenderCore
+
+export namespace RenderCore
+{
+    // Simulation side: blocks while both buffers are still owned by the render side, so simulation runs at most one tick ahead.
+    [[nodiscard]] SceneSnapshot &BeginSnapshotWrite();
+    void                         PublishSnapshot();
+
+    // Render side: returns nullptr if nothing was published within the timeout.
+    [[nodiscard]] SceneSnapshot const *AcquireSnapshot(std::chrono::milliseconds);
+    void                               ReleaseSnapshot();
+} // namespace RenderCore
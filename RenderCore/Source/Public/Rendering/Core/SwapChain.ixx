@@ -12,12 +12,12 @@ import RenderCore.Types.SurfaceProperties;
 
 namespace RenderCore
 {
-    RENDERCOREMODULE_API SurfaceProperties                         g_CachedProperties {};
-    RENDERCOREMODULE_API VkSurfaceKHR                              g_Surface { VK_NULL_HANDLE };
-    RENDERCOREMODULE_API VkSwapchainKHR                            g_SwapChain { VK_NULL_HANDLE };
-    RENDERCOREMODULE_API VkSwapchainKHR                            g_OldSwapChain { VK_NULL_HANDLE };
-    RENDERCOREMODULE_API std::array<ImageAllocation, g_ImageCount> g_SwapChainImages {};
-    RENDERCOREMODULE_API std::function<void(VkSurfaceKHR &)>       g_OnSurfaceCreation {};
+    RENDERCOREMODULE_API SurfaceProperties                   g_CachedProperties {};
+    RENDERCOREMODULE_API VkSurfaceKHR                        g_Surface { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API VkSwapchainKHR                      g_SwapChain { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API VkSwapchainKHR                      g_OldSwapChain { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API std::vector<ImageAllocation>        g_SwapChainImages {};
+    RENDERCOREMODULE_API std::function<void(VkSurfaceKHR &)> g_OnSurfaceCreation {};
 } // namespace RenderCore
 
 namespace RenderCore
@@ -37,11 +37,11 @@ namespace RenderCore
 
     export void CreateSwapChain(SurfaceProperties const &, VkSurfaceCapabilitiesKHR const &);
 
-    export bool RequestSwapChainImage(std::uint32_t &);
+    export bool RequestSwapChainImage(std::uint32_t, std::uint32_t &);
     export void PresentFrame(std::uint32_t);
     export void ReleaseSwapChainResources();
 
-    void        CreateSwapChainImageViews(std::array<ImageAllocation, g_ImageCount> &);
+    void        CreateSwapChainImageViews(std::vector<ImageAllocation> &);
     export void DestroySwapChainImages();
 
     export RENDERCOREMODULE_API [[nodiscard]] inline VkSurfaceKHR const &GetSurface()
@@ -56,15 +56,15 @@ namespace RenderCore
 
     export RENDERCOREMODULE_API [[nodiscard]] inline VkExtent2D const &GetSwapChainExtent()
     {
-        return g_SwapChainImages.at(0U).Extent;
+        return g_CachedProperties.Extent;
     }
 
     export RENDERCOREMODULE_API [[nodiscard]] inline VkFormat const &GetSwapChainImageFormat()
     {
-        return g_SwapChainImages.at(0U).Format;
+        return g_CachedProperties.Format.format;
     }
 
-    export RENDERCOREMODULE_API [[nodiscard]] inline std::array<ImageAllocation, g_ImageCount> const &GetSwapChainImages()
+    export RENDERCOREMODULE_API [[nodiscard]] inline std::vector<ImageAllocation> const &GetSwapChainImages()
     {
         return g_SwapChainImages;
     }
@@ -73,4 +73,10 @@ namespace RenderCore
     {
         return g_CachedProperties;
     }
+
+    // Headless rendering has no swapchain: cache the render properties so extent-dependent state (e.g. the camera projection) stays valid.
+    export RENDERCOREMODULE_API inline void SetCachedSurfaceProperties(SurfaceProperties const &Value)
+    {
+        g_CachedProperties = Value;
+    }
 } // namespace RenderCore
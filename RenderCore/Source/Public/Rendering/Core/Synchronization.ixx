@@ -10,42 +10,88 @@ import RenderCore.Utils.Constants;
 
 namespace RenderCore
 {
-    RENDERCOREMODULE_API std::array<VkSemaphore, g_ImageCount> g_ImageAvailableSemaphores{};
-    RENDERCOREMODULE_API std::array<VkSemaphore, g_ImageCount> g_RenderFinishedSemaphores{};
-    RENDERCOREMODULE_API std::array<VkFence, g_ImageCount> g_Fences{};
-    RENDERCOREMODULE_API std::array<bool, g_ImageCount> g_FenceInUse{};
+    RENDERCOREMODULE_API std::uint8_t                                   g_FramesInFlight { g_DefaultFramesInFlight };
+    RENDERCOREMODULE_API VkSemaphore                                    g_FrameTimelineSemaphore { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API std::uint64_t                                  g_FrameTimelineValue { 0U };
+    RENDERCOREMODULE_API std::array<std::uint64_t, g_MaxFramesInFlight> g_FrameSignalValues {};
+    RENDERCOREMODULE_API VkSemaphore                                    g_ComputeTimelineSemaphore { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API std::uint64_t                                  g_ComputeTimelineValue { 0U };
+    RENDERCOREMODULE_API VkSemaphore                                    g_TransferTimelineSemaphore { VK_NULL_HANDLE };
+    RENDERCOREMODULE_API std::uint64_t                                  g_TransferTimelineValue { 0U };
+    RENDERCOREMODULE_API std::array<VkSemaphore, g_MaxFramesInFlight>   g_ImageAvailableSemaphores {};
+    RENDERCOREMODULE_API std::vector<VkSemaphore>                       g_RenderFinishedSemaphores {};
+
+    RENDERCOREMODULE_API std::vector<std::pair<std::uint64_t, std::function<void()>>> g_RetiredResources {};
 } // namespace RenderCore
 
 export namespace RenderCore
 {
-    void ResetSemaphores();
-    void ResetFenceStatus();
-    void WaitAndResetFence(std::uint32_t);
     void CreateSynchronizationObjects();
     void ReleaseSynchronizationObjects();
+    void CreatePresentationSemaphores(std::uint32_t);
+    void DestroyPresentationSemaphores();
+
+    void                        WaitForFrame(std::uint32_t);
+    void                        WaitForAllFrames();
+    [[nodiscard]] std::uint64_t AdvanceFrameTimeline(std::uint32_t);
+
+    [[nodiscard]] inline std::uint64_t AdvanceComputeTimeline()
+    {
+        return ++g_ComputeTimelineValue;
+    }
+
+    [[nodiscard]] inline std::uint64_t AdvanceTransferTimeline()
+    {
+        return ++g_TransferTimelineValue;
+    }
+
+    RENDERCOREMODULE_API void RetireResource(std::function<void()> &&);
+    RENDERCOREMODULE_API void ReleaseRetiredResources(bool);
+
+    RENDERCOREMODULE_API [[nodiscard]] std::uint64_t GetCompletedFrameTimelineValue();
+
+    RENDERCOREMODULE_API [[nodiscard]] inline std::uint8_t GetFramesInFlight()
+    {
+        return g_FramesInFlight;
+    }
+
+    RENDERCOREMODULE_API inline void SetFramesInFlight(std::uint8_t const Value)
+    {
+        g_FramesInFlight = std::clamp(Value, static_cast<std::uint8_t>(1U), g_MaxFramesInFlight);
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetFrameTimelineSemaphore()
+    {
+        return g_FrameTimelineSemaphore;
+    }
+
+    RENDERCOREMODULE_API [[nodiscard]] inline std::uint64_t GetFrameTimelineValue()
+    {
+        return g_FrameTimelineValue;
+    }
 
-    RENDERCOREMODULE_API inline void SetFenceWaitStatus(std::uint32_t const Index, bool const Value)
+    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetComputeTimelineSemaphore()
     {
-        g_FenceInUse.at(Index) = Value;
+        return g_ComputeTimelineSemaphore;
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline bool const &GetFenceWaitStatus(std::uint32_t const Index)
+    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetTransferTimelineSemaphore()
     {
-        return g_FenceInUse.at(Index);
+        return g_TransferTimelineSemaphore;
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetImageAvailableSemaphore(std::uint32_t const Index)
+    RENDERCOREMODULE_API [[nodiscard]] inline std::uint64_t GetFrameSignalValue(std::uint32_t const FrameIndex)
     {
-        return g_ImageAvailableSemaphores.at(Index);
+        return g_FrameSignalValues.at(FrameIndex);
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetRenderFinishedSemaphore(std::uint32_t const Index)
+    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetImageAvailableSemaphore(std::uint32_t const FrameIndex)
     {
-        return g_RenderFinishedSemaphores.at(Index);
+        return g_ImageAvailableSemaphores.at(FrameIndex);
     }
 
-    RENDERCOREMODULE_API [[nodiscard]] inline VkFence const &GetFence(std::uint32_t const Index)
+    RENDERCOREMODULE_API [[nodiscard]] inline VkSemaphore const &GetRenderFinishedSemaphore(std::uint32_t const ImageIndex)
     {
-        return g_Fences.at(Index);
+        return g_RenderFinishedSemaphores.at(ImageIndex);
     }
 } // namespace RenderCore
@@ -0,0 +1,49 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Runtime.Upload;
+
+export namespace RenderCore
+{
+    // Creates the persistently mapped staging ring shared by every upload.
+    void CreateUploadResources();
+
+    // Opens a one-time command buffer on the transfer queue, or on the graphics queue when the device has no transfer-only family.
+    [[nodiscard]] VkCommandBuffer BeginUpload();
+
+    // Copies the texels into the staging ring, or into a dedicated staging buffer when the ring is full, and queues the copy into the image.
+    // The copies of an upload are recorded together on submission and leave the images in the read layout. On a dedicated transfer queue
+    // only the release half of the ownership transfer is recorded there, the acquire half goes to the first frame recorded afterwards.
+    // The extent is the one of the uploaded mip level, the barriers only touch that level.
+    void QueueImageUpload(VkCommandBuffer const &, VkImage const &, VkFormat, VkExtent2D const &, void const *, VkDeviceSize, std::uint32_t MipLevel = 0U);
+
+    // Fills the levels after SourceLevel by blitting each one from the previous, once the upload completed. The blits are recorded on the
+    // graphics queue together with the acquire barriers, level by level across every image of the completed uploads.
+    void QueueMipGeneration(VkCommandBuffer const &, VkImage const &, VkFormat, VkExtent2D const &, std::uint32_t SourceLevel, std::uint32_t MipLevels);
+
+    // Copies the data into staging memory and queues its copy into the buffer. Buffers written this way on a dedicated transfer queue have to be
+    // created with concurrent sharing between the transfer and graphics families.
+    void QueueBufferUpload(VkCommandBuffer const &, VkBuffer const &, VkDeviceSize, void const *, VkDeviceSize);
+
+    // Submits the upload without waiting for it. The callback runs on the render thread once the copies completed, before anything
+    // recorded afterwards can use the uploaded resources.
+    void SubmitUpload(VkCommandBuffer const &, std::function<void()> &&);
+
+    // Render thread, once per frame: releases the uploads the transfer timeline already reached and runs their callbacks.
+    void ProcessCompletedUploads();
+
+    // Records the acquire barriers of the completed uploads into the frame command buffer. Returns the transfer timeline value the frame
+    // submission has to wait on, zero when no upload completed since the last frame.
+    [[nodiscard]] std::uint64_t RecordUploadAcquires(VkCommandBuffer const &);
+
+    // Blocks until every submitted upload completed and its resources belong to the graphics queue. Submits to the graphics queue, so it
+    // has to run on the render thread or under the renderer mutex. The callbacks of the flushed uploads still wait for ProcessCompletedUploads.
+    void FlushUploads();
+
+    void ReleaseUploadResources();
+
+    RENDERCOREMODULE_API [[nodiscard]] bool HasPendingUploads();
+} // namespace RenderCore
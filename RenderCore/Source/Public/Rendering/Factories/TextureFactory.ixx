@@ -14,17 +14,27 @@ namespace RenderCore
     {
         std::uint32_t          ID { 0U };
         tinygltf::Image const &Image {};
+        VkSampler              Sampler { VK_NULL_HANDLE };
 
         VkCommandBuffer AllocationCmdBuffer { VK_NULL_HANDLE };
     };
 
-    export struct RENDERCOREMODULE_API TextureConstructionOutputParameters
+    // Level 0 is the source image, every level after it halves both dimensions. The tail holds the levels that fit in g_TextureMipTailSize.
+    export struct RENDERCOREMODULE_API TextureMipChain
     {
-        VkBuffer      StagingBuffer {};
-        VmaAllocation StagingAllocation {};
+        std::vector<std::vector<unsigned char>> Levels {};
+        VkExtent2D                              Extent {};
+        std::uint32_t                           TailLevel { 0U };
     };
 
-    export RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Texture> ConstructTexture(TextureConstructionInputParameters const &, TextureConstructionOutputParameters &);
+    export RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Texture> ConstructTexture(TextureConstructionInputParameters const &);
 
-    export RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Texture> ConstructTextureFromFile(strzilla::string_view const &, VkCommandBuffer&, TextureConstructionOutputParameters &);
+    // Box filters the image down to 1x1 on the CPU
+    export RENDERCOREMODULE_API [[nodiscard]] TextureMipChain GenerateMipChain(tinygltf::Image const &);
+
+    // Only uploads the tail of the chain, finer levels are streamed in later by the residency manager
+    export RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Texture> ConstructStreamedTexture(TextureConstructionInputParameters const &,
+                                                                                                TextureMipChain const &);
+
+    export RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Texture> ConstructTextureFromFile(strzilla::string_view const &, VkCommandBuffer&);
 }
\ No newline at end of file
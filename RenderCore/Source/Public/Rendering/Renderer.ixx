@@ -8,25 +8,38 @@ export module RenderCore.Renderer;
 
 import RenderCore.Utils.Constants;
 import RenderCore.Utils.EnumHelpers;
+import RenderCore.Utils.DispatchQueue;
+import RenderCore.Utils.FrameStats;
+import RenderCore.Utils.Profiler;
 import RenderCore.Types.Object;
 import RenderCore.Types.Texture;
 import RenderCore.Types.RendererStateFlags;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Query;
 import RenderCore.Runtime.SwapChain;
 
 namespace RenderCore
 {
-    RENDERCOREMODULE_API auto                              g_StateFlags { RendererStateFlags::NONE };
+    export using RendererDispatchQueue = DispatchQueue<g_DispatchQueueCapacity>;
+
+    RENDERCOREMODULE_API std::atomic<RendererStateFlags>   g_StateFlags { RendererStateFlags::NONE };
     RENDERCOREMODULE_API auto                              g_ObjectsManagementStateFlags { RendererObjectsManagementStateFlags::NONE };
     RENDERCOREMODULE_API float                             g_FrameTime { 0.F };
     RENDERCOREMODULE_API float                             g_FrameRateCap { 0.016667F };
     RENDERCOREMODULE_API bool                              g_UseVSync { true };
     RENDERCOREMODULE_API bool                              g_RenderOffscreen { false };
-    RENDERCOREMODULE_API bool                              g_UseDefaultSync { true };
-    RENDERCOREMODULE_API std::uint32_t                     g_ImageIndex { g_ImageCount };
+    RENDERCOREMODULE_API bool                              g_UseDefaultSync { false };
+    RENDERCOREMODULE_API bool                              g_Headless { false };
+    RENDERCOREMODULE_API VkExtent2D                        g_HeadlessExtent { 1280U, 720U };
+    RENDERCOREMODULE_API std::uint32_t                     g_ImageIndex { 0U };
+    RENDERCOREMODULE_API std::uint32_t                     g_FrameIndex { 0U };
     RENDERCOREMODULE_API std::mutex                        g_RendererMutex {};
-    RENDERCOREMODULE_API std::queue<std::function<void()>> g_MainThreadDispatchQueue {};
-    RENDERCOREMODULE_API std::queue<std::function<void()>> g_NextTickDispatchQueue {};
+    RENDERCOREMODULE_API std::mutex                        g_ObjectsManagementMutex {};
+    RENDERCOREMODULE_API std::jthread                      g_RenderThread {};
+    RENDERCOREMODULE_API RendererDispatchQueue             g_MainThreadDispatchQueue {};
+    RENDERCOREMODULE_API RendererDispatchQueue             g_NextTickDispatchQueue {};
 
+    // Guarded by g_ObjectsManagementMutex along with g_ObjectsManagementStateFlags: requests can come from any thread.
     RENDERCOREMODULE_API std::vector<strzilla::string> g_ModelsToLoad {};
     RENDERCOREMODULE_API std::vector<std::uint32_t>    g_ModelsToUnload {};
 
@@ -66,12 +79,53 @@ namespace RenderCore
         RENDERCOREMODULE_API [[nodiscard]] bool Initialize();
         RENDERCOREMODULE_API void               Shutdown();
 
-        RENDERCOREMODULE_API void DispatchToMainThread(std::function<void()> &&);
-        RENDERCOREMODULE_API void DispatchToNextTick(std::function<void()> &&);
-
         RENDERCOREMODULE_API void SetVSync(bool);
         RENDERCOREMODULE_API void SetRenderOffscreen(bool);
         RENDERCOREMODULE_API void SetUseDefaultSync(bool);
+        RENDERCOREMODULE_API void SetFramesInFlight(std::uint8_t);
+
+        // When enabled, DrawFrame only ticks the simulation and publishes a scene snapshot; a dedicated thread records and submits it.
+        // Object, camera and illumination state must then only be changed from the thread calling DrawFrame.
+        RENDERCOREMODULE_API void SetUseRenderThread(bool);
+
+        // Headless mode skips surface and swapchain creation and renders into the offscreen images. Must be set before Initialize.
+        RENDERCOREMODULE_API void SetHeadless(bool);
+        RENDERCOREMODULE_API void SetHeadlessExtent(VkExtent2D const &);
+
+        // Pipeline statistics are gathered per scene secondary alongside the GPU timestamps.
+        RENDERCOREMODULE_API void SetCollectPipelineStatistics(bool);
+
+        // Reuses the scene secondaries of each frame slot while the visible draws and bindings stay the same; meant for mostly static scenes.
+        RENDERCOREMODULE_API void SetCacheSceneCommands(bool);
+
+        // Draws the scene with one indirect multi-draw over the shared geometry buffer instead of per-object secondaries.
+        RENDERCOREMODULE_API void SetUseIndirectDraws(bool);
+
+        // Culls the indirect draws in a compute pass instead of on the recording thread; only applies with indirect draws enabled.
+        RENDERCOREMODULE_API void SetUseGPUCulling(bool);
+
+        // Runs the GPU culling pass on the dedicated compute queue when the device has one.
+        RENDERCOREMODULE_API void SetUseAsyncCulling(bool);
+
+        // Moves the geometry heap between host-visible memory written in place and device-only memory filled by staged copies.
+        RENDERCOREMODULE_API void SetGeometryPlacement(GeometryPlacement);
+
+        // Evicts the least recently drawn scene textures to keep device-local memory under Value bytes; zero disables it. Textures keep a
+        // CPU copy for restoring only when loaded while a budget is set.
+        RENDERCOREMODULE_API void SetResidencyBudget(VkDeviceSize);
+
+        // Scenes loaded afterwards only upload the low resolution tail of each texture's mip chain, finer levels are streamed in as the
+        // textured objects grow on screen, at most Value bytes per frame.
+        RENDERCOREMODULE_API void SetUseTextureStreaming(bool);
+        RENDERCOREMODULE_API void SetStreamingBandwidth(VkDeviceSize);
+
+        // Textures loaded afterwards get their mip chain blitted on the GPU after the upload; enabled by default.
+        RENDERCOREMODULE_API void SetGenerateTextureMipmaps(bool);
+
+        RENDERCOREMODULE_API [[nodiscard]] std::uint8_t GetFramesInFlight();
+
+        // GPU times (milliseconds) of the most recent frame whose queries were read back, which lags by the number of frames in flight.
+        RENDERCOREMODULE_API [[nodiscard]] GPUFrameTimings GetGPUFrameTimings();
 
         RENDERCOREMODULE_API [[nodiscard]] std::shared_ptr<Object> GetObjectByID(std::uint32_t);
 
@@ -80,34 +134,100 @@ namespace RenderCore
 
         RENDERCOREMODULE_API [[nodiscard]] std::vector<std::shared_ptr<Texture>> LoadImages(std::vector<strzilla::string_view> &&);
 
+        // Safe to call from any thread: the requests are queued and consumed by the thread rendering the next frame.
+        RENDERCOREMODULE_API void RequestLoadObject(strzilla::string_view);
+        RENDERCOREMODULE_API void RequestUnloadObjects(std::vector<std::uint32_t> const &);
+        RENDERCOREMODULE_API void RequestClearScene();
+
         RENDERCOREMODULE_API [[nodiscard]] inline std::mutex &GetMutex()
         {
             return g_RendererMutex;
         }
 
-        RENDERCOREMODULE_API inline void DispatchToMainThread(std::function<void()> &&Functor)
+        template <typename Functor>
+            requires std::is_invocable_v<std::decay_t<Functor> &>
+        RENDERCOREMODULE_API inline void DispatchToMainThread(Functor &&Task)
         {
-            g_MainThreadDispatchQueue.emplace(std::move(Functor));
+            g_MainThreadDispatchQueue.Push(std::forward<Functor>(Task));
         }
 
-        RENDERCOREMODULE_API inline void DispatchToNextTick(std::function<void()> &&Functor)
+        template <typename Functor>
+            requires std::is_invocable_v<std::decay_t<Functor> &>
+        RENDERCOREMODULE_API inline void DispatchToNextTick(Functor &&Task)
         {
-            g_NextTickDispatchQueue.emplace(std::move(Functor));
+            g_NextTickDispatchQueue.Push(std::forward<Functor>(Task));
         }
 
-        RENDERCOREMODULE_API [[nodiscard]] inline std::queue<std::function<void()>> &GetMainThreadDispatchQueue()
+        RENDERCOREMODULE_API [[nodiscard]] inline RendererDispatchQueue &GetMainThreadDispatchQueue()
         {
             return g_MainThreadDispatchQueue;
         }
 
+        RENDERCOREMODULE_API inline std::size_t DrainMainThreadDispatchQueue()
+        {
+            return g_MainThreadDispatchQueue.Drain();
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline DispatchQueueStats GetMainThreadDispatchStats()
+        {
+            return g_MainThreadDispatchQueue.GetStats();
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline DispatchQueueStats GetNextTickDispatchStats()
+        {
+            return g_NextTickDispatchQueue.GetStats();
+        }
+
+        // Per-stage CPU timings (milliseconds) over the last g_FrameStatsCapacity rendered frames.
+        RENDERCOREMODULE_API [[nodiscard]] inline FrameStats GetFrameStats()
+        {
+            return ComputeFrameStats();
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline std::vector<FrameRecord> GetFrameRecords()
+        {
+            return RenderCore::GetFrameRecords();
+        }
+
+        RENDERCOREMODULE_API inline void ResetFrameStats()
+        {
+            RenderCore::ResetFrameStats();
+        }
+
+        // Only records with the CHROME profiler backend; the output opens in chrome://tracing and ui.perfetto.dev.
+        RENDERCOREMODULE_API inline void StartProfilerCapture()
+        {
+            RenderCore::StartProfilerCapture();
+        }
+
+        RENDERCOREMODULE_API inline bool StopProfilerCapture(strzilla::string_view const Path)
+        {
+            return RenderCore::StopProfilerCapture(Path);
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline bool GetUseRenderThread()
+        {
+            return g_RenderThread.joinable();
+        }
+
         RENDERCOREMODULE_API [[nodiscard]] inline bool IsInitialized()
         {
             return HasAnyFlag(g_StateFlags, RendererStateFlags::INITIALIZED | RendererStateFlags::PENDING_RESOURCES_CREATION);
         }
 
+        RENDERCOREMODULE_API [[nodiscard]] inline bool IsHeadless()
+        {
+            return g_Headless;
+        }
+
+        RENDERCOREMODULE_API [[nodiscard]] inline VkExtent2D const &GetHeadlessExtent()
+        {
+            return g_HeadlessExtent;
+        }
+
         RENDERCOREMODULE_API [[nodiscard]] inline bool IsReady()
         {
-            return GetSwapChain() != VK_NULL_HANDLE;
+            return g_Headless ? HasFlag(g_StateFlags, RendererStateFlags::INITIALIZED) : GetSwapChain() != VK_NULL_HANDLE;
         }
 
         RENDERCOREMODULE_API inline void AddStateFlag(RendererStateFlags const Flag)
@@ -127,24 +247,7 @@ namespace RenderCore
 
         RENDERCOREMODULE_API [[nodiscard]] inline RendererStateFlags GetStateFlags()
         {
-            return g_StateFlags;
-        }
-
-        RENDERCOREMODULE_API inline void RequestLoadObject(strzilla::string_view const ObjectPath)
-        {
-            g_ModelsToLoad.emplace_back(ObjectPath);
-            AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_LOAD);
-        }
-
-        RENDERCOREMODULE_API inline void RequestUnloadObjects(std::vector<std::uint32_t> const &ObjectIDs)
-        {
-            g_ModelsToUnload.insert(std::end(g_ModelsToUnload), std::begin(ObjectIDs), std::end(ObjectIDs));
-            AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_UNLOAD);
-        }
-
-        RENDERCOREMODULE_API inline void RequestClearScene()
-        {
-            AddFlags(g_ObjectsManagementStateFlags, RendererObjectsManagementStateFlags::PENDING_CLEAR);
+            return g_StateFlags.load(std::memory_order_acquire);
         }
 
         RENDERCOREMODULE_API inline void RequestUpdateResources()
@@ -175,9 +278,9 @@ namespace RenderCore
             return g_UseVSync;
         }
 
-        RENDERCOREMODULE_API [[nodiscard]] inline bool const &GetRenderOffscreen()
+        RENDERCOREMODULE_API [[nodiscard]] inline bool GetRenderOffscreen()
         {
-            return g_RenderOffscreen;
+            return g_RenderOffscreen || g_Headless;
         }
 
         RENDERCOREMODULE_API [[nodiscard]] inline bool const &GetUseDefaultSync()
@@ -192,7 +295,7 @@ namespace RenderCore
 
         RENDERCOREMODULE_API [[nodiscard]] inline std::uint8_t GetFrameIndex()
         {
-            return static_cast<std::uint8_t>(g_ImageIndex);
+            return static_cast<std::uint8_t>(g_FrameIndex);
         }
     } // namespace Renderer
 }     // namespace RenderCore
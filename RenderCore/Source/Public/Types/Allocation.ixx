@@ -15,12 +15,19 @@ namespace RenderCore
         VmaAllocation Allocation { VK_NULL_HANDLE };
         VkExtent2D    Extent {};
         VkFormat      Format {};
+        std::uint32_t MipLevels { 1U };
+        std::uint32_t BaseMipLevel { 0U };
 
         [[nodiscard]] inline bool IsValid() const
         {
             return Image != VK_NULL_HANDLE && Allocation != VK_NULL_HANDLE;
         }
 
+        [[nodiscard]] inline VkExtent2D GetLevelExtent(std::uint32_t const Level) const
+        {
+            return VkExtent2D { .width = std::max(Extent.width >> Level, 1U), .height = std::max(Extent.height >> Level, 1U) };
+        }
+
         void DestroyResources(VmaAllocator const &);
     };
 
@@ -46,6 +53,7 @@ namespace RenderCore
         VkDeviceOrHostAddressConstKHR BufferDeviceAddress {};
         VkDeviceSize                  LayoutOffset { 0U };
         VkDeviceSize                  LayoutSize { 0U };
+        std::vector<VkDeviceSize>     BindingOffsets {};
         BufferAllocation              Buffer {};
 
         [[nodiscard]] inline bool IsValid() const
@@ -55,6 +63,6 @@ namespace RenderCore
 
         void DestroyResources(VmaAllocator const &, bool);
 
-        void SetDescriptorLayoutSize(VkDeviceSize const &);
+        void SetDescriptorLayoutSize(VkDeviceSize const &, std::uint32_t);
     };
 } // namespace RenderCore
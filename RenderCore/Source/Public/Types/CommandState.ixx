@@ -0,0 +1,54 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Types.CommandState;
+
+namespace RenderCore
+{
+    export constexpr std::uint32_t g_NumSceneDescriptorBuffers = 3U;
+
+    // Remembers what a single command buffer already has bound and only records the commands that change it. Geometry lives in one
+    // shared buffer, so it is bound once at offset zero and draws select their range through firstIndex and vertexOffset.
+    export class RENDERCOREMODULE_API CommandStateTracker
+    {
+        VkCommandBuffer                                           m_CommandBuffer { VK_NULL_HANDLE };
+        VkPipeline                                                m_Pipeline { VK_NULL_HANDLE };
+        VkPipelineLayout                                          m_PipelineLayout { VK_NULL_HANDLE };
+        VkBuffer                                                  m_GeometryBuffer { VK_NULL_HANDLE };
+        std::array<VkDeviceAddress, g_NumSceneDescriptorBuffers> m_DescriptorAddresses {};
+        std::array<VkDeviceSize, g_NumSceneDescriptorBuffers>    m_DescriptorOffsets {};
+        bool                                                      m_HasDescriptorBuffers { false };
+        bool                                                      m_HasDescriptorOffsets { false };
+        std::uint32_t                                             m_NumBinds { 0U };
+        std::uint32_t                                             m_NumSkippedBinds { 0U };
+
+    public:
+        explicit CommandStateTracker(VkCommandBuffer const &CommandBuffer)
+            : m_CommandBuffer(CommandBuffer)
+        {
+        }
+
+        void BindPipeline(VkPipeline const &);
+        void BindDescriptorBuffers(std::array<VkDescriptorBufferBindingInfoEXT, g_NumSceneDescriptorBuffers> const &);
+        void SetDescriptorBufferOffsets(VkPipelineLayout const &, std::array<VkDeviceSize, g_NumSceneDescriptorBuffers> const &);
+        void BindGeometryBuffer(VkBuffer const &);
+
+        [[nodiscard]] inline VkCommandBuffer const &GetCommandBuffer() const
+        {
+            return m_CommandBuffer;
+        }
+
+        [[nodiscard]] inline std::uint32_t GetNumBinds() const
+        {
+            return m_NumBinds;
+        }
+
+        [[nodiscard]] inline std::uint32_t GetNumSkippedBinds() const
+        {
+            return m_NumSkippedBinds;
+        }
+    };
+} // namespace RenderCore
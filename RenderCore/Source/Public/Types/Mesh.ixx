@@ -6,6 +6,7 @@ module;
 
 export module RenderCore.Types.Mesh;
 
+import RenderCore.Types.CommandState;
 import RenderCore.Types.Resource;
 import RenderCore.Types.Transform;
 import RenderCore.Types.Vertex;
@@ -22,8 +23,9 @@ namespace RenderCore
         std::vector<std::uint32_t> m_Indices {};
         std::uint32_t              m_NumTriangles { 0U };
 
-        VkDeviceSize m_VertexOffset { 0U };
-        VkDeviceSize m_IndexOffset { 0U };
+        VkDeviceSize         m_VertexOffset { 0U };
+        VkDeviceSize         m_IndexOffset { 0U };
+        VmaVirtualAllocation m_GeometryAllocation { VK_NULL_HANDLE };
 
         MaterialData                          m_MaterialData {};
         std::vector<std::shared_ptr<Texture>> m_Textures {};
@@ -119,6 +121,16 @@ namespace RenderCore
             m_IndexOffset = IndexOffset;
         }
 
+        [[nodiscard]] inline VmaVirtualAllocation const &GetGeometryAllocation() const
+        {
+            return m_GeometryAllocation;
+        }
+
+        inline void SetGeometryAllocation(VmaVirtualAllocation const &GeometryAllocation)
+        {
+            m_GeometryAllocation = GeometryAllocation;
+        }
+
         [[nodiscard]] inline MaterialData const &GetMaterialData() const
         {
             return m_MaterialData;
@@ -144,6 +156,6 @@ namespace RenderCore
             }
         }
 
-        void BindBuffers(VkCommandBuffer const &, std::uint32_t) const;
+        void DrawIndexed(CommandStateTracker &, std::uint32_t) const;
     };
 } // namespace RenderCore
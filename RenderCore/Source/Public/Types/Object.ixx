@@ -6,15 +6,20 @@ module;
 
 export module RenderCore.Types.Object;
 
+import RenderCore.Types.CommandState;
 import RenderCore.Types.Mesh;
 import RenderCore.Types.Resource;
 import RenderCore.Types.Transform;
+import RenderCore.Types.UniformBufferObject;
+import RenderCore.Utils.Constants;
 
 namespace RenderCore
 {
     export class RENDERCOREMODULE_API Object : public Resource
     {
         mutable bool           m_IsRenderDirty { true };
+        mutable std::uint8_t   m_DirtyFrames { 0U };
+        mutable std::uint8_t   m_DirtyTextureFrames { 0U };
         Transform              m_Transform {};
         std::vector<Transform> m_InstanceTransform {};
         std::shared_ptr<Mesh>  m_Mesh { nullptr };
@@ -152,7 +157,7 @@ namespace RenderCore
 
         [[nodiscard]] inline bool IsRenderDirty() const
         {
-            return m_IsRenderDirty;
+            return m_IsRenderDirty || m_DirtyFrames != 0U;
         }
 
         inline void MarkAsRenderDirty() const
@@ -160,6 +165,26 @@ namespace RenderCore
             m_IsRenderDirty = true;
         }
 
+        [[nodiscard]] inline bool ConsumeRenderDirty() const
+        {
+            return std::exchange(m_IsRenderDirty, false);
+        }
+
+        // Only the frame slots in use are flagged, so the masks drain back to zero once each slot was rewritten.
+        void InvalidateUniformFrames() const;
+
+        // Frames whose copy of the texture descriptors is stale, each one is rewritten once that frame slot is recorded again.
+        void InvalidateTextureFrames() const;
+
+        [[nodiscard]] inline bool ConsumeTextureFrame(std::uint32_t const FrameIndex) const
+        {
+            auto const FrameMask = static_cast<std::uint8_t>(1U << FrameIndex);
+            bool const IsDirty   = (m_DirtyTextureFrames & FrameMask) != 0U;
+
+            m_DirtyTextureFrames &= static_cast<std::uint8_t>(~FrameMask);
+            return IsDirty;
+        }
+
         void Destroy() override;
 
         virtual void Tick(double)
@@ -167,7 +192,8 @@ namespace RenderCore
         }
 
         void SetupUniformDescriptor();
-        void UpdateUniformBuffers() const;
-        void DrawObject(VkCommandBuffer const &, VkPipelineLayout const &, std::uint32_t) const;
+        [[nodiscard]] ModelUniformData GetUniformData() const;
+        void                           UpdateUniformBuffers(std::uint32_t, ModelUniformData const &, bool) const;
+        void DrawObject(CommandStateTracker &, VkPipelineLayout const &, std::uint32_t, std::uint32_t) const;
     };
 } // namespace RenderCore
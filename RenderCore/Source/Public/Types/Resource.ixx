@@ -10,11 +10,12 @@ namespace RenderCore
 {
     export class RENDERCOREMODULE_API Resource
     {
-        bool             m_IsPendingDestroy { false };
-        std::uint32_t    m_ID {};
-        strzilla::string m_Path {};
-        strzilla::string m_Name {};
-        std::uint32_t    m_BufferIndex { 0U };
+        // Set by the simulation side while the render thread reads it through the published snapshots
+        std::atomic<bool> m_IsPendingDestroy { false };
+        std::uint32_t     m_ID {};
+        strzilla::string  m_Path {};
+        strzilla::string  m_Name {};
+        std::uint32_t     m_BufferIndex { 0U };
 
     public:
         virtual ~Resource() = default;
@@ -50,12 +51,12 @@ namespace RenderCore
 
         [[nodiscard]] inline bool IsPendingDestroy() const
         {
-            return m_IsPendingDestroy;
+            return m_IsPendingDestroy.load(std::memory_order_acquire);
         }
 
         virtual inline void Destroy()
         {
-            m_IsPendingDestroy = true;
+            m_IsPendingDestroy.store(true, std::memory_order_release);
         }
     };
 } // namespace RenderCore
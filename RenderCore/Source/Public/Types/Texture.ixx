@@ -24,6 +24,7 @@ export namespace RenderCore
     class RENDERCOREMODULE_API Texture : public Resource
     {
         VkDescriptorImageInfo m_ImageDescriptor {};
+        VkSampler m_Sampler { VK_NULL_HANDLE };
         std::vector<TextureType> m_Types {};
 
     public:
@@ -41,6 +42,14 @@ export namespace RenderCore
         void SetTypes(std::vector<TextureType> const &);
         void AppendType(TextureType);
 
+        // Shared with other textures, owned by the scene's sampler cache. Null uses the default sampler.
+        [[nodiscard]] inline VkSampler GetSampler() const
+        {
+            return m_Sampler;
+        }
+
+        void SetSampler(VkSampler);
+
         void SetupTexture();
 
         [[nodiscard]] inline VkDescriptorImageInfo const &GetImageDescriptor() const
@@ -0,0 +1,59 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.Profiler;
+
+namespace RenderCore
+{
+    RENDERCOREMODULE_API std::atomic<bool> g_IsProfilerCapturing { false };
+
+    RENDERCOREMODULE_API void RecordProfilerZone(char const *, std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point);
+} // namespace RenderCore
+
+namespace RenderCore
+{
+    // Built-in backend of the RENDERCORE_PROFILE_* macros: zones are buffered per thread while a capture is running and written as a
+    // Chrome trace (chrome://tracing, ui.perfetto.dev) when it stops. With the Tracy backend or profiling disabled this is unused.
+    export class RENDERCOREMODULE_API ProfilerZone
+    {
+        char const *                          m_Name;
+        std::chrono::steady_clock::time_point m_StartTime {};
+        bool                                  m_IsRecording;
+
+    public:
+        explicit ProfilerZone(char const *Name)
+            : m_Name(Name)
+          , m_IsRecording(g_IsProfilerCapturing.load(std::memory_order_relaxed))
+        {
+            if (m_IsRecording)
+            {
+                m_StartTime = std::chrono::steady_clock::now();
+            }
+        }
+
+        ProfilerZone(ProfilerZone const &)            = delete;
+        ProfilerZone &operator=(ProfilerZone const &) = delete;
+
+        ~ProfilerZone()
+        {
+            if (m_IsRecording)
+            {
+                RecordProfilerZone(m_Name, m_StartTime, std::chrono::steady_clock::now());
+            }
+        }
+    };
+
+    export RENDERCOREMODULE_API void SetProfilerThreadName(char const *);
+    export RENDERCOREMODULE_API void MarkProfilerFrame();
+
+    export RENDERCOREMODULE_API void               StartProfilerCapture();
+    export RENDERCOREMODULE_API [[nodiscard]] bool StopProfilerCapture(strzilla::string_view);
+
+    export RENDERCOREMODULE_API [[nodiscard]] inline bool IsProfilerCapturing()
+    {
+        return g_IsProfilerCapturing.load(std::memory_order_relaxed);
+    }
+} // namespace RenderCore
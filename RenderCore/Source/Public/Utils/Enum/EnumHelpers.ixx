@@ -77,4 +77,39 @@ namespace RenderCore
     {
         return Lhs != T(0);
     }
+
+    // Atomic flag sets are updated with a compare-exchange loop so concurrent add and remove calls never drop each other's bits.
+    export template <typename T>
+        requires std::is_enum_v<T>
+    RENDERCOREMODULE_API void AddFlags(std::atomic<T> &Lhs, T const Rhs)
+    {
+        T Expected = Lhs.load(std::memory_order_relaxed);
+        while (!Lhs.compare_exchange_weak(Expected, Expected | Rhs, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    export template <typename T>
+        requires std::is_enum_v<T>
+    RENDERCOREMODULE_API void RemoveFlags(std::atomic<T> &Lhs, T const Rhs)
+    {
+        T Expected = Lhs.load(std::memory_order_relaxed);
+        while (!Lhs.compare_exchange_weak(Expected, Expected & ~Rhs, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    export template <typename T>
+        requires std::is_enum_v<T>
+    RENDERCOREMODULE_API bool HasFlag(std::atomic<T> const &Lhs, T const Rhs)
+    {
+        return HasFlag(Lhs.load(std::memory_order_acquire), Rhs);
+    }
+
+    export template <typename T>
+        requires std::is_enum_v<T>
+    RENDERCOREMODULE_API bool HasAnyFlag(std::atomic<T> const &Lhs, T const Rhs)
+    {
+        return HasAnyFlag(Lhs.load(std::memory_order_acquire), Rhs);
+    }
 } // namespace RenderCore
\ No newline at end of file
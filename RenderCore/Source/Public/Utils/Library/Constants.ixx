@@ -19,7 +19,8 @@ export namespace RenderCore
                                                     VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
                                                     VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
                                                     VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
-                                                    VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME};
+                                                    VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+                                                    VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME};
 
     constexpr std::array<char const *, 0U> g_OptionalInstanceLayers{};
 
@@ -40,6 +41,8 @@ export namespace RenderCore
 
     constexpr auto g_StagingMemoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
 
+    constexpr VkDeviceSize g_StagingRingSize = 64ULL * 1024U * 1024U;
+
     constexpr auto g_DescriptorMemoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
     constexpr auto g_ModelMemoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
@@ -47,8 +50,16 @@ export namespace RenderCore
     constexpr auto g_ModelBufferUsage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
 
+    // The geometry heap is also the source and destination of re-pack copies, and of staged uploads when it lives in device-only memory
+    constexpr auto g_GeometryBufferUsage = g_ModelBufferUsage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
     constexpr auto g_TextureMemoryUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
+    // Streamed textures upload every mip level up to this size at load, finer levels follow as they cover more of the screen
+    constexpr std::uint32_t g_TextureMipTailSize = 64U;
+
+    constexpr VkDeviceSize g_DefaultStreamingBandwidth = 4ULL * 1024U * 1024U;
+
     constexpr VkSampleCountFlagBits g_MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     constexpr VkImageTiling         g_ImageTiling = VK_IMAGE_TILING_OPTIMAL;
 
@@ -63,8 +74,50 @@ export namespace RenderCore
     // Change to VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL after fixing it
     constexpr VkImageLayout g_ReadLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
+    // Stages a frame waits on the upload timeline at. The barriers recorded for completed uploads start from them to chain after the wait.
+    constexpr VkPipelineStageFlags2 g_UploadWaitStages = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+
     constexpr std::uint8_t g_ImageCount = 3U;
 
+    constexpr std::uint8_t g_MaxFramesInFlight = 4U;
+
+    constexpr std::uint8_t g_DefaultFramesInFlight = 2U;
+
+    constexpr std::size_t g_DispatchQueueCapacity = 1024U;
+
+    constexpr std::size_t g_FrameStatsCapacity = 256U;
+
+    constexpr std::uint32_t g_MaxTimedRecordingThreads = 64U;
+
+    constexpr std::uint32_t g_MaxTimedPasses = 8U;
+
+    // Secondary recording cost model, in abstract units: a draw packet costs g_RecordingDrawCost plus one unit per
+    // g_RecordingTrianglesPerCost triangles.
+    constexpr std::uint64_t g_RecordingDrawCost = 64U;
+
+    constexpr std::uint64_t g_RecordingTrianglesPerCost = 1024U;
+
+    constexpr std::uint64_t g_MinRecordingCostPerThread = g_RecordingDrawCost * 128U;
+
+    // Batches dealt to each recording thread; the extra granularity is what idle threads steal.
+    constexpr std::uint32_t g_RecordingBatchesPerThread = 8U;
+
+    // Draw packet extraction culls at least this many objects per thread before spreading over another one.
+    constexpr std::uint32_t g_MinExtractionObjectsPerThread = 512U;
+
+    // Cached scene recording keeps one secondary per chunk of objects; each chunk maps to a timed recording slot.
+    constexpr std::uint32_t g_MaxCachedSceneChunks = g_MaxTimedRecordingThreads;
+
+    constexpr std::uint32_t g_MinCachedChunkObjects = 64U;
+
+    // Upper bound of the bindless texture array used by indirect draws (five descriptors per uniform slot), clamped to the device limits.
+    constexpr std::uint32_t g_MaxIndirectTextureDescriptors = 65535U;
+
+    constexpr std::uint32_t g_MinIndirectDrawCapacity = 256U;
+
+    // Must match local_size_x in CULLING_SHADER.comp
+    constexpr std::uint32_t g_CullingWorkGroupSize = 64U;
+
     constexpr std::uint32_t g_Timeout = std::numeric_limits<std::uint32_t>::max();
 
     constexpr std::array g_ClearValues{VkClearValue{.color = {{0.F, 0.F, 0.F, 0.F}}}, VkClearValue{.depthStencil = {1.F, 0U}}};
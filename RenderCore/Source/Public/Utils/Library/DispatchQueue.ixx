@@ -0,0 +1,346 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.DispatchQueue;
+
+namespace RenderCore
+{
+    export struct RENDERCOREMODULE_API DispatchQueueStats
+    {
+        std::uint64_t Enqueued { 0U };
+        std::uint64_t Executed { 0U };
+        std::uint64_t Overflowed { 0U };
+        std::uint32_t Depth { 0U };
+        std::uint32_t PeakDepth { 0U };
+        double        LastDrainTime { 0.0 };
+        double        PeakDrainTime { 0.0 };
+    };
+
+    // Type-erased void() callable constructed, invoked and destroyed in place: no heap allocation unless the functor exceeds the inline buffer.
+    export template <std::size_t StorageSize>
+    class InplaceTask
+    {
+        alignas(std::max_align_t) std::byte m_Storage[StorageSize] {};
+        void (*m_Invoke)(void *) { nullptr };
+        void (*m_Destroy)(void *) { nullptr };
+
+    public:
+        InplaceTask()                               = default;
+        InplaceTask(InplaceTask const &)            = delete;
+        InplaceTask &operator=(InplaceTask const &) = delete;
+
+        ~InplaceTask()
+        {
+            Reset();
+        }
+
+        template <typename Functor>
+            requires std::is_invocable_v<std::decay_t<Functor> &>
+        void Emplace(Functor &&Task)
+        {
+            using TaskType = std::decay_t<Functor>;
+
+            if constexpr (sizeof(TaskType) <= StorageSize && alignof(TaskType) <= alignof(std::max_align_t))
+            {
+                ::new(static_cast<void *>(m_Storage)) TaskType(std::forward<Functor>(Task));
+
+                m_Invoke = [](void *Storage)
+                {
+                    std::invoke(*std::launder(static_cast<TaskType *>(Storage)));
+                };
+
+                m_Destroy = [](void *Storage)
+                {
+                    std::destroy_at(std::launder(static_cast<TaskType *>(Storage)));
+                };
+            }
+            else
+            {
+                ::new(static_cast<void *>(m_Storage)) TaskType *(new TaskType(std::forward<Functor>(Task)));
+
+                m_Invoke = [](void *Storage)
+                {
+                    std::invoke(**std::launder(static_cast<TaskType **>(Storage)));
+                };
+
+                m_Destroy = [](void *Storage)
+                {
+                    delete *std::launder(static_cast<TaskType **>(Storage));
+                };
+            }
+        }
+
+        void Invoke()
+        {
+            m_Invoke(m_Storage);
+        }
+
+        void Reset()
+        {
+            if (m_Destroy)
+            {
+                m_Destroy(m_Storage);
+                m_Invoke  = nullptr;
+                m_Destroy = nullptr;
+            }
+        }
+
+        [[nodiscard]] inline bool IsValid() const
+        {
+            return m_Invoke != nullptr;
+        }
+    };
+
+    // Bounded multi-producer/single-consumer ring (sequence-per-cell). Producers never lock while the ring has room; when it is full the
+    // task goes to a bounded, mutex-guarded overflow ring so a producer running on the consumer thread can't deadlock waiting for itself.
+    // Tasks run in push order: once something spilled, later tasks queue behind it in the overflow until it is drained.
+    export template <std::size_t Capacity, std::size_t TaskSize = 64U, std::size_t OverflowCapacity = Capacity>
+        requires(Capacity >= 2U && (Capacity & (Capacity - 1U)) == 0U && OverflowCapacity > 0U)
+    class DispatchQueue
+    {
+        static constexpr std::size_t s_CacheLineSize = 64U;
+
+        struct Cell
+        {
+            std::atomic<std::size_t> Sequence { 0U };
+            InplaceTask<TaskSize>    Task {};
+        };
+
+        std::array<Cell, Capacity> m_Cells {};
+
+        alignas(s_CacheLineSize) std::atomic<std::size_t> m_EnqueuePosition { 0U };
+        alignas(s_CacheLineSize) std::atomic<std::size_t> m_DequeuePosition { 0U };
+
+        // Producers append at the tail under the mutex; the consumer runs the head task in place and only then releases its slot.
+        alignas(s_CacheLineSize) std::mutex                 m_OverflowMutex {};
+        std::array<InplaceTask<TaskSize>, OverflowCapacity> m_Overflow {};
+        std::size_t                                         m_OverflowHead { 0U };
+        std::size_t                                         m_OverflowTail { 0U };
+        std::atomic<std::size_t>                            m_OverflowSize { 0U };
+        std::atomic<std::thread::id>                        m_ConsumerThread {};
+
+        std::atomic<std::uint64_t> m_NumOverflowed { 0U };
+        std::atomic<std::uint64_t> m_NumExecuted { 0U };
+        std::atomic<std::uint32_t> m_PeakDepth { 0U };
+        std::atomic<double>        m_LastDrainTime { 0.0 };
+        std::atomic<double>        m_PeakDrainTime { 0.0 };
+
+    public:
+        DispatchQueue()
+        {
+            for (std::size_t Iterator = 0U; Iterator < Capacity; ++Iterator)
+            {
+                m_Cells.at(Iterator).Sequence.store(Iterator, std::memory_order_relaxed);
+            }
+        }
+
+        DispatchQueue(DispatchQueue const &)            = delete;
+        DispatchQueue &operator=(DispatchQueue const &) = delete;
+
+        template <typename Functor>
+            requires std::is_invocable_v<std::decay_t<Functor> &>
+        void Push(Functor &&Task)
+        {
+            // The task is only consumed once a cell is claimed, so a full ring leaves it intact for the overflow. While older tasks wait
+            // there, new ones queue behind them instead of taking a freed ring cell.
+            if (m_OverflowSize.load(std::memory_order_acquire) == 0U)
+            {
+                if (std::size_t Position = 0U;
+                    Cell *const Target = TryClaim(Position))
+                {
+                    Publish(*Target, Position, std::forward<Functor>(Task));
+                    return;
+                }
+            }
+
+            m_NumOverflowed.fetch_add(1U, std::memory_order_relaxed);
+
+            while (true)
+            {
+                {
+                    std::lock_guard const Lock { m_OverflowMutex };
+
+                    if (m_OverflowTail - m_OverflowHead < OverflowCapacity)
+                    {
+                        m_Overflow[m_OverflowTail++ % OverflowCapacity].Emplace(std::forward<Functor>(Task));
+                        m_OverflowSize.fetch_add(1U, std::memory_order_release);
+                        return;
+                    }
+                }
+
+                // Both rings are full. Other threads wait for the consumer; the consumer itself can't, so it runs the task out of order.
+                if (std::this_thread::get_id() == m_ConsumerThread.load(std::memory_order_relaxed))
+                {
+                    std::invoke(Task);
+                    m_NumExecuted.fetch_add(1U, std::memory_order_relaxed);
+                    return;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+        template <typename Functor>
+            requires std::is_invocable_v<std::decay_t<Functor> &>
+        [[nodiscard]] bool TryPush(Functor &&Task)
+        {
+            // Claiming a cell while older tasks wait in the overflow would run this one ahead of them
+            if (m_OverflowSize.load(std::memory_order_acquire) > 0U)
+            {
+                return false;
+            }
+
+            std::size_t Position = 0U;
+            Cell *const Target   = TryClaim(Position);
+
+            if (!Target)
+            {
+                return false;
+            }
+
+            Publish(*Target, Position, std::forward<Functor>(Task));
+            return true;
+        }
+
+        // Consumer side: runs every task that was visible when the drain started. Tasks pushed while draining wait for the next call.
+        std::size_t Drain()
+        {
+            auto const StartTime = std::chrono::steady_clock::now();
+            m_ConsumerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+            std::size_t       Position      = m_DequeuePosition.load(std::memory_order_relaxed);
+            std::size_t const Limit         = m_EnqueuePosition.load(std::memory_order_acquire);
+            std::size_t const OverflowLimit = m_OverflowSize.load(std::memory_order_acquire);
+            std::size_t       Executed      = 0U;
+
+            while (Position != Limit)
+            {
+                Cell &Target = m_Cells[Position & (Capacity - 1U)];
+
+                if (Target.Sequence.load(std::memory_order_acquire) != Position + 1U)
+                {
+                    break;
+                }
+
+                Target.Task.Invoke();
+                Target.Task.Reset();
+                Target.Sequence.store(Position + Capacity, std::memory_order_release);
+
+                m_DequeuePosition.store(++Position, std::memory_order_release);
+                ++Executed;
+            }
+
+            // Overflowed tasks are newer than everything in the ring, so they wait while a ring cell is still unpublished
+            if (Position == m_EnqueuePosition.load(std::memory_order_acquire))
+            {
+                for (std::size_t Iterator = 0U; Iterator < OverflowLimit; ++Iterator)
+                {
+                    // Only the consumer moves the head, and producers never write the slot until it is released below
+                    InplaceTask<TaskSize> &Task = m_Overflow[m_OverflowHead % OverflowCapacity];
+                    Task.Invoke();
+                    Task.Reset();
+
+                    std::lock_guard const Lock { m_OverflowMutex };
+                    ++m_OverflowHead;
+                    m_OverflowSize.fetch_sub(1U, std::memory_order_release);
+                }
+
+                Executed += OverflowLimit;
+            }
+
+            double const DrainTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+            m_LastDrainTime.store(DrainTime, std::memory_order_relaxed);
+
+            if (DrainTime > m_PeakDrainTime.load(std::memory_order_relaxed))
+            {
+                m_PeakDrainTime.store(DrainTime, std::memory_order_relaxed);
+            }
+
+            m_NumExecuted.fetch_add(Executed, std::memory_order_relaxed);
+            return Executed;
+        }
+
+        [[nodiscard]] inline std::uint32_t GetDepth() const
+        {
+            std::size_t const Enqueued = m_EnqueuePosition.load(std::memory_order_acquire);
+            std::size_t const Dequeued = m_DequeuePosition.load(std::memory_order_acquire);
+
+            return static_cast<std::uint32_t>(Enqueued - Dequeued + m_OverflowSize.load(std::memory_order_acquire));
+        }
+
+        [[nodiscard]] inline bool IsEmpty() const
+        {
+            return GetDepth() == 0U;
+        }
+
+        [[nodiscard]] DispatchQueueStats GetStats() const
+        {
+            std::uint64_t const Overflowed = m_NumOverflowed.load(std::memory_order_relaxed);
+
+            return DispatchQueueStats {
+                    .Enqueued = m_EnqueuePosition.load(std::memory_order_relaxed) + Overflowed,
+                    .Executed = m_NumExecuted.load(std::memory_order_relaxed),
+                    .Overflowed = Overflowed,
+                    .Depth = GetDepth(),
+                    .PeakDepth = m_PeakDepth.load(std::memory_order_relaxed),
+                    .LastDrainTime = m_LastDrainTime.load(std::memory_order_relaxed),
+                    .PeakDrainTime = m_PeakDrainTime.load(std::memory_order_relaxed)
+            };
+        }
+
+        void ResetStats()
+        {
+            m_PeakDepth.store(GetDepth(), std::memory_order_relaxed);
+            m_PeakDrainTime.store(0.0, std::memory_order_relaxed);
+        }
+
+    private:
+        [[nodiscard]] Cell *TryClaim(std::size_t &Position)
+        {
+            Position = m_EnqueuePosition.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                Cell &            Target   = m_Cells[Position & (Capacity - 1U)];
+                std::size_t const Sequence = Target.Sequence.load(std::memory_order_acquire);
+                auto const        Diff     = static_cast<std::intptr_t>(Sequence) - static_cast<std::intptr_t>(Position);
+
+                if (Diff == 0)
+                {
+                    if (m_EnqueuePosition.compare_exchange_weak(Position, Position + 1U, std::memory_order_relaxed))
+                    {
+                        return &Target;
+                    }
+                }
+                else if (Diff < 0)
+                {
+                    return nullptr;
+                }
+                else
+                {
+                    Position = m_EnqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template <typename Functor>
+        void Publish(Cell &Target, std::size_t const Position, Functor &&Task)
+        {
+            Target.Task.Emplace(std::forward<Functor>(Task));
+            Target.Sequence.store(Position + 1U, std::memory_order_release);
+
+            UpdatePeakDepth(static_cast<std::uint32_t>(Position + 1U - m_DequeuePosition.load(std::memory_order_relaxed)));
+        }
+
+        void UpdatePeakDepth(std::uint32_t const Depth)
+        {
+            std::uint32_t Peak = m_PeakDepth.load(std::memory_order_relaxed);
+            while (Depth > Peak && !m_PeakDepth.compare_exchange_weak(Peak, Depth, std::memory_order_relaxed))
+            {
+            }
+        }
+    };
+} // namespace RenderCore
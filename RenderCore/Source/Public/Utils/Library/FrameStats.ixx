@@ -0,0 +1,104 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+module;
+
+export module RenderCore.Utils.FrameStats;
+
+import RenderCore.Utils.Constants;
+
+namespace RenderCore
+{
+    export enum class FrameStage : std::uint8_t
+    {
+        DispatchDrain,
+        ResourceRefresh,
+        Tick,
+        UniformUpdate,
+        CommandRecording,
+        SecondaryRecording,
+        Submission,
+        Presentation,
+        Frame,
+        Count
+    };
+
+    export constexpr std::size_t g_NumFrameStages = static_cast<std::size_t>(FrameStage::Count);
+
+    export struct RENDERCOREMODULE_API FrameRecord
+    {
+        std::uint64_t                                  FrameNumber { 0U };
+        std::array<double, g_NumFrameStages>           StageTimes {};
+        std::array<double, g_MaxTimedRecordingThreads>        ThreadRecordingTimes {};
+        std::array<std::uint32_t, g_MaxTimedRecordingThreads> ThreadDrawCounts {};
+        std::array<std::uint32_t, g_MaxTimedRecordingThreads> ThreadSkippedBinds {};
+        std::uint32_t                                         NumRecordingThreads { 0U };
+        std::uint32_t                                         NumDraws { 0U };
+        std::uint32_t                                         NumSkippedBinds { 0U };
+    };
+
+    export struct RENDERCOREMODULE_API FrameTimeSummary
+    {
+        double Min { 0.0 };
+        double Average { 0.0 };
+        double P50 { 0.0 };
+        double P95 { 0.0 };
+        double P99 { 0.0 };
+        double Max { 0.0 };
+    };
+
+    export struct RENDERCOREMODULE_API FrameStats
+    {
+        std::uint32_t                                  NumSamples { 0U };
+        std::array<FrameTimeSummary, g_NumFrameStages> Stages {};
+        std::vector<FrameTimeSummary>                  RecordingThreads {};
+        double                                         AverageDraws { 0.0 };
+        std::uint32_t                                  MaxDraws { 0U };
+        double                                         AverageSkippedBinds { 0.0 };
+
+        [[nodiscard]] inline FrameTimeSummary const &GetStage(FrameStage const Stage) const
+        {
+            return Stages.at(static_cast<std::size_t>(Stage));
+        }
+    };
+
+    // Times are accumulated into the record of the frame being rendered and committed to a fixed ring once the frame ends, skipped or not.
+    // Writers never block readers: each ring slot is guarded by a sequence counter and readers skip slots that change under them.
+    export RENDERCOREMODULE_API void BeginFrameRecord();
+    export RENDERCOREMODULE_API void AddFrameStageTime(FrameStage, double);
+    export RENDERCOREMODULE_API void SetThreadRecordingTime(std::uint32_t, double);
+    export RENDERCOREMODULE_API void SetThreadDrawCount(std::uint32_t, std::uint32_t);
+
+    // Redundant binds the recording thread's state tracker dropped.
+    export RENDERCOREMODULE_API void SetThreadSkippedBinds(std::uint32_t, std::uint32_t);
+    export RENDERCOREMODULE_API void CommitFrameRecord();
+    export RENDERCOREMODULE_API void ResetFrameStats();
+
+    export RENDERCOREMODULE_API [[nodiscard]] std::vector<FrameRecord> GetFrameRecords();
+    export RENDERCOREMODULE_API [[nodiscard]] FrameStats               ComputeFrameStats();
+
+    // Sorts the input in place.
+    export RENDERCOREMODULE_API [[nodiscard]] FrameTimeSummary SummarizeFrameTimes(std::vector<double> &);
+
+    export class RENDERCOREMODULE_API ScopedFrameTimer
+    {
+        FrameStage                            m_Stage;
+        std::chrono::steady_clock::time_point m_StartTime;
+
+    public:
+        explicit ScopedFrameTimer(FrameStage const Stage)
+            : m_Stage(Stage)
+          , m_StartTime(std::chrono::steady_clock::now())
+        {
+        }
+
+        ScopedFrameTimer(ScopedFrameTimer const &)            = delete;
+        ScopedFrameTimer &operator=(ScopedFrameTimer const &) = delete;
+
+        ~ScopedFrameTimer()
+        {
+            AddFrameStageTime(m_Stage, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartTime).count());
+        }
+    };
+} // namespace RenderCore
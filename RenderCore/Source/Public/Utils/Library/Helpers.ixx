@@ -74,6 +74,4 @@ export namespace RenderCore
                           }
                       });
     }
-
-    RENDERCOREMODULE_API void DispatchQueue(std::queue<std::function<void()>> &);
 } // namespace RenderCore
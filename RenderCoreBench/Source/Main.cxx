@@ -0,0 +1,597 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+#include <iostream>
+#include <random>
+
+import RenderCore.Renderer;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Query;
+import RenderCore.Runtime.Residency;
+import RenderCore.Runtime.Scene;
+import RenderCore.Runtime.Upload;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.Transform;
+import RenderCore.Utils.Constants;
+import RenderCore.Utils.EnumHelpers;
+import RenderCore.Utils.FrameStats;
+
+using namespace RenderCore;
+
+constexpr double        g_FixedDeltaTime    = 1.0 / 60.0;
+constexpr std::uint32_t g_NumWaypoints      = 8U;
+constexpr std::uint32_t g_MaxReadyFrames    = 64U;
+constexpr std::uint32_t g_RecordsFetchCycle = static_cast<std::uint32_t>(g_FrameStatsCapacity / 2U);
+
+struct BenchmarkOptions
+{
+    std::vector<strzilla::string> Scenes {};
+    std::uint32_t                 WarmupFrames { 32U };
+    std::uint32_t                 NumFrames { 512U };
+    std::uint32_t                 Seed { 1U };
+    VkExtent2D                    Extent { 1280U, 720U };
+    bool                          CollectPipelineStatistics { false };
+    bool                          CacheSceneCommands { false };
+    bool                          UseIndirectDraws { false };
+    bool                          UseGPUCulling { false };
+    bool                          UseAsyncCulling { false };
+    GeometryPlacement             GeometryHeapPlacement { GeometryPlacement::STAGED };
+    VkDeviceSize                  ResidencyBudget { 0U };
+    bool                          UseTextureStreaming { false };
+    VkDeviceSize                  StreamingBandwidth { g_DefaultStreamingBandwidth };
+    bool                          GenerateTextureMipmaps { true };
+    strzilla::string              OutputPath {};
+};
+
+struct SceneResult
+{
+    strzilla::string         Path {};
+    std::uint32_t            NumObjects { 0U };
+    double                   LoadTime { 0.0 };
+    std::vector<FrameRecord> Records {};
+    std::vector<double>      GPUFrameTimes {};
+    VkDeviceSize             PeakDeviceMemory { 0U };
+    VkMemoryPropertyFlags    GeometryMemory { 0U };
+    VkMemoryPropertyFlags    UniformMemory { 0U };
+    TextureResidencyStats    Residency {};
+    std::uint32_t            NumSamplers { 0U };
+    bool                     IsValid { false };
+};
+
+struct FlythroughPath
+{
+    glm::vec3              Target { 0.F };
+    std::vector<glm::vec3> Waypoints {};
+};
+
+template <typename Type>
+bool ParseNumber(strzilla::string_view const Value, Type &Output)
+{
+    auto const [Pointer, Error] = std::from_chars(std::data(Value), std::data(Value) + std::size(Value), Output);
+    return Error == std::errc {} && Pointer == std::data(Value) + std::size(Value);
+}
+
+std::optional<BenchmarkOptions> ParseOptions(int const Argc, char const *const *const Argv)
+{
+    BenchmarkOptions Output {};
+
+    for (int Iterator = 1; Iterator < Argc; ++Iterator)
+    {
+        strzilla::string_view const Argument { Argv[Iterator] };
+
+        if (Argument == "--pipeline-statistics")
+        {
+            Output.CollectPipelineStatistics = true;
+            continue;
+        }
+
+        if (Argument == "--cache-scene-commands")
+        {
+            Output.CacheSceneCommands = true;
+            continue;
+        }
+
+        if (Argument == "--indirect-draws")
+        {
+            Output.UseIndirectDraws = true;
+            continue;
+        }
+
+        if (Argument == "--gpu-culling")
+        {
+            Output.UseGPUCulling = true;
+            continue;
+        }
+
+        if (Argument == "--no-texture-mipmaps")
+        {
+            Output.GenerateTextureMipmaps = false;
+            continue;
+        }
+
+        if (Argument == "--texture-streaming")
+        {
+            Output.UseTextureStreaming = true;
+            continue;
+        }
+
+        if (Argument == "--async-culling")
+        {
+            Output.UseGPUCulling   = true;
+            Output.UseAsyncCulling = true;
+            continue;
+        }
+
+        if (Iterator + 1 >= Argc)
+        {
+            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Missing value for argument '" << Argument << "'";
+            return std::nullopt;
+        }
+
+        strzilla::string_view const Value { Argv[++Iterator] };
+
+        bool IsValid = true;
+
+        if (Argument == "--scene")
+        {
+            Output.Scenes.emplace_back(Value);
+        }
+        else if (Argument == "--frames")
+        {
+            IsValid = ParseNumber(Value, Output.NumFrames) && Output.NumFrames > 0U;
+        }
+        else if (Argument == "--warmup")
+        {
+            IsValid = ParseNumber(Value, Output.WarmupFrames);
+        }
+        else if (Argument == "--seed")
+        {
+            IsValid = ParseNumber(Value, Output.Seed);
+        }
+        else if (Argument == "--width")
+        {
+            IsValid = ParseNumber(Value, Output.Extent.width) && Output.Extent.width > 0U;
+        }
+        else if (Argument == "--height")
+        {
+            IsValid = ParseNumber(Value, Output.Extent.height) && Output.Extent.height > 0U;
+        }
+        else if (Argument == "--geometry-placement")
+        {
+            IsValid = Value == "mapped" || Value == "staged";
+            Output.GeometryHeapPlacement = Value == "mapped" ? GeometryPlacement::MAPPED : GeometryPlacement::STAGED;
+        }
+        else if (Argument == "--residency-budget-mb")
+        {
+            IsValid = ParseNumber(Value, Output.ResidencyBudget);
+            Output.ResidencyBudget *= 1024U * 1024U;
+        }
+        else if (Argument == "--streaming-bandwidth-kb")
+        {
+            IsValid = ParseNumber(Value, Output.StreamingBandwidth) && Output.StreamingBandwidth > 0U;
+            Output.StreamingBandwidth *= 1024U;
+        }
+        else if (Argument == "--output")
+        {
+            Output.OutputPath = Value;
+        }
+        else
+        {
+            IsValid = false;
+        }
+
+        if (!IsValid)
+        {
+            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Invalid argument '" << Argument << "' with value '" << Value << "'";
+            return std::nullopt;
+        }
+    }
+
+    if (std::empty(Output.Scenes))
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: At least one --scene <path> is required";
+        return std::nullopt;
+    }
+
+    return Output;
+}
+
+void DrawBenchmarkFrame()
+{
+    Renderer::DrawFrame(g_FixedDeltaTime);
+    Renderer::DrainMainThreadDispatchQueue();
+}
+
+Bounds ComputeSceneBounds()
+{
+    Bounds Output {
+            .Min = glm::vec3 { std::numeric_limits<float>::max() },
+            .Max = glm::vec3 { std::numeric_limits<float>::lowest() }
+    };
+
+    for (auto const &ObjectIter : GetObjects())
+    {
+        if (!ObjectIter || !ObjectIter->GetMesh())
+        {
+            continue;
+        }
+
+        auto const &[Min, Max] = ObjectIter->GetMesh()->GetBounds();
+        glm::mat4 const Matrix = ObjectIter->GetMatrix();
+
+        for (std::uint32_t Corner = 0U; Corner < 8U; ++Corner)
+        {
+            glm::vec3 const Point { Corner & 1U ? Max.x : Min.x, Corner & 2U ? Max.y : Min.y, Corner & 4U ? Max.z : Min.z };
+            glm::vec3 const WorldPoint = glm::vec3 { Matrix * glm::vec4 { Point, 1.F } };
+
+            Output.Min = glm::min(Output.Min, WorldPoint);
+            Output.Max = glm::max(Output.Max, WorldPoint);
+        }
+    }
+
+    if (glm::any(glm::greaterThan(Output.Min, Output.Max)))
+    {
+        return Bounds { .Min = glm::vec3 { -1.F }, .Max = glm::vec3 { 1.F } };
+    }
+
+    return Output;
+}
+
+FlythroughPath GenerateFlythrough(Bounds const &SceneBounds, std::uint32_t const Seed)
+{
+    glm::vec3 const Center = (SceneBounds.Min + SceneBounds.Max) * 0.5F;
+    float const     Radius = std::max(glm::distance(SceneBounds.Min, SceneBounds.Max) * 0.5F, 0.01F);
+
+    // Standard distributions are implementation-defined: map the raw mt19937 sequence by hand so a seed yields the same path everywhere
+    std::mt19937 Generator { Seed };
+    auto const   NextUnit = [&Generator]
+    {
+        return static_cast<float>(Generator()) / static_cast<float>(std::mt19937::max());
+    };
+
+    FlythroughPath Output { .Target = Center };
+    Output.Waypoints.reserve(g_NumWaypoints);
+
+    for (std::uint32_t Iterator = 0U; Iterator < g_NumWaypoints; ++Iterator)
+    {
+        float const Yaw      = glm::two_pi<float>() * (static_cast<float>(Iterator) + NextUnit() * 0.5F) / static_cast<float>(g_NumWaypoints);
+        float const Pitch    = glm::radians(-30.F + 60.F * NextUnit());
+        float const Distance = Radius * (0.6F + 0.8F * NextUnit());
+
+        Output.Waypoints.push_back(Center + Distance * glm::vec3 { std::cos(Yaw) * std::cos(Pitch), std::sin(Pitch), std::sin(Yaw) * std::cos(Pitch) });
+    }
+
+    return Output;
+}
+
+void MoveCameraAlongPath(Camera &Camera, FlythroughPath const &Path, float const Progress)
+{
+    auto const  NumWaypoints = static_cast<std::uint32_t>(std::size(Path.Waypoints));
+    float const Position     = Progress * static_cast<float>(NumWaypoints);
+    auto const  Segment      = static_cast<std::uint32_t>(Position) % NumWaypoints;
+    float const Alpha        = Position - std::floor(Position);
+
+    auto const Waypoint = [&Path, NumWaypoints](std::uint32_t const Index)
+    {
+        return Path.Waypoints.at(Index % NumWaypoints);
+    };
+
+    // Uniform Catmull-Rom spline through the waypoints, closed into a loop
+    glm::vec3 const P0 = Waypoint(Segment + NumWaypoints - 1U);
+    glm::vec3 const P1 = Waypoint(Segment);
+    glm::vec3 const P2 = Waypoint(Segment + 1U);
+    glm::vec3 const P3 = Waypoint(Segment + 2U);
+
+    glm::vec3 const CameraPosition = 0.5F * (2.F * P1 + (P2 - P0) * Alpha + (2.F * P0 - 5.F * P1 + 4.F * P2 - P3) * Alpha * Alpha +
+                                             (3.F * P1 - P0 - 3.F * P2 + P3) * Alpha * Alpha * Alpha);
+
+    glm::vec3 const Direction = glm::normalize(Path.Target - CameraPosition);
+
+    Camera.SetPosition(CameraPosition);
+    Camera.SetRotation(glm::vec3 {
+            glm::degrees(std::atan2(Direction.z, Direction.x)),
+            glm::degrees(std::asin(std::clamp(Direction.y, -1.F, 1.F))),
+            0.F
+    });
+}
+
+void FetchFrameRecords(std::vector<FrameRecord> &Records)
+{
+    std::uint64_t const LastFrame = std::empty(Records) ? 0U : Records.back().FrameNumber + 1U;
+
+    for (FrameRecord const &RecordIter : GetFrameRecords())
+    {
+        if (RecordIter.FrameNumber >= LastFrame)
+        {
+            Records.push_back(RecordIter);
+        }
+    }
+}
+
+SceneResult RunScene(strzilla::string_view const ScenePath, BenchmarkOptions const &Options)
+{
+    SceneResult Output { .Path = strzilla::string { ScenePath } };
+
+    if (!std::empty(GetObjects()))
+    {
+        Renderer::RequestClearScene();
+        DrawBenchmarkFrame();
+    }
+
+    auto const LoadStartTime = std::chrono::steady_clock::now();
+    Renderer::RequestLoadObject(ScenePath);
+
+    // Texture uploads run on the transfer queue; the scene is only complete once they landed
+    do
+    {
+        DrawBenchmarkFrame();
+    }
+    while (HasPendingUploads());
+    Output.LoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - LoadStartTime).count();
+
+    Output.NumObjects     = static_cast<std::uint32_t>(std::size(GetObjects()));
+    Output.GeometryMemory = GetGeometryMemoryProperties();
+    Output.UniformMemory  = GetUniformMemoryProperties();
+    Output.NumSamplers    = GetNumSamplers();
+    if (Output.NumObjects == 0U)
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Scene '" << ScenePath << "' has no drawable objects";
+        return Output;
+    }
+
+    Camera &             Camera = GetCamera();
+    FlythroughPath const Path   = GenerateFlythrough(ComputeSceneBounds(), Options.Seed);
+    Camera.SetDrawDistance(std::numeric_limits<float>::max());
+
+    for (std::uint32_t Frame = 0U; Frame < Options.WarmupFrames; ++Frame)
+    {
+        MoveCameraAlongPath(Camera, Path, 0.F);
+        DrawBenchmarkFrame();
+    }
+
+    Renderer::ResetFrameStats();
+    Output.Records.reserve(Options.NumFrames);
+
+    TextureResidencyStats const ResidencyAtStart = GetTextureResidencyStats();
+    Output.GPUFrameTimes.reserve(Options.NumFrames);
+
+    std::uint64_t LastGPUFrame = std::numeric_limits<std::uint64_t>::max();
+
+    for (std::uint32_t Frame = 0U; Frame < Options.NumFrames; ++Frame)
+    {
+        MoveCameraAlongPath(Camera, Path, static_cast<float>(Frame) / static_cast<float>(Options.NumFrames));
+        DrawBenchmarkFrame();
+
+        Output.PeakDeviceMemory = std::max(Output.PeakDeviceMemory, GetDeviceMemoryUsage().UsageBytes);
+
+        if (GPUFrameTimings const Timings = Renderer::GetGPUFrameTimings();
+            Timings.FrameNumber != LastGPUFrame && Timings.FrameTime > 0.0)
+        {
+            LastGPUFrame = Timings.FrameNumber;
+            Output.GPUFrameTimes.push_back(Timings.FrameTime);
+        }
+
+        if ((Frame + 1U) % g_RecordsFetchCycle == 0U)
+        {
+            FetchFrameRecords(Output.Records);
+        }
+    }
+
+    FetchFrameRecords(Output.Records);
+    Output.IsValid = !std::empty(Output.Records);
+
+    Output.Residency = GetTextureResidencyStats();
+    Output.Residency.NumEvictions -= ResidencyAtStart.NumEvictions;
+    Output.Residency.NumRestores -= ResidencyAtStart.NumRestores;
+    Output.Residency.NumStreamedLevels -= ResidencyAtStart.NumStreamedLevels;
+    Output.Residency.StreamedBytes -= ResidencyAtStart.StreamedBytes;
+
+    return Output;
+}
+
+void WriteSummary(std::ostream &Stream, FrameTimeSummary const &Summary)
+{
+    Stream << std::format(R"({{"min":{:.4f},"avg":{:.4f},"p50":{:.4f},"p95":{:.4f},"p99":{:.4f},"max":{:.4f}}})",
+                          Summary.Min,
+                          Summary.Average,
+                          Summary.P50,
+                          Summary.P95,
+                          Summary.P99,
+                          Summary.Max);
+}
+
+void WriteEscaped(std::ostream &Stream, strzilla::string_view const Value)
+{
+    for (char const Character : Value)
+    {
+        if (Character == '"' || Character == '\\')
+        {
+            Stream << '\\';
+        }
+
+        Stream << Character;
+    }
+}
+
+void WriteReport(std::ostream &Stream, BenchmarkOptions const &Options, std::vector<SceneResult> const &Results)
+{
+    Stream << "{\n";
+    Stream << std::format(R"(  "config":{{"frames":{},"warmup":{},"seed":{},"width":{},"height":{},"delta_time":{:.6f},"cache_scene_commands":{},"indirect_draws":{},)"
+                          R"("gpu_culling":{},"async_culling":{},"geometry_placement":"{}","residency_budget_bytes":{},"texture_streaming":{},)"
+                          R"("streaming_bandwidth_bytes":{},"texture_mipmaps":{}}},)",
+                          Options.NumFrames,
+                          Options.WarmupFrames,
+                          Options.Seed,
+                          Options.Extent.width,
+                          Options.Extent.height,
+                          g_FixedDeltaTime,
+                          Options.CacheSceneCommands,
+                          Options.UseIndirectDraws,
+                          Options.UseGPUCulling,
+                          Options.UseAsyncCulling,
+                          Options.GeometryHeapPlacement == GeometryPlacement::MAPPED ? "mapped" : "staged",
+                          Options.ResidencyBudget,
+                          Options.UseTextureStreaming,
+                          Options.StreamingBandwidth,
+                          Options.GenerateTextureMipmaps) << "\n";
+    Stream << R"(  "scenes":[)";
+
+    for (std::size_t ResultIndex = 0U; ResultIndex < std::size(Results); ++ResultIndex)
+    {
+        SceneResult const &Result = Results.at(ResultIndex);
+
+        Stream << (ResultIndex == 0U ? "\n" : ",\n") << R"(    {"path":")";
+        WriteEscaped(Stream, Result.Path);
+        Stream << std::format(R"(","valid":{},"objects":{},"samplers":{},"load_ms":{:.4f},"peak_vram_bytes":{},"samples":{},)",
+                              Result.IsValid,
+                              Result.NumObjects,
+                              Result.NumSamplers,
+                              Result.LoadTime,
+                              Result.PeakDeviceMemory,
+                              std::size(Result.Records));
+
+        Stream << std::format(R"("memory":{{"geometry_device_local":{},"geometry_host_visible":{},"uniform_device_local":{},"uniform_host_visible":{}}},)",
+                              HasFlag<VkMemoryPropertyFlags>(Result.GeometryMemory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+                              HasFlag<VkMemoryPropertyFlags>(Result.GeometryMemory, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT),
+                              HasFlag<VkMemoryPropertyFlags>(Result.UniformMemory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+                              HasFlag<VkMemoryPropertyFlags>(Result.UniformMemory, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
+
+        Stream << std::format(R"("texture_residency":{{"resident_bytes":{},"resident":{},"evicted":{},"evictions":{},"restores":{},)"
+                              R"("partially_streamed":{},"streamed_levels":{},"streamed_bytes":{}}},)",
+                              Result.Residency.ResidentBytes,
+                              Result.Residency.NumResident,
+                              Result.Residency.NumEvicted,
+                              Result.Residency.NumEvictions,
+                              Result.Residency.NumRestores,
+                              Result.Residency.NumPartiallyStreamed,
+                              Result.Residency.NumStreamedLevels,
+                              Result.Residency.StreamedBytes);
+
+        std::vector<double> Times;
+        Times.reserve(std::size(Result.Records));
+
+        Stream << R"("cpu_ms":{)";
+        constexpr std::array<std::pair<FrameStage, char const *>, 5U> ReportedStages {
+                std::pair { FrameStage::Frame, "frame" },
+                std::pair { FrameStage::UniformUpdate, "uniform_update" },
+                std::pair { FrameStage::CommandRecording, "command_recording" },
+                std::pair { FrameStage::SecondaryRecording, "secondary_recording" },
+                std::pair { FrameStage::Submission, "submission" }
+        };
+
+        for (std::size_t StageIndex = 0U; StageIndex < std::size(ReportedStages); ++StageIndex)
+        {
+            auto const &[Stage, Name] = ReportedStages.at(StageIndex);
+
+            Times.clear();
+            for (FrameRecord const &RecordIter : Result.Records)
+            {
+                Times.push_back(RecordIter.StageTimes.at(static_cast<std::size_t>(Stage)));
+            }
+
+            Stream << (StageIndex == 0U ? "" : ",") << "\"" << Name << "\":";
+            WriteSummary(Stream, SummarizeFrameTimes(Times));
+        }
+
+        Stream << R"(},"gpu_ms":)";
+        std::vector<double> GPUFrameTimes = Result.GPUFrameTimes;
+        WriteSummary(Stream, SummarizeFrameTimes(GPUFrameTimes));
+
+        Times.clear();
+        for (FrameRecord const &RecordIter : Result.Records)
+        {
+            Times.push_back(static_cast<double>(RecordIter.NumDraws));
+        }
+
+        Stream << R"(,"draws":)";
+        WriteSummary(Stream, SummarizeFrameTimes(Times));
+
+        Times.clear();
+        for (FrameRecord const &RecordIter : Result.Records)
+        {
+            Times.push_back(static_cast<double>(RecordIter.NumSkippedBinds));
+        }
+
+        Stream << R"(,"skipped_binds":)";
+        WriteSummary(Stream, SummarizeFrameTimes(Times));
+        Stream << "}";
+    }
+
+    Stream << "\n  ]\n}\n";
+}
+
+int main(int const Argc, char const *const *const Argv)
+{
+    std::optional<BenchmarkOptions> const Options = ParseOptions(Argc, Argv);
+    if (!Options)
+    {
+        BOOST_LOG_TRIVIAL(info) << "Usage: RenderCoreBench --scene <path> [--scene <path> ...] [--frames N] [--warmup N] [--seed N] "
+                                   "[--width N] [--height N] [--output <file>] [--pipeline-statistics] [--cache-scene-commands] "
+                                   "[--indirect-draws] [--gpu-culling] [--async-culling] [--geometry-placement mapped|staged] "
+                                   "[--residency-budget-mb N] [--texture-streaming] [--streaming-bandwidth-kb N] "
+                                   "[--no-texture-mipmaps]";
+        return EXIT_FAILURE;
+    }
+
+    Renderer::SetHeadless(true);
+    Renderer::SetHeadlessExtent(Options->Extent);
+    Renderer::SetCollectPipelineStatistics(Options->CollectPipelineStatistics);
+    Renderer::SetCacheSceneCommands(Options->CacheSceneCommands);
+    Renderer::SetUseIndirectDraws(Options->UseIndirectDraws);
+    Renderer::SetUseGPUCulling(Options->UseGPUCulling);
+    Renderer::SetUseAsyncCulling(Options->UseAsyncCulling);
+    Renderer::SetGeometryPlacement(Options->GeometryHeapPlacement);
+    Renderer::SetResidencyBudget(Options->ResidencyBudget);
+    Renderer::SetUseTextureStreaming(Options->UseTextureStreaming);
+    Renderer::SetStreamingBandwidth(Options->StreamingBandwidth);
+    Renderer::SetGenerateTextureMipmaps(Options->GenerateTextureMipmaps);
+
+    if (!Renderer::Initialize())
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to initialize the renderer";
+        return EXIT_FAILURE;
+    }
+
+    for (std::uint32_t Frame = 0U; Frame < g_MaxReadyFrames && !Renderer::IsReady(); ++Frame)
+    {
+        DrawBenchmarkFrame();
+    }
+
+    if (!Renderer::IsReady())
+    {
+        BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Renderer did not become ready";
+        Renderer::Shutdown();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<SceneResult> Results;
+    Results.reserve(std::size(Options->Scenes));
+
+    for (strzilla::string const &ScenePath : Options->Scenes)
+    {
+        Results.push_back(RunScene(ScenePath, *Options));
+    }
+
+    Renderer::Shutdown();
+
+    if (std::empty(Options->OutputPath))
+    {
+        WriteReport(std::cout, *Options, Results);
+    }
+    else
+    {
+        std::ofstream Stream { std::filesystem::path { std::data(Options->OutputPath) }, std::ios::out | std::ios::trunc };
+        if (!Stream.is_open())
+        {
+            BOOST_LOG_TRIVIAL(error) << "[" << __func__ << "]: Failed to open output file: " << Options->OutputPath;
+            return EXIT_FAILURE;
+        }
+
+        WriteReport(Stream, *Options, Results);
+    }
+
+    return std::ranges::all_of(Results, &SceneResult::IsValid) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
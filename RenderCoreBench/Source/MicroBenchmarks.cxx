@@ -0,0 +1,414 @@
+// Author: Lucas Vilas-Boas
+// Year : 2024
+// Repo : https://github.com/lucoiso/vulkan-renderer
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+import RenderCore.Runtime.DrawPacket;
+import RenderCore.Runtime.Memory;
+import RenderCore.Runtime.Model;
+import RenderCore.Runtime.Snapshot;
+import RenderCore.Runtime.SwapChain;
+import RenderCore.Types.Camera;
+import RenderCore.Types.Mesh;
+import RenderCore.Types.Object;
+import RenderCore.Types.SurfaceProperties;
+import RenderCore.Types.Transform;
+import RenderCore.Types.Vertex;
+
+using namespace RenderCore;
+
+constexpr std::int64_t  g_MinCount       = 1LL << 10;
+constexpr std::int64_t  g_MaxCount       = 1LL << 20;
+constexpr std::uint32_t g_NumSceneMeshes = 1024U;
+constexpr std::uint32_t g_Seed           = 1U;
+
+// Standard distributions are implementation-defined: map the raw mt19937 sequence by hand so inputs match across standard libraries
+class SyntheticRandom
+{
+    std::mt19937 m_Generator { g_Seed };
+
+public:
+    [[nodiscard]] float Next(float const Min, float const Max)
+    {
+        return Min + (Max - Min) * static_cast<float>(m_Generator()) / static_cast<float>(std::mt19937::max());
+    }
+
+    [[nodiscard]] glm::vec3 NextVec3(float const Min, float const Max)
+    {
+        return glm::vec3 { Next(Min, Max), Next(Min, Max), Next(Min, Max) };
+    }
+};
+
+// Grid of quads with each corner emitted per triangle, so the vertex remap has duplicates to weld like a non-indexed glTF primitive
+std::shared_ptr<Mesh> CreateGridMesh(std::uint32_t const NumVertices)
+{
+    auto const NumQuads = std::max(NumVertices / 6U, 1U);
+    auto const GridSize = static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<double>(NumQuads))));
+
+    std::vector<Vertex>        Vertices;
+    std::vector<std::uint32_t> Indices;
+    Vertices.reserve(NumQuads * 6U);
+    Indices.reserve(NumQuads * 6U);
+
+    for (std::uint32_t Quad = 0U; Quad < NumQuads; ++Quad)
+    {
+        auto const X = static_cast<float>(Quad % GridSize);
+        auto const Z = static_cast<float>(Quad / GridSize);
+
+        for (glm::vec2 const &Corner : { glm::vec2 { 0.F, 0.F }, glm::vec2 { 1.F, 0.F }, glm::vec2 { 1.F, 1.F },
+                                         glm::vec2 { 0.F, 0.F }, glm::vec2 { 1.F, 1.F }, glm::vec2 { 0.F, 1.F } })
+        {
+            Indices.push_back(static_cast<std::uint32_t>(std::size(Vertices)));
+            Vertices.push_back(Vertex {
+                    .Position = glm::vec3 { X + Corner.x, 0.F, Z + Corner.y },
+                    .Normal = glm::vec3 { 0.F, 1.F, 0.F },
+                    .TextureCoordinate = Corner,
+                    .Color = glm::vec4 { 1.F }
+            });
+        }
+    }
+
+    auto NewMesh = std::make_shared<Mesh>(0U, "Synthetic", "Grid");
+    NewMesh->SetVertices(Vertices);
+    NewMesh->SetIndices(Indices);
+
+    return NewMesh;
+}
+
+std::vector<std::shared_ptr<Object>> CreateSceneObjects(std::uint32_t const NumObjects)
+{
+    SyntheticRandom Random {};
+
+    std::vector<std::shared_ptr<Mesh>> Meshes;
+    Meshes.reserve(g_NumSceneMeshes);
+
+    for (std::uint32_t Iterator = 0U; Iterator < g_NumSceneMeshes; ++Iterator)
+    {
+        Transform MeshTransform {};
+        MeshTransform.SetPosition(Random.NextVec3(-200.F, 200.F));
+
+        auto NewMesh = std::make_shared<Mesh>(Iterator, "Synthetic", "Triangle");
+        NewMesh->SetTransform(MeshTransform);
+        NewMesh->SetVertices({
+                Vertex { .Position = glm::vec3 { -1.F, -1.F, -1.F } },
+                Vertex { .Position = glm::vec3 { 1.F, -1.F, -1.F } },
+                Vertex { .Position = glm::vec3 { 1.F, 1.F, 1.F } },
+        });
+        NewMesh->SetIndices({ 0U, 1U, 2U });
+        NewMesh->SetupBounds();
+
+        Meshes.push_back(std::move(NewMesh));
+    }
+
+    std::vector<std::shared_ptr<Object>> Objects;
+    Objects.reserve(NumObjects);
+
+    for (std::uint32_t Iterator = 0U; Iterator < NumObjects; ++Iterator)
+    {
+        auto NewObject = std::make_shared<Object>(Iterator, "Synthetic", "Object");
+        NewObject->SetMesh(Meshes.at(Iterator % g_NumSceneMeshes));
+        Objects.push_back(std::move(NewObject));
+    }
+
+    return Objects;
+}
+
+Camera CreateSceneCamera()
+{
+    SetCachedSurfaceProperties(SurfaceProperties { .Extent = VkExtent2D { 1920U, 1080U } });
+
+    Camera Output {};
+    Output.SetPosition(glm::vec3 { 0.F, 0.F, 250.F });
+    Output.SetFarPlane(1000.F);
+
+    return Output;
+}
+
+struct SyntheticPrimitive
+{
+    tinygltf::Model     Model {};
+    tinygltf::Primitive Primitive {};
+};
+
+template <typename DataType>
+std::int32_t AddAccessor(tinygltf::Model &             Model,
+                         std::vector<DataType> const &Data,
+                         std::int32_t const           Type,
+                         std::int32_t const           ComponentType,
+                         std::size_t const            Count)
+{
+    tinygltf::Buffer &Buffer     = Model.buffers.front();
+    std::size_t const ByteOffset = std::size(Buffer.data);
+    std::size_t const ByteLength = std::size(Data) * sizeof(DataType);
+
+    Buffer.data.resize(ByteOffset + ByteLength);
+    std::memcpy(std::data(Buffer.data) + ByteOffset, std::data(Data), ByteLength);
+
+    tinygltf::BufferView BufferView {};
+    BufferView.buffer     = 0;
+    BufferView.byteOffset = ByteOffset;
+    BufferView.byteLength = ByteLength;
+    Model.bufferViews.push_back(BufferView);
+
+    tinygltf::Accessor Accessor {};
+    Accessor.bufferView    = static_cast<std::int32_t>(std::size(Model.bufferViews)) - 1;
+    Accessor.type          = Type;
+    Accessor.componentType = ComponentType;
+    Accessor.count         = Count;
+    Model.accessors.push_back(Accessor);
+
+    return static_cast<std::int32_t>(std::size(Model.accessors)) - 1;
+}
+
+template <typename IndexType>
+SyntheticPrimitive CreateSyntheticPrimitive(std::uint32_t const NumVertices)
+{
+    SyntheticRandom    Random {};
+    SyntheticPrimitive Output {};
+    Output.Model.buffers.emplace_back();
+
+    std::vector<float>     Positions(NumVertices * 3U);
+    std::vector<float>     Normals(NumVertices * 3U);
+    std::vector<float>     TexCoords(NumVertices * 2U);
+    std::vector<IndexType> Indices(NumVertices);
+
+    std::ranges::generate(Positions, [&Random] { return Random.Next(-1.F, 1.F); });
+    std::ranges::generate(Normals, [&Random] { return Random.Next(-1.F, 1.F); });
+    std::ranges::generate(TexCoords, [&Random] { return Random.Next(0.F, 1.F); });
+
+    for (std::uint32_t Iterator = 0U; Iterator < NumVertices; ++Iterator)
+    {
+        Indices.at(Iterator) = static_cast<IndexType>(Iterator % (static_cast<std::uint32_t>(std::numeric_limits<IndexType>::max()) + 1U));
+    }
+
+    Output.Primitive.attributes["POSITION"]   = AddAccessor(Output.Model, Positions, TINYGLTF_TYPE_VEC3, TINYGLTF_COMPONENT_TYPE_FLOAT, NumVertices);
+    Output.Primitive.attributes["NORMAL"]     = AddAccessor(Output.Model, Normals, TINYGLTF_TYPE_VEC3, TINYGLTF_COMPONENT_TYPE_FLOAT, NumVertices);
+    Output.Primitive.attributes["TEXCOORD_0"] = AddAccessor(Output.Model, TexCoords, TINYGLTF_TYPE_VEC2, TINYGLTF_COMPONENT_TYPE_FLOAT, NumVertices);
+
+    constexpr std::int32_t IndexComponentType = sizeof(IndexType) == 4U
+                                                    ? TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT
+                                                    : TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT;
+    Output.Primitive.indices = AddAccessor(Output.Model, Indices, TINYGLTF_TYPE_SCALAR, IndexComponentType, NumVertices);
+
+    return Output;
+}
+
+void BM_TransformGetMatrix(benchmark::State &State)
+{
+    SyntheticRandom        Random {};
+    std::vector<Transform> Transforms(static_cast<std::size_t>(State.range(0)));
+
+    for (Transform &TransformIter : Transforms)
+    {
+        TransformIter.SetPosition(Random.NextVec3(-100.F, 100.F));
+        TransformIter.SetRotation(Random.NextVec3(0.F, 360.F));
+        TransformIter.SetScale(Random.NextVec3(0.5F, 2.F));
+    }
+
+    for (auto _ : State)
+    {
+        for (Transform const &TransformIter : Transforms)
+        {
+            glm::mat4 Matrix = TransformIter.GetMatrix();
+            benchmark::DoNotOptimize(Matrix);
+        }
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_CameraIsInsideCameraFrustum(benchmark::State &State)
+{
+    Camera const SceneCamera = CreateSceneCamera();
+    auto const   Objects     = CreateSceneObjects(static_cast<std::uint32_t>(State.range(0)));
+
+    for (auto _ : State)
+    {
+        std::uint32_t NumVisible = 0U;
+        for (auto const &ObjectIter : Objects)
+        {
+            NumVisible += SceneCamera.IsInsideCameraFrustum(ObjectIter) ? 1U : 0U;
+        }
+
+        benchmark::DoNotOptimize(NumVisible);
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_CameraCanDrawObject(benchmark::State &State)
+{
+    Camera const SceneCamera = CreateSceneCamera();
+    auto const   Objects     = CreateSceneObjects(static_cast<std::uint32_t>(State.range(0)));
+
+    for (auto _ : State)
+    {
+        std::uint32_t NumVisible = 0U;
+        for (auto const &ObjectIter : Objects)
+        {
+            NumVisible += SceneCamera.CanDrawObject(ObjectIter) ? 1U : 0U;
+        }
+
+        benchmark::DoNotOptimize(NumVisible);
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_BuildDrawPackets(benchmark::State &State)
+{
+    Camera const SceneCamera = CreateSceneCamera();
+    auto const   NumObjects  = static_cast<std::uint32_t>(State.range(0));
+
+    std::vector<ObjectSnapshot> Snapshots;
+    Snapshots.reserve(NumObjects);
+
+    for (auto &ObjectIter : CreateSceneObjects(NumObjects))
+    {
+        Snapshots.push_back(ObjectSnapshot { .Object = std::move(ObjectIter) });
+    }
+
+    std::vector<DrawPacket> Packets;
+    Packets.reserve(NumObjects);
+
+    for (auto _ : State)
+    {
+        Packets.clear();
+        BuildDrawPackets(Snapshots, SceneCamera, 0U, NumObjects, Packets);
+        benchmark::DoNotOptimize(std::data(Packets));
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_SortDrawPackets(benchmark::State &State)
+{
+    SyntheticRandom Random {};
+
+    std::vector<DrawPacket> Source(static_cast<std::size_t>(State.range(0)));
+    for (DrawPacket &PacketIter : Source)
+    {
+        auto const StateKey = static_cast<std::uint32_t>(Random.Next(0.F, 4.F)) << 6U;
+        auto const Depth    = static_cast<std::uint32_t>(Random.Next(0.F, static_cast<float>(g_DrawPacketDepthMask)));
+        PacketIter.SortKey  = StateKey << g_DrawPacketDepthBits | Depth;
+    }
+
+    std::vector<DrawPacket> Packets;
+    std::vector<DrawPacket> Scratch;
+
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        Packets = Source;
+        State.ResumeTiming();
+
+        SortDrawPackets(Packets, Scratch);
+        benchmark::ClobberMemory();
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_MeshOptimize(benchmark::State &State)
+{
+    std::shared_ptr<Mesh> const Source = CreateGridMesh(static_cast<std::uint32_t>(State.range(0)));
+    Mesh                        Target { 0U, "Synthetic", "Grid" };
+
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        Target.SetVertices(Source->GetVertices());
+        Target.SetIndices(Source->GetIndices());
+        State.ResumeTiming();
+
+        Target.Optimize();
+        benchmark::ClobberMemory();
+    }
+
+    State.SetItemsProcessed(State.iterations() * static_cast<std::int64_t>(Source->GetNumVertices()));
+}
+
+void BM_MeshSetupBounds(benchmark::State &State)
+{
+    std::shared_ptr<Mesh> const Source = CreateGridMesh(static_cast<std::uint32_t>(State.range(0)));
+
+    for (auto _ : State)
+    {
+        Source->SetupBounds();
+        benchmark::DoNotOptimize(Source->GetBounds());
+    }
+
+    State.SetItemsProcessed(State.iterations() * static_cast<std::int64_t>(Source->GetNumVertices()));
+}
+
+void BM_SetVertexAttributes(benchmark::State &State)
+{
+    SyntheticPrimitive const Primitive = CreateSyntheticPrimitive<std::uint32_t>(static_cast<std::uint32_t>(State.range(0)));
+    auto const               Target    = std::make_shared<Mesh>(0U, "Synthetic", "Primitive");
+
+    for (auto _ : State)
+    {
+        SetVertexAttributes(Target, Primitive.Model, Primitive.Primitive);
+        benchmark::ClobberMemory();
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+template <typename IndexType>
+void BM_AllocatePrimitiveIndices(benchmark::State &State)
+{
+    SyntheticPrimitive const Primitive = CreateSyntheticPrimitive<IndexType>(static_cast<std::uint32_t>(State.range(0)));
+    auto const               Target    = std::make_shared<Mesh>(0U, "Synthetic", "Primitive");
+
+    for (auto _ : State)
+    {
+        AllocatePrimitiveIndices(Target, Primitive.Model, Primitive.Primitive);
+        benchmark::ClobberMemory();
+    }
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_WriteObjectGeometry(benchmark::State &State)
+{
+    auto const Objects = CreateSceneObjects(static_cast<std::uint32_t>(State.range(0)));
+
+    VkDeviceSize TotalSize = 0U;
+    for (auto const &ObjectIter : Objects)
+    {
+        TotalSize += GetObjectGeometrySize(ObjectIter);
+    }
+
+    std::vector<std::byte> Destination(TotalSize);
+
+    for (auto _ : State)
+    {
+        VkDeviceSize Offset = 0U;
+        for (auto const &ObjectIter : Objects)
+        {
+            Offset = WriteObjectGeometry(ObjectIter, std::data(Destination), Offset);
+        }
+
+        benchmark::DoNotOptimize(Offset);
+        benchmark::ClobberMemory();
+    }
+
+    State.SetBytesProcessed(State.iterations() * static_cast<std::int64_t>(TotalSize));
+}
+
+BENCHMARK(BM_TransformGetMatrix)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_CameraIsInsideCameraFrustum)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_CameraCanDrawObject)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_BuildDrawPackets)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_SortDrawPackets)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_MeshOptimize)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MeshSetupBounds)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_SetVertexAttributes)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_AllocatePrimitiveIndices<std::uint16_t>)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_AllocatePrimitiveIndices<std::uint32_t>)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+BENCHMARK(BM_WriteObjectGeometry)->RangeMultiplier(8)->Range(g_MinCount, g_MaxCount);
+
+BENCHMARK_MAIN();
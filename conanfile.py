@@ -29,6 +29,9 @@ class VulkanRendererRecipe(ConanFile):
     def build_requirements(self):
         self.tool_requires("cmake/[>=3.28]")
 
+        # https://conan.io/center/recipes/benchmark
+        self.test_requires("benchmark/1.9.0")
+
     def layout(self):
         cmake_layout(self)
 